@@ -0,0 +1,508 @@
+/* -*- coding: utf-8 -*-
+ *
+ * Copyright 2023 IBM RESEARCH. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#include <qasm/AST/AST.h>
+#include <qasm/AST/ASTInstrumentation.h>
+#include <qasm/AST/ASTLiteralPool.h>
+#include <qasm/AST/ASTMPMemoryPool.h>
+#include <qasm/AST/ASTObjectTracker.h>
+#include <qasm/Frontend/QasmDiagnosticEmitter.h>
+#include <qasm/Frontend/QasmParser.h>
+#include <qasm/QPP/QasmPP.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <getopt.h>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+// Allocation counters. Every allocation made through the global operator
+// new of this program, including those made by the QASM libraries, is
+// counted here.
+static std::atomic<uint64_t> Allocs(0);
+static std::atomic<uint64_t> AllocBytes(0);
+
+void *operator new(std::size_t S) {
+  Allocs.fetch_add(1, std::memory_order_relaxed);
+  AllocBytes.fetch_add(S, std::memory_order_relaxed);
+
+  if (void *P = std::malloc(S ? S : 1))
+    return P;
+
+  throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t S) { return operator new(S); }
+
+void operator delete(void *P) noexcept { std::free(P); }
+
+void operator delete[](void *P) noexcept { std::free(P); }
+
+void operator delete(void *P, std::size_t) noexcept { std::free(P); }
+
+void operator delete[](void *P, std::size_t) noexcept { std::free(P); }
+
+static struct option long_options[] = {
+    {"help", no_argument, 0, 'h'},
+    {"iterations", required_argument, 0, 'n'},
+    {"warmup", required_argument, 0, 'w'},
+    {"output", required_argument, 0, 'o'},
+    {"baseline", required_argument, 0, 'b'},
+    {"threshold", required_argument, 0, 't'},
+    {"mp-pool", no_argument, 0, 'M'},
+    {"literal-pool", no_argument, 0, 'L'},
+    {0, 0, 0, 0}};
+
+static void PrintHelp() {
+  std::cout << "Usage: QasmBench [-h |--help]";
+  std::cout << " [-n |--iterations <N>]";
+  std::cout << " [-w |--warmup <N>]";
+  std::cout << "\n                 [-o |--output <json-file>]";
+  std::cout << " [-b |--baseline <json-file>]";
+  std::cout << " [-t |--threshold <percent>]";
+  std::cout << "\n                 [--mp-pool] [--literal-pool]";
+  std::cout << " [-I<include-dir> [ -I<include-dir> ...]]";
+  std::cout << "\n                 <translation-unit> [<translation-unit> ...]"
+            << std::endl;
+}
+
+static unsigned Iterations = 5;
+static unsigned Warmup = 1;
+static double Threshold = 5.0;
+static std::string Output;
+static std::string Baseline;
+static std::vector<std::string> Corpus;
+
+static bool ParseUnsigned(const char *S, unsigned &R) {
+  char *E = nullptr;
+  unsigned long V = std::strtoul(S, &E, 10);
+  if (!*S || *E || V > 1000000UL)
+    return false;
+
+  R = static_cast<unsigned>(V);
+  return true;
+}
+
+static unsigned ParseCommandLineArguments(int argc, char *const argv[]) {
+  int C = 0;
+  int option_index = 0;
+
+  if (argc == 1) {
+    PrintHelp();
+    return 1;
+  }
+
+  while (1) {
+    C = getopt_long(argc, argv, "hn:w:o:b:t:I:", long_options, &option_index);
+    if (C == -1)
+      break;
+
+    switch (C) {
+    case 'h':
+      PrintHelp();
+      return 2;
+      break;
+    case 'n':
+      if (!ParseUnsigned(optarg, Iterations) || Iterations == 0) {
+        std::cerr << "Command-Line Error: Invalid iteration count."
+                  << std::endl;
+        return 1;
+      }
+      break;
+    case 'w':
+      if (!ParseUnsigned(optarg, Warmup)) {
+        std::cerr << "Command-Line Error: Invalid warmup count." << std::endl;
+        return 1;
+      }
+      break;
+    case 'o':
+      Output = optarg;
+      break;
+    case 'b':
+      Baseline = optarg;
+      break;
+    case 't': {
+      char *E = nullptr;
+      Threshold = std::strtod(optarg, &E);
+      if (!*optarg || *E || Threshold < 0.0) {
+        std::cerr << "Command-Line Error: Invalid threshold." << std::endl;
+        return 1;
+      }
+    } break;
+    case 'I':
+      QASM::QasmPreprocessor::Instance().AddIncludePath(optarg);
+      break;
+    case 'M':
+      QASM::ASTMPMemoryPool::Instance().Enable();
+      break;
+    case 'L':
+      QASM::ASTLiteralPool::Instance().Enable();
+      break;
+    case '?':
+      std::cerr << "Command-Line Error: Invalid argument." << std::endl;
+      return 1;
+      break;
+    default:
+      return 1;
+      break;
+    }
+  }
+
+  while (optind < argc)
+    Corpus.push_back(argv[optind++]);
+
+  if (Corpus.empty()) {
+    std::cerr << "Command-Line Error: No translation unit specified."
+              << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
+
+// The results of the timed iterations over one translation unit.
+struct BenchResult {
+  std::string Name;
+  std::string Path;
+  uint64_t Bytes = 0;
+  uint64_t Lines = 0;
+  uint64_t Tokens = 0;
+  uint64_t Nodes = 0;
+  uint64_t Allocs = 0;
+  uint64_t AllocBytes = 0;
+  uint64_t PeakRSS = 0;
+  std::vector<double> Parse;
+  std::vector<double> Release;
+  double Phases[QASM::ASTInstrumentation::NumPhases] = {};
+  bool OK = false;
+};
+
+static double Median(std::vector<double> V) {
+  if (V.empty())
+    return 0.0;
+
+  std::sort(V.begin(), V.end());
+  std::size_t N = V.size();
+  return N % 2 ? V[N / 2] : (V[N / 2 - 1] + V[N / 2]) / 2.0;
+}
+
+static double Min(const std::vector<double> &V) {
+  return V.empty() ? 0.0 : *std::min_element(V.begin(), V.end());
+}
+
+static double Rate(uint64_t C, double MS) {
+  return MS > 0.0 ? static_cast<double>(C) * 1000.0 / MS : 0.0;
+}
+
+// Returns the peak resident set size of the process, in KiB.
+static uint64_t PeakRSS() {
+#if defined(__linux__) || defined(__APPLE__)
+  struct rusage RU;
+  if (getrusage(RUSAGE_SELF, &RU) != 0)
+    return 0;
+#if defined(__APPLE__)
+  return static_cast<uint64_t>(RU.ru_maxrss) / 1024;
+#else
+  return static_cast<uint64_t>(RU.ru_maxrss);
+#endif
+#else
+  return 0;
+#endif
+}
+
+static bool Measure(const std::string &Path, BenchResult &R) {
+  using Clock = std::chrono::steady_clock;
+  using MS = std::chrono::duration<double, std::milli>;
+
+  std::ifstream IFS(Path, std::ios::in | std::ios::binary);
+  if (!IFS.good()) {
+    std::cerr << "Error: Could not open " << Path << "." << std::endl;
+    return false;
+  }
+
+  std::string::size_type S = Path.find_last_of('/');
+  R.Name = S == std::string::npos ? Path : Path.substr(S + 1);
+  R.Path = Path;
+
+  char Buffer[65536];
+  while (IFS.read(Buffer, sizeof(Buffer)) || IFS.gcount() > 0) {
+    std::streamsize N = IFS.gcount();
+    R.Bytes += static_cast<uint64_t>(N);
+    R.Lines += static_cast<uint64_t>(std::count(Buffer, Buffer + N, '\n'));
+  }
+
+  IFS.close();
+
+  for (unsigned I = 0; I < Warmup + Iterations; ++I) {
+    unsigned E = QASM::QasmDiagnosticEmitter::Instance().GetNumErrors();
+    uint64_t A = Allocs.load(std::memory_order_relaxed);
+    uint64_t B = AllocBytes.load(std::memory_order_relaxed);
+
+    QASM::QasmPreprocessor::Instance().SetTranslationUnit(Path);
+
+    Clock::time_point T0 = Clock::now();
+    QASM::ASTParser Parser;
+    QASM::ASTRoot *Root = Parser.ParseAST();
+    Clock::time_point T1 = Clock::now();
+
+    // The tokens and the tracked nodes are released below.
+    uint64_t Tokens = QASM::ASTTokenFactory::GetCurrentIndex() - 1U;
+    uint64_t Nodes = QASM::ASTObjectTracker::Instance().Size();
+
+    QASM::ASTObjectTracker::Instance().Release();
+    Clock::time_point T2 = Clock::now();
+
+    delete Root;
+
+    if (!Root || QASM::QasmDiagnosticEmitter::Instance().GetNumErrors() > E) {
+      std::cerr << "Error: " << Path << " failed to parse." << std::endl;
+      return false;
+    }
+
+    // State left over from the previous iteration shows up as a
+    // different number of tokens or nodes.
+    if (I > 0 && (Tokens != R.Tokens || Nodes != R.Nodes)) {
+      std::cerr << "Error: " << Path << " parsed differently on iteration "
+                << I << "." << std::endl;
+      return false;
+    }
+
+    R.Tokens = Tokens;
+    R.Nodes = Nodes;
+
+    if (I < Warmup)
+      continue;
+
+    R.Parse.push_back(MS(T1 - T0).count());
+    R.Release.push_back(MS(T2 - T1).count());
+    R.Allocs += Allocs.load(std::memory_order_relaxed) - A;
+    R.AllocBytes += AllocBytes.load(std::memory_order_relaxed) - B;
+
+    for (unsigned P = 0; P < QASM::ASTInstrumentation::NumPhases; ++P)
+      R.Phases[P] += QASM::ASTInstrumentation::Instance().GetMilliseconds(
+          static_cast<QASM::ASTInstrumentation::Phase>(P));
+  }
+
+  R.Allocs /= Iterations;
+  R.AllocBytes /= Iterations;
+
+  for (unsigned P = 0; P < QASM::ASTInstrumentation::NumPhases; ++P)
+    R.Phases[P] /= Iterations;
+
+  R.PeakRSS = PeakRSS();
+  R.OK = true;
+  return true;
+}
+
+static std::string Escape(const std::string &S) {
+  std::string R;
+  for (char C : S) {
+    if (C == '"' || C == '\\')
+      R += '\\';
+    R += C;
+  }
+
+  return R;
+}
+
+// Every translation unit is written on a line of its own, so that a
+// baseline can be read back line by line.
+static void WriteJSON(std::ostream &OS, const std::vector<BenchResult> &V) {
+  OS << "{\n  \"version\": 1,\n"
+     << "  \"iterations\": " << Iterations << ",\n"
+     << "  \"warmup\": " << Warmup << ",\n"
+     << "  \"files\": [\n";
+
+  OS << std::fixed << std::setprecision(3);
+  for (std::vector<BenchResult>::const_iterator I = V.begin(); I != V.end();
+       ++I) {
+    const BenchResult &R = *I;
+    double PM = Median(R.Parse);
+
+    OS << "    {\"name\": \"" << Escape(R.Name) << "\", "
+       << "\"path\": \"" << Escape(R.Path) << "\", "
+       << "\"status\": \"" << (R.OK ? "ok" : "error") << "\", "
+       << "\"bytes\": " << R.Bytes << ", "
+       << "\"lines\": " << R.Lines << ", "
+       << "\"tokens\": " << R.Tokens << ", "
+       << "\"nodes\": " << R.Nodes << ", "
+       << "\"parse_ms_min\": " << Min(R.Parse) << ", "
+       << "\"parse_ms_median\": " << PM << ", "
+       << "\"release_ms_median\": " << Median(R.Release) << ", "
+       << "\"lines_per_sec\": " << Rate(R.Lines, PM) << ", "
+       << "\"tokens_per_sec\": " << Rate(R.Tokens, PM) << ", "
+       << "\"nodes_per_sec\": " << Rate(R.Nodes, PM) << ", "
+       << "\"allocs\": " << R.Allocs << ", "
+       << "\"alloc_bytes\": " << R.AllocBytes << ", "
+       << "\"peak_rss_kb\": " << R.PeakRSS;
+
+    // The mean time of every instrumented phase, if the library was built
+    // with OPENQASM_INSTRUMENTATION.
+    if (QASM::ASTInstrumentation::IsEnabled()) {
+      OS << ", \"phases_ms\": {";
+      for (unsigned P = 0; P < QASM::ASTInstrumentation::NumPhases; ++P)
+        OS << (P ? ", " : "") << "\""
+           << QASM::ASTInstrumentation::PhaseName(
+                  static_cast<QASM::ASTInstrumentation::Phase>(P))
+           << "\": " << R.Phases[P];
+      OS << "}";
+    }
+
+    OS << "}" << (I + 1 == V.end() ? "\n" : ",\n");
+  }
+
+  OS << "  ]\n}" << std::endl;
+}
+
+static bool FindNumber(const std::string &L, const char *Key, double &V) {
+  std::string K = std::string("\"") + Key + "\": ";
+  std::string::size_type P = L.find(K);
+  if (P == std::string::npos)
+    return false;
+
+  V = std::strtod(L.c_str() + P + K.size(), nullptr);
+  return true;
+}
+
+static bool FindString(const std::string &L, const char *Key,
+                       std::string &V) {
+  std::string K = std::string("\"") + Key + "\": \"";
+  std::string::size_type P = L.find(K);
+  if (P == std::string::npos)
+    return false;
+
+  P += K.size();
+  std::string::size_type E = L.find('"', P);
+  if (E == std::string::npos)
+    return false;
+
+  V = L.substr(P, E - P);
+  return true;
+}
+
+// Compares the median parse times against a JSON file written by a
+// previous run. Returns false if any translation unit got slower by more
+// than the threshold.
+static bool Compare(const std::vector<BenchResult> &V) {
+  std::ifstream IFS(Baseline);
+  if (!IFS.good()) {
+    std::cerr << "Error: Could not open baseline " << Baseline << "."
+              << std::endl;
+    return false;
+  }
+
+  std::map<std::string, double> BM;
+  std::string Line;
+  std::string Name;
+  double MS;
+
+  while (std::getline(IFS, Line))
+    if (FindString(Line, "name", Name) &&
+        FindNumber(Line, "parse_ms_median", MS))
+      BM[Name] = MS;
+
+  bool R = true;
+  std::cout << std::fixed << std::setprecision(2);
+  for (const BenchResult &BR : V) {
+    std::map<std::string, double>::const_iterator I = BM.find(BR.Name);
+    if (!BR.OK || I == BM.end() || (*I).second <= 0.0)
+      continue;
+
+    double D = (Median(BR.Parse) - (*I).second) * 100.0 / (*I).second;
+    bool Regressed = D > Threshold;
+    std::cout << std::setw(32) << std::left << BR.Name << std::right
+              << std::setw(12) << (*I).second << " ms -> " << std::setw(12)
+              << Median(BR.Parse) << " ms " << std::showpos << std::setw(8)
+              << D << std::noshowpos << "%"
+              << (Regressed ? "  REGRESSION" : "") << std::endl;
+    R = R && !Regressed;
+  }
+
+  return R;
+}
+
+int main(int argc, char *argv[]) {
+  unsigned R;
+
+  if ((R = ParseCommandLineArguments(argc, argv)) != 0) {
+    switch (R) {
+    case 2:
+      return 0;
+      break;
+    default:
+      return 1;
+      break;
+    }
+  }
+
+  // The ASTObjectTracker must be enabled: every iteration releases the
+  // AST it parsed before the next one starts.
+  QASM::ASTObjectTracker::Instance().Enable();
+
+  std::vector<BenchResult> Results;
+  bool OK = true;
+
+  for (const std::string &Path : Corpus) {
+    BenchResult BR;
+    if (!Measure(Path, BR))
+      OK = false;
+
+    Results.push_back(BR);
+
+    if (!BR.OK)
+      continue;
+
+    double PM = Median(BR.Parse);
+    std::cout << std::fixed << std::setprecision(2) << std::setw(32)
+              << std::left << BR.Name << std::right << std::setw(10) << PM
+              << " ms" << std::setw(12) << std::setprecision(0)
+              << Rate(BR.Lines, PM) << " lines/s" << std::setw(12)
+              << Rate(BR.Tokens, PM) << " tokens/s" << std::setw(12)
+              << Rate(BR.Nodes, PM) << " nodes/s" << std::setw(10)
+              << BR.PeakRSS / 1024 << " MiB" << std::endl;
+  }
+
+  if (!Output.empty()) {
+    std::ofstream OFS(Output, std::ios::out | std::ios::trunc);
+    if (!OFS.good()) {
+      std::cerr << "Error: Could not write " << Output << "." << std::endl;
+      return 1;
+    }
+
+    WriteJSON(OFS, Results);
+  }
+
+  if (!Baseline.empty() && !Compare(Results))
+    return 2;
+
+  return OK ? 0 : 1;
+}
@@ -0,0 +1,424 @@
+/* -*- coding: utf-8 -*-
+ *
+ * Copyright 2023 IBM RESEARCH. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+// Generates synthetic OpenQASM programs of a given shape, to measure how
+// the parser scales with each dimension of its input. The output is a
+// pure function of the command-line arguments.
+
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <getopt.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+static struct option long_options[] = {
+    {"help", no_argument, 0, 'h'},
+    {"qasm-version", required_argument, 0, 'V'},
+    {"qubits", required_argument, 0, 'q'},
+    {"gates", required_argument, 0, 'g'},
+    {"depth", required_argument, 0, 'd'},
+    {"gate-defs", required_argument, 0, 'G'},
+    {"defcals", required_argument, 0, 'D'},
+    {"array-size", required_argument, 0, 'a'},
+    {"expr-depth", required_argument, 0, 'e'},
+    {"nesting", required_argument, 0, 'n'},
+    {"seed", required_argument, 0, 's'},
+    {"output", required_argument, 0, 'o'},
+    {0, 0, 0, 0}};
+
+static void PrintHelp() {
+  std::cout << "Usage: QasmGen [-h |--help]";
+  std::cout << " [-V |--qasm-version <2|3>]";
+  std::cout << " [-q |--qubits <N>]";
+  std::cout << "\n               [-g |--gates <N>]";
+  std::cout << " [-d |--depth <N>]";
+  std::cout << " [-G |--gate-defs <N>]";
+  std::cout << " [-D |--defcals <N>]";
+  std::cout << "\n               [-a |--array-size <N>]";
+  std::cout << " [-e |--expr-depth <N>]";
+  std::cout << " [-n |--nesting <N>]";
+  std::cout << " [-s |--seed <N>]";
+  std::cout << "\n               [-o |--output <file>]" << std::endl;
+  std::cout << std::endl;
+  std::cout << "  --qasm-version  OpenQASM version of the program (3)."
+            << std::endl;
+  std::cout << "  --qubits        Width of the qubit register (16)."
+            << std::endl;
+  std::cout << "  --gates         Number of gate applications (1000)."
+            << std::endl;
+  std::cout << "  --depth         Number of layers of one gate per qubit. "
+            << "Overrides --gates." << std::endl;
+  std::cout << "  --gate-defs     Number of gate definitions (0)."
+            << std::endl;
+  std::cout << "  --defcals       Number of defcals, one per physical "
+            << "qubit (0)." << std::endl;
+  std::cout << "  --array-size    Size of the int and angle arrays (0)."
+            << std::endl;
+  std::cout << "  --expr-depth    Number of operands of each gate "
+            << "parameter (1)." << std::endl;
+  std::cout << "  --nesting       Depth of the for and if blocks around every "
+            << "16 gates (0)." << std::endl;
+  std::cout << std::endl;
+  std::cout << "Defcals, arrays and for loops only exist in OpenQASM 3."
+            << std::endl;
+}
+
+// The shape of the generated program.
+struct GenOptions {
+  unsigned Version = 3;
+  uint64_t Qubits = 16;
+  uint64_t Gates = 1000;
+  uint64_t Depth = 0;
+  uint64_t GateDefs = 0;
+  uint64_t Defcals = 0;
+  uint64_t ArraySize = 0;
+  uint64_t ExprDepth = 1;
+  uint64_t Nesting = 0;
+  uint64_t Seed = 1;
+  std::string Output;
+};
+
+static GenOptions GO;
+
+// Statements per innermost block when --nesting is given.
+static const uint64_t BlockSize = 16;
+
+static bool ParseCount(const char *S, uint64_t &R) {
+  char *E = nullptr;
+  unsigned long long V = std::strtoull(S, &E, 10);
+  if (!*S || *E)
+    return false;
+
+  R = static_cast<uint64_t>(V);
+  return true;
+}
+
+static unsigned ParseCommandLineArguments(int argc, char *const argv[]) {
+  int C = 0;
+  int option_index = 0;
+  uint64_t V = 0;
+
+  while (1) {
+    C = getopt_long(argc, argv, "hV:q:g:d:G:D:a:e:n:s:o:", long_options,
+                    &option_index);
+    if (C == -1)
+      break;
+
+    if (C == 'h') {
+      PrintHelp();
+      return 2;
+    }
+
+    if (C == 'o') {
+      GO.Output = optarg;
+      continue;
+    }
+
+    if (C == '?') {
+      std::cerr << "Command-Line Error: Invalid argument." << std::endl;
+      return 1;
+    }
+
+    if (!ParseCount(optarg, V)) {
+      std::cerr << "Command-Line Error: Invalid value '" << optarg
+                << "'." << std::endl;
+      return 1;
+    }
+
+    switch (C) {
+    case 'V':
+      if (V != 2 && V != 3) {
+        std::cerr << "Command-Line Error: Unsupported OpenQASM version."
+                  << std::endl;
+        return 1;
+      }
+      GO.Version = static_cast<unsigned>(V);
+      break;
+    case 'q':
+      GO.Qubits = V;
+      break;
+    case 'g':
+      GO.Gates = V;
+      break;
+    case 'd':
+      GO.Depth = V;
+      break;
+    case 'G':
+      GO.GateDefs = V;
+      break;
+    case 'D':
+      GO.Defcals = V;
+      break;
+    case 'a':
+      GO.ArraySize = V;
+      break;
+    case 'e':
+      GO.ExprDepth = V;
+      break;
+    case 'n':
+      GO.Nesting = V;
+      break;
+    case 's':
+      GO.Seed = V;
+      break;
+    default:
+      return 1;
+      break;
+    }
+  }
+
+  if (optind < argc) {
+    std::cerr << "Command-Line Error: Unexpected argument '" << argv[optind]
+              << "'." << std::endl;
+    return 1;
+  }
+
+  if (GO.Qubits < 2 || GO.ExprDepth < 1) {
+    std::cerr << "Command-Line Error: At least two qubits and one operand "
+              << "per expression are required." << std::endl;
+    return 1;
+  }
+
+  if (GO.Depth)
+    GO.Gates = GO.Depth * GO.Qubits;
+
+  if (GO.Version == 2 && (GO.Defcals || GO.ArraySize)) {
+    std::cerr << "Warning: Defcals and arrays are ignored in OpenQASM 2."
+              << std::endl;
+    GO.Defcals = GO.ArraySize = 0;
+  }
+
+  return 0;
+}
+
+// A xorshift64 generator. The same seed always yields the same program.
+class QasmGenRandom {
+private:
+  uint64_t S;
+
+public:
+  explicit QasmGenRandom(uint64_t Seed) : S(Seed ? Seed : 1) {}
+
+  uint64_t Next() {
+    S ^= S << 13;
+    S ^= S >> 7;
+    S ^= S << 17;
+    return S;
+  }
+
+  uint64_t Next(uint64_t N) { return N ? Next() % N : 0; }
+};
+
+class QasmGenerator {
+private:
+  std::ostream &OS;
+  QasmGenRandom RNG;
+  std::string Indent;
+
+private:
+  void Qubit(uint64_t I) { OS << "q[" << I % GO.Qubits << "]"; }
+
+  // A left-deep chain of ExprDepth operands.
+  void Expression(uint64_t K) {
+    static const char *const Ops[] = {" + ", " * ", " - ", " / "};
+    static const char *const Opnds3[] = {"x", "0.5", "y", "2.0"};
+    static const char *const Opnds2[] = {"pi", "0.5", "0.25", "2.0"};
+    const char *const *Opnds = GO.Version == 3 ? Opnds3 : Opnds2;
+
+    OS << (GO.Version == 3 ? "x" : "pi");
+    for (uint64_t I = 1; I < GO.ExprDepth; ++I)
+      OS << Ops[(K + I) % 4] << Opnds[(K + I) % 4];
+  }
+
+  void Gate(uint64_t K) {
+    uint64_t Q = K % GO.Qubits;
+    uint64_t Kinds = 3 + (GO.GateDefs ? 1 : 0) + (GO.Defcals ? 1 : 0);
+
+    OS << Indent;
+
+    switch (RNG.Next(Kinds)) {
+    case 0:
+      OS << "h ";
+      Qubit(Q);
+      break;
+    case 1:
+      OS << "cx ";
+      Qubit(Q);
+      OS << ", ";
+      Qubit(Q + 1);
+      break;
+    case 2:
+      OS << (GO.Version == 3 ? "rz(" : "u1(");
+      Expression(K);
+      OS << ") ";
+      Qubit(Q);
+      break;
+    case 3:
+      if (GO.GateDefs) {
+        OS << "g" << RNG.Next(GO.GateDefs) << "(";
+        Expression(K);
+        OS << ") ";
+        Qubit(Q);
+        OS << ", ";
+        Qubit(Q + 1 + RNG.Next(GO.Qubits - 1));
+        break;
+      }
+      [[fallthrough]];
+    default:
+      OS << "dcal(";
+      Expression(K);
+      OS << ") $" << RNG.Next(GO.Defcals);
+      break;
+    }
+
+    OS << ";\n";
+  }
+
+  void Open(uint64_t L) {
+    if (GO.Version == 3 && L % 2 == 0)
+      OS << Indent << "for uint i" << L << " in [0 : 1] {\n";
+    else if (GO.Version == 3)
+      OS << Indent << "if (c[" << L % GO.Qubits << "] == 1) {\n";
+
+    Indent += "  ";
+  }
+
+  void Close() {
+    Indent.resize(Indent.size() - 2);
+    OS << Indent << "}\n";
+  }
+
+  void Header() {
+    if (GO.Version == 2) {
+      OS << "OPENQASM 2.0;\n";
+      OS << "include \"qelib1.inc\";\n\n";
+      OS << "qreg q[" << GO.Qubits << "];\n";
+      OS << "creg c[" << GO.Qubits << "];\n\n";
+    } else {
+      OS << "OPENQASM 3.0;\n";
+      OS << "include \"stdgates.inc\";\n\n";
+
+      if (GO.Defcals)
+        OS << "defcalgrammar \"openpulse\";\n\n";
+
+      OS << "qubit[" << GO.Qubits << "] q;\n";
+      OS << "bit[" << GO.Qubits << "] c;\n";
+      OS << "float[64] x = 0.25;\n";
+      OS << "float[64] y = 1.5;\n";
+
+      if (GO.ArraySize) {
+        OS << "array[int[32], " << GO.ArraySize << "] ia;\n";
+        OS << "array[angle[32], " << GO.ArraySize << "] aa;\n";
+      }
+
+      OS << "\n";
+
+      for (uint64_t I = 0; I < GO.Defcals; ++I)
+        OS << "qubit $" << I << ";\n";
+
+      for (uint64_t I = 0; I < GO.Defcals; ++I)
+        OS << "defcal dcal(theta) $" << I << " { }\n";
+
+      if (GO.Defcals)
+        OS << "\n";
+    }
+
+    for (uint64_t I = 0; I < GO.GateDefs; ++I) {
+      OS << "gate g" << I << "(theta) a, b {\n";
+      OS << "  rz(theta) a;\n";
+      OS << "  cx a, b;\n";
+      OS << "  rz(theta / 2) b;\n";
+      OS << "}\n";
+    }
+
+    if (GO.GateDefs)
+      OS << "\n";
+  }
+
+  void Body() {
+    if (GO.Version == 2 && GO.Nesting) {
+      // OpenQASM 2 only has a single-statement if.
+      for (uint64_t K = 0; K < GO.Gates; ++K) {
+        if (K % BlockSize == 0)
+          OS << "if (c == " << (K / BlockSize) % 2 << ") ";
+        Gate(K);
+      }
+
+      return;
+    }
+
+    for (uint64_t K = 0; K < GO.Gates; K += BlockSize) {
+      uint64_t E = K + BlockSize < GO.Gates ? K + BlockSize : GO.Gates;
+
+      for (uint64_t L = 0; L < GO.Nesting; ++L)
+        Open(L);
+
+      for (uint64_t I = K; I < E; ++I)
+        Gate(I);
+
+      for (uint64_t L = 0; L < GO.Nesting; ++L)
+        Close();
+    }
+  }
+
+  void Footer() {
+    if (GO.Version == 2)
+      OS << "\nmeasure q -> c;\n";
+    else
+      OS << "\nc = measure q;\n";
+  }
+
+public:
+  QasmGenerator(std::ostream &O) : OS(O), RNG(GO.Seed), Indent() {}
+
+  void Generate() {
+    Header();
+    Body();
+    Footer();
+  }
+};
+
+int main(int argc, char *argv[]) {
+  unsigned R;
+
+  if ((R = ParseCommandLineArguments(argc, argv)) != 0) {
+    switch (R) {
+    case 2:
+      return 0;
+      break;
+    default:
+      return 1;
+      break;
+    }
+  }
+
+  std::ofstream OFS;
+  if (!GO.Output.empty()) {
+    OFS.open(GO.Output, std::ios::out | std::ios::trunc);
+    if (!OFS.good()) {
+      std::cerr << "Error: Could not write " << GO.Output << "." << std::endl;
+      return 1;
+    }
+  }
+
+  QasmGenerator QG(GO.Output.empty() ? std::cout : OFS);
+  QG.Generate();
+  return 0;
+}
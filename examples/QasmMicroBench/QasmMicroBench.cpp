@@ -0,0 +1,914 @@
+/* -*- coding: utf-8 -*-
+ *
+ * Copyright 2023 IBM RESEARCH. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#include <qasm/AST/AST.h>
+#include <qasm/AST/ASTBuilder.h>
+#include <qasm/AST/ASTCBit.h>
+#include <qasm/AST/ASTCastExpr.h>
+#include <qasm/AST/ASTConstantFolder.h>
+#include <qasm/AST/ASTMangler.h>
+#include <qasm/AST/ASTParseBudget.h>
+#include <qasm/AST/ASTSymbolTable.h>
+#include <qasm/Frontend/QasmDiagnosticEmitter.h>
+#include <qasm/Frontend/QasmReparser.h>
+#include <qasm/Frontend/QasmParser.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <getopt.h>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+static struct option long_options[] = {
+    {"help", no_argument, 0, 'h'},
+    {"iterations", required_argument, 0, 'n'},
+    {"warmup", required_argument, 0, 'w'},
+    {"size", required_argument, 0, 's'},
+    {"filter", required_argument, 0, 'f'},
+    {"output", required_argument, 0, 'o'},
+    {"baseline", required_argument, 0, 'b'},
+    {"threshold", required_argument, 0, 't'},
+    {0, 0, 0, 0}};
+
+static void PrintHelp() {
+  std::cout << "Usage: QasmMicroBench [-h |--help]";
+  std::cout << " [-n |--iterations <N>]";
+  std::cout << " [-w |--warmup <N>]";
+  std::cout << "\n                      [-s |--size <N>]";
+  std::cout << " [-f |--filter <substring>]";
+  std::cout << " [-o |--output <json-file>]";
+  std::cout << "\n                      [-b |--baseline <json-file>]";
+  std::cout << " [-t |--threshold <percent>]" << std::endl;
+}
+
+static unsigned Iterations = 7;
+static unsigned Warmup = 1;
+static unsigned Size = 10000;
+static double Threshold = 10.0;
+static std::string Filter;
+static std::string Output;
+static std::string Baseline;
+
+static bool ParseUnsigned(const char *S, unsigned &R) {
+  char *E = nullptr;
+  unsigned long V = std::strtoul(S, &E, 10);
+  if (!*S || *E || V > 10000000UL)
+    return false;
+
+  R = static_cast<unsigned>(V);
+  return true;
+}
+
+static unsigned ParseCommandLineArguments(int argc, char *const argv[]) {
+  int C = 0;
+  int option_index = 0;
+
+  while (1) {
+    C = getopt_long(argc, argv, "hn:w:s:f:o:b:t:", long_options,
+                    &option_index);
+    if (C == -1)
+      break;
+
+    switch (C) {
+    case 'h':
+      PrintHelp();
+      return 2;
+      break;
+    case 'n':
+      if (!ParseUnsigned(optarg, Iterations) || Iterations == 0) {
+        std::cerr << "Command-Line Error: Invalid iteration count."
+                  << std::endl;
+        return 1;
+      }
+      break;
+    case 'w':
+      if (!ParseUnsigned(optarg, Warmup)) {
+        std::cerr << "Command-Line Error: Invalid warmup count." << std::endl;
+        return 1;
+      }
+      break;
+    case 's':
+      if (!ParseUnsigned(optarg, Size) || Size == 0) {
+        std::cerr << "Command-Line Error: Invalid size." << std::endl;
+        return 1;
+      }
+      break;
+    case 'f':
+      Filter = optarg;
+      break;
+    case 'o':
+      Output = optarg;
+      break;
+    case 'b':
+      Baseline = optarg;
+      break;
+    case 't': {
+      char *E = nullptr;
+      Threshold = std::strtod(optarg, &E);
+      if (!*optarg || *E || Threshold < 0.0) {
+        std::cerr << "Command-Line Error: Invalid threshold." << std::endl;
+        return 1;
+      }
+    } break;
+    case '?':
+      std::cerr << "Command-Line Error: Invalid argument." << std::endl;
+      return 1;
+      break;
+    default:
+      return 1;
+      break;
+    }
+  }
+
+  if (optind < argc) {
+    std::cerr << "Command-Line Error: Unexpected argument " << argv[optind]
+              << "." << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
+
+// A benchmark runs Ops operations per iteration. Setup and Teardown run
+// before and after every iteration, and are not timed.
+struct MicroBench {
+  std::string Name;
+  unsigned Ops;
+  std::function<void()> Setup;
+  std::function<void()> Run;
+  std::function<void()> Teardown;
+};
+
+struct MicroResult {
+  std::string Name;
+  unsigned Ops = 0;
+  std::vector<double> NS;
+};
+
+// Keeps the results of the measured operations alive, so that the
+// compiler cannot drop them.
+static volatile uint64_t Sink = 0;
+
+// The benchmarks whose results failed their consistency check.
+static std::vector<std::string> Failed;
+
+static double Median(std::vector<double> V) {
+  if (V.empty())
+    return 0.0;
+
+  std::sort(V.begin(), V.end());
+  std::size_t N = V.size();
+  return N % 2 ? V[N / 2] : (V[N / 2 - 1] + V[N / 2]) / 2.0;
+}
+
+static double Min(const std::vector<double> &V) {
+  return V.empty() ? 0.0 : *std::min_element(V.begin(), V.end());
+}
+
+static MicroResult Measure(const MicroBench &B) {
+  using Clock = std::chrono::steady_clock;
+  using NS = std::chrono::duration<double, std::nano>;
+
+  MicroResult R;
+  R.Name = B.Name;
+  R.Ops = B.Ops;
+
+  for (unsigned I = 0; I < Warmup + Iterations; ++I) {
+    if (B.Setup)
+      B.Setup();
+
+    Clock::time_point T0 = Clock::now();
+    B.Run();
+    Clock::time_point T1 = Clock::now();
+
+    if (B.Teardown)
+      B.Teardown();
+
+    if (I >= Warmup)
+      R.NS.push_back(NS(T1 - T0).count() / B.Ops);
+  }
+
+  return R;
+}
+
+// The names of the symbols. Every iteration of the insertion benchmark
+// uses names of its own, since a symbol can only be declared once.
+static std::vector<std::string> Names(const std::string &Prefix,
+                                      unsigned N) {
+  std::vector<std::string> V;
+  V.reserve(N);
+  for (unsigned I = 0; I < N; ++I)
+    V.push_back(Prefix + std::to_string(I));
+
+  return V;
+}
+
+static std::vector<MicroBench>
+CreateBenchmarks(QASM::ASTReparser &RP) {
+  using namespace QASM;
+
+  std::vector<MicroBench> V;
+
+  // The symbol table is populated with Size global integers, which are
+  // then looked up in a shuffled order. The insertion benchmark declares
+  // another Size symbols on top of these, and erases them again.
+  static std::vector<ASTIdentifierNode *> Globals;
+  static std::vector<ASTIdentifierNode *> Inserted;
+  static std::vector<std::string> Fresh;
+  static unsigned Generation = 0;
+
+  for (const std::string &N : Names("mbg", Size)) {
+    ASTIdentifierNode *Id =
+        ASTBuilder::Instance().CreateASTIdentifierNode(N, 32U, ASTTypeInt);
+    if (Id)
+      Globals.push_back(Id);
+  }
+
+  std::vector<const ASTIdentifierNode *> Shuffled(Globals.begin(),
+                                                  Globals.end());
+  uint64_t X = 88172645463325252ULL;
+  for (std::size_t I = Shuffled.size(); I > 1; --I) {
+    X ^= X << 13;
+    X ^= X >> 7;
+    X ^= X << 17;
+    std::swap(Shuffled[I - 1], Shuffled[X % I]);
+  }
+
+  V.push_back(
+      {"symbol_table_insert", Size,
+       [] {
+         Fresh = Names("mbi" + std::to_string(Generation++) + "_", Size);
+         Inserted.clear();
+         Inserted.reserve(Size);
+       },
+       [] {
+         for (const std::string &N : Fresh)
+           Inserted.push_back(ASTBuilder::Instance().CreateASTIdentifierNode(
+               N, 32U, ASTTypeInt));
+       },
+       [] {
+         for (ASTIdentifierNode *Id : Inserted)
+           if (Id)
+             ASTSymbolTable::Instance().Erase(Id, 32U, ASTTypeInt);
+       }});
+
+  V.push_back({"symbol_table_lookup", Size, nullptr, [Shuffled] {
+                 ASTSymbolTable &ST = ASTSymbolTable::Instance();
+                 uint64_t F = 0;
+                 for (const ASTIdentifierNode *Id : Shuffled)
+                   F += ST.Lookup(Id, 32U, ASTTypeInt) != nullptr;
+                 Sink = Sink + F;
+               },
+               nullptr});
+
+  V.push_back({"symbol_table_lookup_name", Size, nullptr, [Shuffled] {
+                 uint64_t F = 0;
+                 for (const ASTIdentifierNode *Id : Shuffled)
+                   F += ASTSymbolTable::Instance().Lookup(Id->GetName()) !=
+                        nullptr;
+                 Sink = Sink + F;
+               },
+               nullptr});
+
+  // Mangling goes through the Mangle() of real nodes, and the names it
+  // produces are the input of the demangler.
+  static std::vector<ASTExpressionNode *> Mangled;
+  static std::vector<std::string> MangledNames;
+
+  for (unsigned I = 0; I < 64; ++I) {
+    std::string S = std::to_string(I);
+    Mangled.push_back(
+        new ASTIntNode(new ASTIdentifierNode("mbm_i" + S, ASTTypeInt, 32U),
+                       static_cast<int32_t>(I)));
+    Mangled.push_back(new ASTCBitNode(
+        new ASTIdentifierNode("mbm_b" + S, ASTTypeBitset, 8U + I), 8U + I,
+        0x55UL));
+    Mangled.push_back(new ASTMPDecimalNode(
+        new ASTIdentifierNode("mbm_f" + S, ASTTypeMPDecimal, 64U + I), 64U + I,
+        0.5 * I));
+    Mangled.push_back(new ASTAngleNode(
+        new ASTIdentifierNode("mbm_a" + S, ASTTypeAngle, 20U), 20U,
+        "0.785398163397448309615660845819875721"));
+  }
+
+  for (ASTExpressionNode *E : Mangled) {
+    E->Mangle();
+    if (!E->GetIdentifier()->GetMangledName().empty())
+      MangledNames.push_back(E->GetIdentifier()->GetMangledName());
+  }
+
+  V.push_back({"mangle", static_cast<unsigned>(Mangled.size()), nullptr,
+               [] {
+                 for (ASTExpressionNode *E : Mangled)
+                   E->Mangle();
+               },
+               nullptr});
+
+  if (!MangledNames.empty())
+    V.push_back({"demangle", static_cast<unsigned>(MangledNames.size()),
+                 nullptr,
+                 [] {
+                   uint64_t L = 0;
+                   for (const std::string &S : MangledNames) {
+                     ASTDemangler DM;
+                     DM.Demangle(S);
+                     L += DM.AsString().length();
+                   }
+                   Sink = Sink + L;
+                 },
+                 [] { ASTDemangledRegistry::Instance().Release(); }});
+
+  static std::vector<std::string> TokenStrings = Names("mbt", Size);
+
+  V.push_back({"token_create_register", Size, nullptr,
+               [] {
+                 for (const std::string &S : TokenStrings) {
+                   ASTToken *T = ASTTokenFactory::Create(S, 0);
+                   ASTTokenFactory::Register(T, T->GetIndex());
+                 }
+               },
+               [] { ASTTokenFactory::Clear(); }});
+
+  // The identifiers register themselves with their declaration context,
+  // and are not released.
+  static std::vector<std::string> IdentifierNames = Names("mbx", Size);
+
+  V.push_back({"identifier_create", Size, nullptr,
+               [] {
+                 uint64_t B = 0;
+                 for (const std::string &S : IdentifierNames)
+                   B += (new ASTIdentifierNode(S, ASTTypeInt, 32U))->GetBits();
+                 Sink = Sink + B;
+               },
+               nullptr});
+
+  // Registers the globals with a declaration context, unregisters half
+  // of them while they are still journaled and a quarter after they
+  // were replayed, and checks that exactly the remaining quarter is
+  // left in the context.
+  static ASTDeclarationContext *DCX = nullptr;
+
+  V.push_back({"declaration_context_journal", Size,
+               [] {
+                 delete DCX;
+                 DCX = new ASTDeclarationContext("mbdc", 1U);
+               },
+               [] {
+                 const std::size_t N = Globals.size();
+                 for (std::size_t I = 0; I < N; ++I)
+                   DCX->RegisterSymbol(Globals[I], ASTTypeInt);
+                 for (std::size_t I = 0; I < N; I += 2)
+                   DCX->UnregisterSymbol(Globals[I]);
+                 Sink = Sink + DCX->GetSymbolTable().size();
+                 for (std::size_t I = 1; I < N; I += 4)
+                   DCX->UnregisterSymbol(Globals[I]);
+               },
+               [] {
+                 bool OK = DCX->GetJournalSize() == 0UL;
+                 for (std::size_t I = 0; OK && I < Globals.size(); ++I)
+                   OK = DCX->HasSymbol(Globals[I]) == (I % 4 == 3);
+                 OK = OK && DCX->GetSymbolTable().size() == Globals.size() / 4;
+                 if (!OK)
+                   Failed.push_back("declaration_context_journal");
+               }});
+
+  static ASTIdentifierNode *MPId =
+      new ASTIdentifierNode("mbmp", ASTTypeMPDecimal, 128U);
+  static ASTIdentifierNode *MPCId =
+      new ASTIdentifierNode("mbmpc", ASTTypeMPComplex, 128U);
+  static std::vector<ASTExpressionNode *> Literals;
+  static const ASTMPDecimalNode *MPR =
+      new ASTMPDecimalNode(MPId, 128U, "0.75");
+  static const ASTMPDecimalNode *MPI =
+      new ASTMPDecimalNode(MPId, 128U, "0.25");
+
+  auto ReleaseLiterals = [] {
+    for (ASTExpressionNode *E : Literals)
+      delete E;
+    Literals.clear();
+  };
+
+  V.push_back({"mpdecimal_create_string", Size,
+               [] { Literals.reserve(Size); },
+               [] {
+                 for (unsigned I = 0; I < Size; ++I)
+                   Literals.push_back(new ASTMPDecimalNode(
+                       MPId, 128U, "3.14159265358979323846264338327950288"));
+               },
+               ReleaseLiterals});
+
+  V.push_back({"mpdecimal_create_double", Size,
+               [] { Literals.reserve(Size); },
+               [] {
+                 for (unsigned I = 0; I < Size; ++I)
+                   Literals.push_back(
+                       new ASTMPDecimalNode(MPId, 64U, 0.125 * I));
+               },
+               ReleaseLiterals});
+
+  V.push_back({"mpcomplex_create", Size, [] { Literals.reserve(Size); },
+               [] {
+                 for (unsigned I = 0; I < Size; ++I)
+                   Literals.push_back(new ASTMPComplexNode(
+                       MPCId, MPR, MPI, ASTOpTypeAdd, 128U));
+               },
+               ReleaseLiterals});
+
+  // Bitwise operations on a short and a long classical register.
+  for (unsigned Bits : {64U, 1024U}) {
+    ASTCBitNode *L = new ASTCBitNode(
+        new ASTIdentifierNode("mbc" + std::to_string(Bits), ASTTypeBitset,
+                              Bits),
+        Bits, 0xF0F0F0F0F0F0F0F0UL);
+    ASTCBitNode *R = new ASTCBitNode(
+        new ASTIdentifierNode("mbd" + std::to_string(Bits), ASTTypeBitset,
+                              Bits),
+        Bits, 0x3333333333333333UL);
+
+    V.push_back({"cbit_ops_" + std::to_string(Bits), Size, nullptr,
+                 [L, R] {
+                   uint64_t P = 0;
+                   for (unsigned I = 0; I < Size; ++I) {
+                     L->Xor(R);
+                     L->And(R);
+                     L->Or(R);
+                     L->Rotl(3);
+                     L->Flip();
+                     P += L->Popcount();
+                   }
+                   Sink = Sink + P;
+                 },
+                 nullptr});
+  }
+
+  // Converts radians to angle[64] words, and checks the rounding of
+  // known values: negative inputs wrap, and narrowing rounds to
+  // nearest with ties to even. FromRadians cannot meet an exact tie,
+  // since a nonzero double is never a rational multiple of 2 * pi.
+  static const double Radians[] = {3.0, -3.0, 1.0, -1.0, 7.0, -7.0, 100.25};
+
+  V.push_back({"angle_fixed_point", Size, nullptr,
+               [] {
+                 uint64_t W = 0;
+                 ASTAngleFixedPoint FP;
+                 for (unsigned I = 0; I < Size; ++I) {
+                   ASTAngleFixedPoint::FromRadians(Radians[I % 7U], 64U, FP);
+                   W += FP.GetWord();
+                 }
+                 Sink = Sink + W;
+               },
+               [] {
+                 auto Word = [](double R, unsigned Bits) {
+                   ASTAngleFixedPoint FP;
+                   return ASTAngleFixedPoint::FromRadians(R, Bits, FP)
+                              ? FP.GetWord()
+                              : ~uint64_t(0);
+                 };
+                 auto Narrow = [](uint64_t W, unsigned From, unsigned To) {
+                   return ASTAngleFixedPoint(W, From).Resize(To).GetWord();
+                 };
+
+                 bool OK = Word(3.0, 8U) == 0x7AUL &&
+                           Word(-3.0, 8U) == 0x86UL &&
+                           Word(-0.5, 16U) == 0xEBA1UL &&
+                           Word(-1.0, 32U) == 0xD7419F24UL &&
+                           Word(1.0, 64U) == 0x28BE60DB9391054AUL &&
+                           Word(-7.0, 64U) == 0xE2CB59FEF708DAF7UL &&
+                           Word(100.25, 53U) == 0x1E91ADBF91314AUL &&
+                           Word(0.0, 64U) == 0UL;
+
+                 OK = OK && Narrow(0x18UL, 8U, 4U) == 0x2UL &&
+                      Narrow(0x28UL, 8U, 4U) == 0x2UL &&
+                      Narrow(0x29UL, 8U, 4U) == 0x3UL &&
+                      Narrow(0xF8UL, 8U, 4U) == 0x0UL &&
+                      Narrow(0x3UL, 4U, 8U) == 0x30UL &&
+                      Narrow(uint64_t(1) << 63, 64U, 1U) == 0x1UL;
+
+                 if (!OK)
+                   Failed.push_back("angle_fixed_point");
+               }});
+
+  // Folds a fixed set of constant expressions, and checks their values:
+  // integer overflow is not folded, a negative integer exponent yields a
+  // double, unsigned arithmetic wraps, angle casts round to the width of
+  // the angle, and popcount counts the bits of the 64-bit value.
+  ASTCVRQualifiers CVR(ASTTypeConst);
+  auto Int = [CVR](int32_t I) {
+    return new ASTIntNode(ASTIdentifierNode::Int.Clone(), I, CVR);
+  };
+  auto UInt = [CVR](uint32_t U) {
+    return new ASTIntNode(ASTIdentifierNode::Int.Clone(), U, CVR);
+  };
+  auto Double = [CVR](double D) {
+    return new ASTDoubleNode(ASTIdentifierNode::Double.Clone(), D, CVR);
+  };
+  auto Binary = [](const ASTExpressionNode *L, const ASTExpressionNode *R,
+                   ASTOpType OT) {
+    return new ASTBinaryOpNode(ASTIdentifierNode::BinaryOp.Clone(), L, R, OT);
+  };
+  auto Unary = [](const ASTExpressionNode *E, ASTOpType OT) {
+    return new ASTUnaryOpNode(ASTIdentifierNode::UnaryOp.Clone(), E, OT);
+  };
+
+  ASTBinaryOpNode *Square = Binary(Int(INT32_MAX), Int(INT32_MAX),
+                                   ASTOpTypeMul);
+  std::vector<const ASTExpressionNode *> Folded = {
+      Square,
+      Binary(Square, Int(4), ASTOpTypeMul),
+      Binary(Int(2), Int(-2), ASTOpTypePow),
+      Binary(Int(2), Unary(Int(3), ASTOpTypeNegative), ASTOpTypePow),
+      Binary(Int(-2), Int(3), ASTOpTypePow),
+      Binary(UInt(0U), UInt(1U), ASTOpTypeSub),
+      Unary(UInt(1U), ASTOpTypeNegative),
+      new ASTCastExpressionNode(Double(3.0), ASTTypeAngle, 8U),
+      new ASTCastExpressionNode(Double(-3.0), ASTTypeAngle, 8U),
+      new ASTCastExpressionNode(Double(-2.75), ASTTypeInt, 32U),
+      Unary(Int(255), ASTOpTypePopcount),
+      Unary(UInt(0xF0F0F0F0U), ASTOpTypePopcount),
+      Unary(Binary(Int(1), Int(40), ASTOpTypeLeftShift), ASTOpTypePopcount)};
+
+  V.push_back({"constant_folder", Size, nullptr,
+               [Folded] {
+                 uint64_t N = 0;
+                 ASTConstantValue CV;
+                 for (unsigned I = 0; I < Size; ++I) {
+                   if (I % 64U == 0U)
+                     ASTConstantFolder::Instance().Clear();
+                   N += ASTConstantFolder::Instance().Evaluate(
+                       Folded[I % Folded.size()], CV);
+                 }
+                 Sink = Sink + N;
+               },
+               [Folded] {
+                 const double Step = 6.283185307179586476925286766559 / 256.0;
+                 ASTConstantFolder &CF = ASTConstantFolder::Instance();
+                 std::vector<ASTConstantValue> R(Folded.size());
+                 std::vector<bool> OK(Folded.size());
+
+                 CF.Clear();
+                 for (std::size_t I = 0; I < Folded.size(); ++I)
+                   OK[I] = CF.Evaluate(Folded[I], R[I]);
+
+                 auto IsInt = [&](std::size_t I, int64_t E) {
+                   return OK[I] && R[I].GetKind() == ASTConstantValue::Int &&
+                          R[I].GetInt() == E;
+                 };
+                 auto IsUInt = [&](std::size_t I, uint64_t E) {
+                   return OK[I] && R[I].IsUnsigned() && R[I].GetUInt() == E;
+                 };
+                 auto IsDouble = [&](std::size_t I, double E) {
+                   return OK[I] && R[I].IsDouble() &&
+                          std::fabs(R[I].GetDouble() - E) < 1.0e-12;
+                 };
+
+                 bool Pass = IsInt(0, 4611686014132420609LL) && !OK[1] &&
+                             IsDouble(2, 0.25) && IsDouble(3, 0.125) &&
+                             IsInt(4, -8) && IsUInt(5, UINT64_MAX) &&
+                             IsUInt(6, UINT64_MAX) &&
+                             IsDouble(7, 122.0 * Step) &&
+                             IsDouble(8, 134.0 * Step) && IsInt(9, -2) &&
+                             IsInt(10, 8) && IsInt(11, 16) && IsInt(12, 1);
+
+                 CF.Clear();
+                 if (!Pass)
+                   Failed.push_back("constant_folder");
+               }});
+
+  // Types and folds a left-deep chain of Size additions, as a generated
+  // sum would be, and checks its type and value. The type cached on the
+  // operations must be recomputed after a symbol changes type.
+  static const ASTExpressionNode *Deep = nullptr;
+  V.push_back({"deep_expression", Size,
+               [] {
+                 ASTCVRQualifiers C(ASTTypeConst);
+                 ASTExpressionNode *E =
+                     new ASTDoubleNode(&ASTIdentifierNode::Double, 0.25, C);
+                 Literals.push_back(E);
+                 for (unsigned I = 1; I < Size; ++I) {
+                   ASTExpressionNode *R =
+                       new ASTDoubleNode(&ASTIdentifierNode::Double, 0.25, C);
+                   Literals.push_back(R);
+                   E = new ASTBinaryOpNode(&ASTIdentifierNode::BinaryOp, E, R,
+                                           ASTOpTypeAdd);
+                   Literals.push_back(E);
+                 }
+                 Deep = E;
+               },
+               [] {
+                 const ASTBinaryOpNode *BOP =
+                     dynamic_cast<const ASTBinaryOpNode *>(Deep);
+                 ASTConstantValue CV;
+                 if (BOP)
+                   Sink = Sink + BOP->GetExpressionType();
+                 Sink = Sink + ASTConstantFolder::Instance().Evaluate(Deep, CV);
+               },
+               [ReleaseLiterals] {
+                 const ASTBinaryOpNode *BOP =
+                     dynamic_cast<const ASTBinaryOpNode *>(Deep);
+                 ASTConstantValue CV;
+                 bool Pass =
+                     Size < 2U ||
+                     (BOP && BOP->GetExpressionType() == ASTTypeDouble &&
+                      ASTConstantFolder::Instance().Evaluate(Deep, CV) &&
+                      CV.IsDouble() && CV.GetDouble() == 0.25 * Size);
+
+                 if (Pass && BOP && !Globals.empty()) {
+                   Globals.front()->SetSymbolType(ASTTypeFloat);
+                   Pass = !BOP->HasExpressionType();
+                   Globals.front()->SetSymbolType(ASTTypeInt);
+                   Pass = Pass && BOP->GetExpressionType() == ASTTypeDouble &&
+                          BOP->HasExpressionType();
+                 }
+
+                 ASTConstantFolder::Instance().Clear();
+                 ReleaseLiterals();
+                 Deep = nullptr;
+                 if (!Pass)
+                   Failed.push_back("deep_expression");
+               }});
+
+  // Typing a character into a comment, and deleting it again, as an
+  // editor would. The edits keep the AST of the reparser.
+  ASTReparser *P = &RP;
+  V.push_back({"reparse_edit_comment", Size, nullptr,
+               [P] {
+                 std::size_t O = P->GetSource().size() - 1UL;
+                 uint64_t R = 0;
+                 for (unsigned I = 0; I < Size; ++I) {
+                   P->Edit(O, 0UL, "x");
+                   P->Edit(O, 1UL, "");
+                   R += P->GetLastParseKind() == ASTReparser::Reused;
+                 }
+                 Sink = Sink + R;
+               },
+               nullptr});
+
+  // Swapping the operands of a gate, and swapping them back. Each edit
+  // re-parses the gate on its own, and splices it into the AST. Indenting
+  // the gate moves its columns, and is parsed from scratch.
+  static const std::string Gates = "OPENQASM 3.0;\nqubit[2] q;\n"
+                                   "CX q[0], q[1];\n// qasm-microbench\n";
+  static unsigned Spliced = 0U;
+  V.push_back({"reparse_edit_gate", Size,
+               [P] {
+                 P->Parse(Gates);
+                 Spliced = 0U;
+               },
+               [P] {
+                 std::size_t O = P->GetSource().find("q[0], q[1]");
+                 for (unsigned I = 0; I < Size; ++I) {
+                   P->Edit(O, 10UL, "q[1], q[0]");
+                   Spliced += P->GetLastParseKind() == ASTReparser::Spliced;
+                   P->Edit(O, 10UL, "q[0], q[1]");
+                   Spliced += P->GetLastParseKind() == ASTReparser::Spliced;
+                 }
+                 Sink = Sink + Spliced;
+               },
+               [P] {
+                 bool Pass = Spliced == 2U * Size && P->GetRoot() &&
+                             !QasmDiagnosticEmitter::Instance().HasErrors();
+
+                 P->Edit(P->GetSource().find("CX"), 0UL, " ");
+                 Pass = Pass && P->GetLastParseKind() == ASTReparser::Parsed;
+                 P->Parse(std::string("OPENQASM 3.0;\n// qasm-microbench\n"));
+                 if (!Pass)
+                   Failed.push_back("reparse_edit_gate");
+               }});
+
+  // A parse that goes over its time budget is abandoned. The budget reads
+  // a clock that moves on by a millisecond at every deadline check, so
+  // that the parse stops at the tenth check on any machine.
+  static std::string Budgeted;
+  static std::string BudgetError;
+  V.push_back({"parse_budget_time", 1U,
+               [] {
+                 if (Budgeted.empty()) {
+                   Budgeted = "OPENQASM 3.0;\n";
+                   for (unsigned I = 0; I < 2000U; ++I)
+                     Budgeted += "bit b" + std::to_string(I) + ";\n";
+                 }
+
+                 BudgetError.clear();
+               },
+               [P] {
+                 QasmDiagnosticEmitter &DE = QasmDiagnosticEmitter::Instance();
+                 QasmDiagnosticEmitter::QasmDiagnosticHandler H =
+                     DE.GetHandler();
+                 const unsigned E = DE.GetNumErrors();
+                 const unsigned W = DE.GetNumWarnings();
+                 const unsigned I = DE.GetNumICEs();
+                 ASTParseBudget &PB = ASTParseBudget::Instance();
+
+                 DE.SetHandler([](const std::string &, ASTLocation,
+                                  const std::string &M,
+                                  QasmDiagnosticEmitter::DiagLevel DL) {
+                   if (DL == QasmDiagnosticEmitter::Error &&
+                       BudgetError.empty())
+                     BudgetError = M;
+                 });
+                 PB.SetClock([] {
+                   static ASTParseBudget::Clock::time_point T;
+                   T += std::chrono::milliseconds(1);
+                   return T;
+                 });
+                 PB.SetTimeout(std::chrono::milliseconds(10));
+
+                 Sink = Sink + (P->Parse(Budgeted) != nullptr);
+
+                 PB.SetTimeout(std::chrono::milliseconds(0));
+                 PB.SetClock(nullptr);
+                 DE.SetHandler(H);
+                 DE.ResetCounters(E, W, I);
+               },
+               [P] {
+                 P->Parse(std::string("OPENQASM 3.0;\n// qasm-microbench\n"));
+                 if (BudgetError !=
+                     "Parse budget exceeded: the parse took more than 10 ms.")
+                   Failed.push_back("parse_budget_time");
+               }});
+
+  return V;
+}
+
+static std::string Escape(const std::string &S) {
+  std::string R;
+  for (char C : S) {
+    if (C == '"' || C == '\\')
+      R += '\\';
+    R += C;
+  }
+
+  return R;
+}
+
+// Every benchmark is written on a line of its own, so that a baseline
+// can be read back line by line.
+static void WriteJSON(std::ostream &OS, const std::vector<MicroResult> &V) {
+  OS << "{\n  \"version\": 1,\n"
+     << "  \"iterations\": " << Iterations << ",\n"
+     << "  \"warmup\": " << Warmup << ",\n"
+     << "  \"size\": " << Size << ",\n"
+     << "  \"benchmarks\": [\n";
+
+  OS << std::fixed << std::setprecision(3);
+  for (std::vector<MicroResult>::const_iterator I = V.begin(); I != V.end();
+       ++I) {
+    const MicroResult &R = *I;
+    double M = Median(R.NS);
+
+    OS << "    {\"name\": \"" << Escape(R.Name) << "\", "
+       << "\"ops\": " << R.Ops << ", "
+       << "\"ns_per_op_min\": " << Min(R.NS) << ", "
+       << "\"ns_per_op_median\": " << M << ", "
+       << "\"ops_per_sec\": " << (M > 0.0 ? 1.0e9 / M : 0.0) << "}"
+       << (I + 1 == V.end() ? "\n" : ",\n");
+  }
+
+  OS << "  ]\n}" << std::endl;
+}
+
+static bool FindNumber(const std::string &L, const char *Key, double &V) {
+  std::string K = std::string("\"") + Key + "\": ";
+  std::string::size_type P = L.find(K);
+  if (P == std::string::npos)
+    return false;
+
+  V = std::strtod(L.c_str() + P + K.size(), nullptr);
+  return true;
+}
+
+static bool FindString(const std::string &L, const char *Key,
+                       std::string &V) {
+  std::string K = std::string("\"") + Key + "\": \"";
+  std::string::size_type P = L.find(K);
+  if (P == std::string::npos)
+    return false;
+
+  P += K.size();
+  std::string::size_type E = L.find('"', P);
+  if (E == std::string::npos)
+    return false;
+
+  V = L.substr(P, E - P);
+  return true;
+}
+
+// Compares the median times per operation against a JSON file written
+// by a previous run. Returns false if any benchmark got slower by more
+// than the threshold.
+static bool Compare(const std::vector<MicroResult> &V) {
+  std::ifstream IFS(Baseline);
+  if (!IFS.good()) {
+    std::cerr << "Error: Could not open baseline " << Baseline << "."
+              << std::endl;
+    return false;
+  }
+
+  std::map<std::string, double> BM;
+  std::string Line;
+  std::string Name;
+  double NS;
+
+  while (std::getline(IFS, Line))
+    if (FindString(Line, "name", Name) &&
+        FindNumber(Line, "ns_per_op_median", NS))
+      BM[Name] = NS;
+
+  bool OK = true;
+  std::cout << std::fixed << std::setprecision(1);
+  for (const MicroResult &R : V) {
+    std::map<std::string, double>::const_iterator I = BM.find(R.Name);
+    if (I == BM.end() || (*I).second <= 0.0)
+      continue;
+
+    double D = (Median(R.NS) - (*I).second) * 100.0 / (*I).second;
+    bool Regressed = D > Threshold;
+    std::cout << (Regressed ? "REGRESSION " : "") << R.Name << ": "
+              << (D >= 0.0 ? "+" : "") << D << "%" << std::endl;
+    OK = OK && !Regressed;
+  }
+
+  return OK;
+}
+
+int main(int argc, char *argv[]) {
+  using namespace QASM;
+  unsigned R;
+
+  if ((R = ParseCommandLineArguments(argc, argv)) != 0)
+    return R == 2 ? 0 : 1;
+
+  // Parsing an empty program initializes the type system, the symbol
+  // table and the declaration contexts the same way a real parse does.
+  ASTReparser Parser;
+  if (!Parser.Parse(std::string("OPENQASM 3.0;\n// qasm-microbench\n")) ||
+      QasmDiagnosticEmitter::Instance().GetNumErrors()) {
+    std::cerr << "Error: Could not initialize the parser." << std::endl;
+    return 1;
+  }
+
+  std::vector<MicroResult> Results;
+  for (const MicroBench &B : CreateBenchmarks(Parser)) {
+    if (!Filter.empty() && B.Name.find(Filter) == std::string::npos)
+      continue;
+
+    Results.push_back(Measure(B));
+  }
+
+  std::cout << std::left << std::setw(28) << "Benchmark" << std::right
+            << std::setw(14) << "ns/op (min)" << std::setw(14)
+            << "ns/op (med)" << std::endl;
+  std::cout << std::fixed << std::setprecision(1);
+  for (const MicroResult &MR : Results)
+    std::cout << std::left << std::setw(28) << MR.Name << std::right
+              << std::setw(14) << Min(MR.NS) << std::setw(14)
+              << Median(MR.NS) << std::endl;
+
+  if (!Output.empty()) {
+    std::ofstream OFS(Output);
+    if (!OFS.good()) {
+      std::cerr << "Error: Could not open " << Output << "." << std::endl;
+      return 1;
+    }
+
+    WriteJSON(OFS, Results);
+  } else {
+    WriteJSON(std::cout, Results);
+  }
+
+  if (!Failed.empty()) {
+    for (const std::string &N : Failed)
+      std::cerr << "Error: Benchmark " << N << " failed its check."
+                << std::endl;
+    return 1;
+  }
+
+  if (!Baseline.empty() && !Compare(Results))
+    return 2;
+
+  return 0;
+}
@@ -17,13 +17,23 @@
  */
 
 #include <qasm/AST/AST.h>
+#include <qasm/AST/ASTDeclarationContext.h>
+#include <qasm/AST/ASTLiteralPool.h>
+#include <qasm/AST/ASTMPMemoryPool.h>
+#include <qasm/AST/ASTMemoryAccounting.h>
 #include <qasm/AST/ASTObjectTracker.h>
 #include <qasm/Frontend/QasmParser.h>
 
+#include <cstring>
 #include <iostream>
+#include <vector>
 
 static void Usage() {
-  std::cerr << "Usage: QasmParser [-keep-temps] ";
+  std::cerr << "Usage: QasmParser [-keep-temps] [-mp-pool] [-literal-pool] ";
+  std::cerr << "[-dt=<dt>] [-mem-report] [-stream] [-fast-path] ";
+  std::cerr << "[-pack-waveforms] [-synthesize-waveforms] ";
+  std::cerr << "\n                  [-max-parse-ms=<ms>] [-max-nodes=<n>] ";
+  std::cerr << "[-max-symbols=<n>] [-max-bytes=<n>] ";
   std::cerr << "[-I<include-dir> [ -I<include-dir> ...]] ";
   std::cerr << "\n                  <translation-unit>" << std::endl;
 }
@@ -42,13 +52,65 @@ int main(int argc, char *argv[]) {
   // AST Generator. It is enabled here for illustration purposes.
   QASM::ASTObjectTracker::Instance().Enable();
 
+  // With -stream, every top-level statement is printed as soon as it
+  // has been parsed.
+  bool Stream = false;
+  std::vector<char *> Args;
+  for (int I = 0; I < argc; ++I) {
+    if (std::strcmp(argv[I], "-stream") == 0)
+      Stream = true;
+    else
+      Args.push_back(argv[I]);
+  }
+
   QASM::ASTParser Parser;
-  Parser.ParseCommandLineArguments(argc, argv);
-  QASM::ASTRoot *Root = Parser.ParseAST();
-  Root->print();
+  if (!Parser.ParseCommandLineArguments(static_cast<int>(Args.size()),
+                                        Args.data()))
+    return 1;
+
+  if (Stream) {
+    if (!Parser.StreamAST([](QASM::ASTStatement *SN) { SN->print(); }))
+      return 1;
+  } else {
+    // ParseAST returns nullptr if the parse went over one of the
+    // -max-* budgets.
+    QASM::ASTRoot *Root = Parser.ParseAST();
+    if (!Root)
+      return 1;
+
+    Root->print();
+  }
+
+  // With -mem-report, print the memory used by the AST at the end of
+  // the parse, by ASTType.
+  if (QASM::ASTMemoryAccounting::Instance().IsEnabled()) {
+    QASM::ASTMemoryAccounting::Instance().Print(std::cerr);
+
+    const QASM::ASTDeclarationContext *GCX =
+        QASM::ASTDeclarationContextTracker::Instance().GetGlobalContext();
+    std::cerr << "Global context journal: " << GCX->GetJournalSize()
+              << " slots, " << GCX->GetJournalLiveSize() << " live."
+              << std::endl;
+  }
+
+  // With -literal-pool, print how many literals were shared. The pool
+  // is cleared when the AST is released.
+  if (QASM::ASTLiteralPool::Instance().IsEnabled())
+    std::cerr << "Literal pool: " << QASM::ASTLiteralPool::Instance().Size()
+              << " literals, " << QASM::ASTLiteralPool::Instance().GetHits()
+              << " hits, " << QASM::ASTLiteralPool::Instance().GetMisses()
+              << " misses." << std::endl;
 
   // If the ASTObjectTracker is not enabled, this is a no-op.
   QASM::ASTObjectTracker::Instance().Release();
 
+  // With -mp-pool, the release has returned every chunk of GMP limbs
+  // that no longer holds a value to the system.
+  if (QASM::ASTMPMemoryPool::Instance().IsEnabled())
+    std::cerr << "MP pool: " << QASM::ASTMPMemoryPool::Instance().GetNumChunks()
+              << " chunks held, "
+              << QASM::ASTMPMemoryPool::Instance().GetNumEmptyChunks()
+              << " empty." << std::endl;
+
   return 0;
 }
@@ -0,0 +1,177 @@
+/* -*- coding: utf-8 -*-
+ *
+ * Copyright 2023 IBM RESEARCH. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#ifndef __QASM_AST_ANGLE_FIXED_POINT_H
+#define __QASM_AST_ANGLE_FIXED_POINT_H
+
+#include <gmp.h>
+#include <mpfr.h>
+
+#include <cassert>
+#include <cstdint>
+
+namespace QASM {
+
+// The fixed-point value of an OpenQASM angle[N], for 1 <= N <= 64.
+//
+// An angle[N] holding the word K represents 2 * pi * K / 2^N radians.
+// Words are kept reduced modulo 2^N, so addition, subtraction, negation
+// and multiplication by an integer wrap around the circle exactly, as
+// required by the specification.
+class ASTAngleFixedPoint {
+public:
+  static const unsigned MaxBits = 64U;
+
+private:
+  uint64_t V;
+  unsigned N;
+
+private:
+  static uint64_t Mask(unsigned Bits) {
+    return Bits >= 64U ? ~uint64_t(0) : (uint64_t(1) << Bits) - 1;
+  }
+
+public:
+  ASTAngleFixedPoint() : V(0), N(0) {}
+
+  ASTAngleFixedPoint(uint64_t Word, unsigned Bits) : V(0), N(Bits) {
+    assert(Bits && Bits <= MaxBits && "Invalid angle width!");
+    V = Word & Mask(Bits);
+  }
+
+  ASTAngleFixedPoint(const ASTAngleFixedPoint &RHS) = default;
+  ASTAngleFixedPoint &operator=(const ASTAngleFixedPoint &RHS) = default;
+
+  ~ASTAngleFixedPoint() = default;
+
+  // Rounds X radians to the nearest angle[Bits], ties to even, and
+  // wraps it into [0, 2 * pi). Fails if X is not a finite number.
+  static bool FromRadians(double X, unsigned Bits, ASTAngleFixedPoint &R);
+
+  // Same as above, for an MPFR value of any precision. The reduction
+  // modulo 2 * pi is carried out with enough extra bits to make the
+  // result exact.
+  static bool FromMP(const mpfr_t &X, unsigned Bits, ASTAngleFixedPoint &R);
+
+  // Returns the angle in radians, in [0, 2 * pi).
+  double ToRadians() const;
+
+  // Sets R to the angle in radians, rounded to the precision of R.
+  void ToMP(mpfr_t &R) const;
+
+  bool IsValid() const { return N != 0; }
+
+  uint64_t GetWord() const { return V; }
+
+  unsigned GetBits() const { return N; }
+
+  bool IsZero() const { return V == 0; }
+
+  // Converts to angle[Bits]. Widening appends zero bits. Narrowing
+  // rounds to nearest, ties to even, and wraps.
+  ASTAngleFixedPoint Resize(unsigned Bits) const {
+    assert(IsValid() && "Invalid angle!");
+    assert(Bits && Bits <= MaxBits && "Invalid angle width!");
+
+    if (Bits >= N)
+      return ASTAngleFixedPoint(V << (Bits - N), Bits);
+
+    unsigned S = N - Bits;
+    uint64_t Q = V >> S;
+    uint64_t Rem = V & Mask(S);
+    uint64_t Half = uint64_t(1) << (S - 1);
+
+    if (Rem > Half || (Rem == Half && (Q & 1)))
+      ++Q;
+
+    return ASTAngleFixedPoint(Q, Bits);
+  }
+
+  ASTAngleFixedPoint operator-() const {
+    return ASTAngleFixedPoint(uint64_t(0) - V, N);
+  }
+
+  ASTAngleFixedPoint operator+(const ASTAngleFixedPoint &RHS) const {
+    assert(N == RHS.N && "Mismatched angle widths!");
+    return ASTAngleFixedPoint(V + RHS.V, N);
+  }
+
+  ASTAngleFixedPoint operator-(const ASTAngleFixedPoint &RHS) const {
+    assert(N == RHS.N && "Mismatched angle widths!");
+    return ASTAngleFixedPoint(V - RHS.V, N);
+  }
+
+  ASTAngleFixedPoint operator*(uint64_t M) const {
+    return ASTAngleFixedPoint(V * M, N);
+  }
+
+  ASTAngleFixedPoint operator/(uint64_t D) const {
+    assert(D && "Division of an angle by zero!");
+    return ASTAngleFixedPoint(V / D, N);
+  }
+
+  // angle / angle is the unsigned integer quotient of the words.
+  uint64_t operator/(const ASTAngleFixedPoint &RHS) const {
+    assert(N == RHS.N && "Mismatched angle widths!");
+    assert(RHS.V && "Division of an angle by zero!");
+    return V / RHS.V;
+  }
+
+  ASTAngleFixedPoint operator<<(unsigned S) const {
+    return ASTAngleFixedPoint(S >= 64U ? 0 : V << S, N);
+  }
+
+  ASTAngleFixedPoint operator>>(unsigned S) const {
+    return ASTAngleFixedPoint(S >= 64U ? 0 : V >> S, N);
+  }
+
+  ASTAngleFixedPoint &operator+=(const ASTAngleFixedPoint &RHS) {
+    return *this = *this + RHS;
+  }
+
+  ASTAngleFixedPoint &operator-=(const ASTAngleFixedPoint &RHS) {
+    return *this = *this - RHS;
+  }
+
+  bool operator==(const ASTAngleFixedPoint &RHS) const {
+    return N == RHS.N && V == RHS.V;
+  }
+
+  bool operator!=(const ASTAngleFixedPoint &RHS) const {
+    return !(*this == RHS);
+  }
+
+  bool operator<(const ASTAngleFixedPoint &RHS) const {
+    assert(N == RHS.N && "Mismatched angle widths!");
+    return V < RHS.V;
+  }
+
+  bool operator>(const ASTAngleFixedPoint &RHS) const { return RHS < *this; }
+
+  bool operator<=(const ASTAngleFixedPoint &RHS) const {
+    return !(RHS < *this);
+  }
+
+  bool operator>=(const ASTAngleFixedPoint &RHS) const {
+    return !(*this < RHS);
+  }
+};
+
+} // namespace QASM
+
+#endif // __QASM_AST_ANGLE_FIXED_POINT_H
@@ -23,6 +23,7 @@
 #include <qasm/Diagnostic/DIAGLineCounter.h>
 
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
 #include <iostream>
 #include <string>
@@ -152,6 +153,8 @@ public:
 };
 
 class ASTTokenFactory {
+  friend class ASTMemoryAccounting;
+
 protected:
   static uint32_t TIX;
   static std::map<uint32_t, ASTToken *> TFM;
@@ -232,6 +235,12 @@ public:
 
   virtual ~ASTBase() = default;
 
+  // Record the size of the allocation with the ASTMemoryAccounting when
+  // it is enabled, and with the ASTParseBudget when it is running.
+  static void *operator new(std::size_t S);
+
+  static void operator delete(void *P);
+
   virtual ASTType GetASTType() const = 0;
 
   virtual void print() const = 0;
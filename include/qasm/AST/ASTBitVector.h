@@ -0,0 +1,377 @@
+/* -*- coding: utf-8 -*-
+ *
+ * Copyright 2023 IBM RESEARCH. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#ifndef __QASM_AST_BIT_VECTOR_H
+#define __QASM_AST_BIT_VECTOR_H
+
+#include <bitset>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace QASM {
+
+// Dynamically sized bitset packed into 64-bit words.
+//
+// Bit I lives in bit (I % 64) of word (I / 64). The unused high bits of
+// the last word are always kept clear, so that whole-word operations
+// (popcount, comparisons, bitwise operators) never need to mask them.
+class ASTBitVector {
+public:
+  using word_type = uint64_t;
+
+  static const unsigned WordBits = 64U;
+
+  class reference {
+    friend class ASTBitVector;
+
+    word_type *W;
+    word_type M;
+
+    reference(word_type *Word, unsigned Bit)
+        : W(Word), M(word_type(1) << Bit) {}
+
+  public:
+    operator bool() const { return (*W & M) != 0; }
+
+    reference &operator=(bool B) {
+      if (B)
+        *W |= M;
+      else
+        *W &= ~M;
+      return *this;
+    }
+
+    reference &operator=(const reference &RHS) {
+      return *this = static_cast<bool>(RHS);
+    }
+
+    void flip() { *W ^= M; }
+  };
+
+  using const_reference = bool;
+
+  template <typename __VectorType, typename __RefType>
+  class basic_iterator {
+    __VectorType *V;
+    std::size_t I;
+
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = bool;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = __RefType;
+
+    basic_iterator(__VectorType *Vec, std::size_t Index) : V(Vec), I(Index) {}
+
+    __RefType operator*() const { return (*V)[I]; }
+
+    basic_iterator &operator++() {
+      ++I;
+      return *this;
+    }
+
+    basic_iterator operator++(int) {
+      basic_iterator T = *this;
+      ++I;
+      return T;
+    }
+
+    bool operator==(const basic_iterator &RHS) const { return I == RHS.I; }
+
+    bool operator!=(const basic_iterator &RHS) const { return I != RHS.I; }
+  };
+
+  using iterator = basic_iterator<ASTBitVector, reference>;
+  using const_iterator = basic_iterator<const ASTBitVector, const_reference>;
+
+private:
+  std::vector<word_type> W;
+  std::size_t N;
+
+private:
+  static std::size_t WordsFor(std::size_t Bits) {
+    return (Bits + WordBits - 1) / WordBits;
+  }
+
+  void ClearPadding() {
+    if (unsigned R = N % WordBits)
+      W.back() &= (word_type(1) << R) - 1;
+  }
+
+  static unsigned Popcount(word_type X) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_popcountll(X));
+#else
+    return static_cast<unsigned>(std::bitset<64>(X).count());
+#endif
+  }
+
+  // Returns bit range [B, B + 64) of the value, zero-filled past N.
+  word_type Extract(std::size_t B) const {
+    std::size_t WI = B / WordBits;
+    unsigned O = B % WordBits;
+    word_type R = WI < W.size() ? W[WI] >> O : 0;
+
+    if (O && WI + 1 < W.size())
+      R |= W[WI + 1] << (WordBits - O);
+
+    return R;
+  }
+
+public:
+  ASTBitVector() : W(), N(0) {}
+
+  ASTBitVector(std::size_t Bits, bool Value) : W(), N(0) {
+    assign(Bits, Value);
+  }
+
+  ASTBitVector(const ASTBitVector &RHS) = default;
+  ASTBitVector(ASTBitVector &&RHS) = default;
+  ASTBitVector &operator=(const ASTBitVector &RHS) = default;
+  ASTBitVector &operator=(ASTBitVector &&RHS) = default;
+
+  ~ASTBitVector() = default;
+
+  std::size_t size() const { return N; }
+
+  bool empty() const { return N == 0; }
+
+  std::size_t num_words() const { return W.size(); }
+
+  const word_type *data() const { return W.data(); }
+
+  void clear() {
+    W.clear();
+    N = 0;
+  }
+
+  void reserve(std::size_t Bits) { W.reserve(WordsFor(Bits)); }
+
+  void assign(std::size_t Bits, bool Value) {
+    N = Bits;
+    W.assign(WordsFor(Bits), Value ? ~word_type(0) : word_type(0));
+    ClearPadding();
+  }
+
+  void resize(std::size_t Bits) {
+    N = Bits;
+    W.resize(WordsFor(Bits), 0);
+    ClearPadding();
+  }
+
+  void push_back(bool B) {
+    if (N % WordBits == 0)
+      W.push_back(0);
+
+    if (B)
+      W.back() |= word_type(1) << (N % WordBits);
+    ++N;
+  }
+
+  bool test(std::size_t I) const {
+    assert(I < N && "Index is out-of-range!");
+    return (W[I / WordBits] >> (I % WordBits)) & 1;
+  }
+
+  void set(std::size_t I, bool B) { (*this)[I] = B; }
+
+  reference operator[](std::size_t I) {
+    assert(I < N && "Index is out-of-range!");
+    return reference(&W[I / WordBits], I % WordBits);
+  }
+
+  const_reference operator[](std::size_t I) const { return test(I); }
+
+  iterator begin() { return iterator(this, 0); }
+
+  iterator end() { return iterator(this, N); }
+
+  const_iterator begin() const { return const_iterator(this, 0); }
+
+  const_iterator end() const { return const_iterator(this, N); }
+
+  void flip() {
+    for (word_type &X : W)
+      X = ~X;
+    ClearPadding();
+  }
+
+  std::size_t count() const {
+    std::size_t R = 0;
+    for (word_type X : W)
+      R += Popcount(X);
+    return R;
+  }
+
+  bool any() const {
+    for (word_type X : W)
+      if (X)
+        return true;
+    return false;
+  }
+
+  bool none() const { return !any(); }
+
+  // Rotates the N-bit value towards the higher indices: bit I moves to
+  // bit (I + S) % N. Negative counts rotate the other way.
+  void rotl(long S) {
+    if (N == 0)
+      return;
+
+    long M = static_cast<long>(N);
+    S %= M;
+    if (S < 0)
+      S += M;
+    if (S == 0)
+      return;
+
+    if (N <= WordBits) {
+      word_type X = W[0];
+      W[0] = (X << S) | (X >> (M - S));
+      ClearPadding();
+      return;
+    }
+
+    // Bit I of the result is bit (I - S) mod N of the source. Every
+    // output word is assembled from at most two source words.
+    std::size_t K = N - static_cast<std::size_t>(S);
+    std::vector<word_type> R(W.size());
+
+    for (std::size_t WI = 0; WI < R.size(); ++WI) {
+      std::size_t B = WI * WordBits;
+      word_type X;
+
+      if (B + WordBits <= static_cast<std::size_t>(S)) {
+        X = Extract(B + K);
+      } else if (B >= static_cast<std::size_t>(S)) {
+        X = Extract(B - static_cast<std::size_t>(S));
+      } else {
+        // The word straddles the wrap point at bit S.
+        unsigned L = static_cast<unsigned>(S - B);
+        X = (Extract(B + K) & ((word_type(1) << L) - 1)) | (Extract(0) << L);
+      }
+
+      R[WI] = X;
+    }
+
+    W.swap(R);
+    ClearPadding();
+  }
+
+  void rotr(long S) { rotl(-(S % static_cast<long>(N ? N : 1))); }
+
+  ASTBitVector &operator&=(const ASTBitVector &RHS) {
+    assert(N == RHS.N && "Mismatched bitset sizes!");
+    word_type *D = W.data();
+    const word_type *S = RHS.W.data();
+    std::size_t E = W.size();
+
+#if defined(__GNUG__) && !defined(__clang__)
+#pragma GCC ivdep
+#elif defined(__clang__)
+#pragma clang loop vectorize(enable)
+#endif
+
+    for (std::size_t I = 0; I < E; ++I)
+      D[I] &= S[I];
+
+    return *this;
+  }
+
+  ASTBitVector &operator|=(const ASTBitVector &RHS) {
+    assert(N == RHS.N && "Mismatched bitset sizes!");
+    word_type *D = W.data();
+    const word_type *S = RHS.W.data();
+    std::size_t E = W.size();
+
+#if defined(__GNUG__) && !defined(__clang__)
+#pragma GCC ivdep
+#elif defined(__clang__)
+#pragma clang loop vectorize(enable)
+#endif
+
+    for (std::size_t I = 0; I < E; ++I)
+      D[I] |= S[I];
+
+    return *this;
+  }
+
+  ASTBitVector &operator^=(const ASTBitVector &RHS) {
+    assert(N == RHS.N && "Mismatched bitset sizes!");
+    word_type *D = W.data();
+    const word_type *S = RHS.W.data();
+    std::size_t E = W.size();
+
+#if defined(__GNUG__) && !defined(__clang__)
+#pragma GCC ivdep
+#elif defined(__clang__)
+#pragma clang loop vectorize(enable)
+#endif
+
+    for (std::size_t I = 0; I < E; ++I)
+      D[I] ^= S[I];
+
+    return *this;
+  }
+
+  bool operator==(const ASTBitVector &RHS) const {
+    return N == RHS.N && W == RHS.W;
+  }
+
+  bool operator!=(const ASTBitVector &RHS) const { return !(*this == RHS); }
+
+  // Returns the low bits of the value as an integral, bit 0 being the
+  // least significant.
+  template <typename __Type>
+  __Type ToIntegral() const {
+    static_assert(std::is_integral<__Type>::value,
+                  "type is not an integral type!");
+    using UT = typename std::make_unsigned<__Type>::type;
+    return static_cast<__Type>(static_cast<UT>(W.empty() ? 0 : W[0]));
+  }
+
+  // Appends the bits to S in index order, one '0' or '1' per bit.
+  void AppendTo(std::string &S) const {
+    std::size_t O = S.size();
+    S.resize(O + N);
+    char *P = &S[O];
+
+    for (std::size_t WI = 0; WI < W.size(); ++WI) {
+      word_type X = W[WI];
+      std::size_t E = WI + 1 < W.size() ? WordBits : N - WI * WordBits;
+      for (std::size_t I = 0; I < E; ++I, X >>= 1)
+        *P++ = static_cast<char>('0' + (X & 1));
+    }
+  }
+
+  std::string ToString() const {
+    std::string S;
+    AppendTo(S);
+    return S;
+  }
+};
+
+} // namespace QASM
+
+#endif // __QASM_AST_BIT_VECTOR_H
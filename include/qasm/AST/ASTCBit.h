@@ -19,12 +19,14 @@
 #ifndef __QASM_AST_CBIT_H
 #define __QASM_AST_CBIT_H
 
+#include <qasm/AST/ASTBitVector.h>
 #include <qasm/AST/ASTMathUtils.h>
 #include <qasm/AST/ASTTypes.h>
 
-#include <bitset>
+#include <algorithm>
 #include <cassert>
 #include <climits>
+#include <cstdint>
 #include <sstream>
 #include <vector>
 
@@ -37,9 +39,11 @@ class ASTCBitNode : public ASTExpressionNode {
   friend class ASTCBitNodeBuilder;
 
 protected:
-  mutable std::vector<bool> BV;
+  ASTBitVector BV;
   std::size_t NR;
-  std::string SR;
+  // String form of BV, one character per bit in index order. It is
+  // only built when asked for, and discarded when BV changes.
+  mutable std::string SR;
   std::size_t SZ;
   const ASTGateQOpNode *QOP;
   union {
@@ -52,6 +56,7 @@ protected:
   ASTType OTy;
   mutable bool P;
   mutable bool NBC;
+  mutable bool SRV;
 
 private:
   ASTCBitNode() = delete;
@@ -60,10 +65,16 @@ protected:
   ASTCBitNode(const ASTIdentifierNode *Id, const std::string &ERM)
       : ASTExpressionNode(Id, new ASTStringNode(ERM), ASTTypeExpressionError),
         NR(0UL), SR(ERM), SZ(0UL), QOP(nullptr), BOP(nullptr),
-        OTy(ASTTypeUndefined), P(false), NBC(false) {}
+        OTy(ASTTypeUndefined), P(false), NBC(false), SRV(true) {}
+
+  void Modified() {
+    SRV = false;
+    if (SZ && SZ <= 64)
+      NR = BV.ToIntegral<uint64_t>();
+  }
 
 public:
-  using vector_type = std::vector<bool>;
+  using vector_type = ASTBitVector;
   using iterator = typename vector_type::iterator;
   using const_iterator = typename vector_type::const_iterator;
   using reference = typename vector_type::reference;
@@ -75,23 +86,22 @@ public:
 public:
   ASTCBitNode(const ASTIdentifierNode *Id, std::size_t S,
               std::size_t Bitmask = 0UL)
-      : ASTExpressionNode(Id, ASTTypeBitset), BV(), NR(Bitmask), SR(), SZ(S),
-        QOP(nullptr), BOP(nullptr), OTy(ASTTypeUndefined), P(false),
-        NBC(false) {
+      : ASTExpressionNode(Id, ASTTypeBitset), BV(S, false), NR(Bitmask),
+        SR(), SZ(S), QOP(nullptr), BOP(nullptr), OTy(ASTTypeUndefined),
+        P(false), NBC(false), SRV(false) {
     assert(S > 0 && "Invalid bitset of size zero!");
 
-    std::bitset<CHAR_BIT * sizeof(Bitmask)> BS = Bitmask;
-    SR = BS.to_string();
-
-    for (std::size_t I = 0; I < S; ++I)
-      BV.push_back(BS[I]);
+    std::size_t E = std::min<std::size_t>(S, CHAR_BIT * sizeof(Bitmask));
+    for (std::size_t I = 0; I < E; ++I)
+      BV[I] = (Bitmask >> I) & 1UL;
   }
 
   ASTCBitNode(const ASTIdentifierNode *Id, std::size_t S,
               const std::string &Bitmask)
       : ASTExpressionNode(Id, ASTTypeBitset), BV(),
-        NR(static_cast<size_t>(~0x0)), SR(Bitmask), SZ(S), QOP(nullptr),
-        BOP(nullptr), OTy(ASTTypeUndefined), P(false), NBC(false) {
+        NR(static_cast<size_t>(~0x0)), SR(), SZ(S), QOP(nullptr),
+        BOP(nullptr), OTy(ASTTypeUndefined), P(false), NBC(false),
+        SRV(false) {
     assert(S > 0 && "Invalid bitset of size zero!");
 
     if (Bitmask.length()) {
@@ -100,51 +110,43 @@ public:
         NR = std::stoul(Bitmask, 0, 2);
 
       for (std::size_t I = 0; I < Bitmask.length(); ++I)
-        BV.emplace(BV.end(), Bitmask[I] == u8'1');
+        BV.push_back(Bitmask[I] == u8'1');
     } else {
-      SR = std::string(S, '0');
+      BV.assign(S, false);
       NR = 0UL;
     }
   }
 
   ASTCBitNode(const ASTIdentifierNode *Id, std::size_t S,
               const ASTCastExpressionNode *C)
-      : ASTExpressionNode(Id, ASTTypeBitset), BV(),
+      : ASTExpressionNode(Id, ASTTypeBitset), BV(S, true),
         NR(static_cast<size_t>(~0x0)), SR(), SZ(S), QOP(nullptr), CST(C),
-        OTy(ASTTypeCast), P(false), NBC(true) {
+        OTy(ASTTypeCast), P(false), NBC(true), SRV(false) {
     assert(S > 0 && "Invalid bitset of size zero!");
-    SR.assign(S, u8'1');
-    BV.assign(S, true);
   }
 
   ASTCBitNode(const ASTIdentifierNode *Id, std::size_t S,
               const ASTImplicitConversionNode *IC)
-      : ASTExpressionNode(Id, ASTTypeBitset), BV(),
+      : ASTExpressionNode(Id, ASTTypeBitset), BV(S, true),
         NR(static_cast<size_t>(~0x0)), SR(), SZ(S), QOP(nullptr), ICX(IC),
-        OTy(ASTTypeImplicitConversion), P(false), NBC(true) {
+        OTy(ASTTypeImplicitConversion), P(false), NBC(true), SRV(false) {
     assert(S > 0 && "Invalid bitset of size zero!");
-    SR.assign(S, u8'1');
-    BV.assign(S, true);
   }
 
   ASTCBitNode(const ASTIdentifierNode *Id, std::size_t S,
               const ASTBinaryOpNode *B)
-      : ASTExpressionNode(Id, ASTTypeBitset), BV(),
+      : ASTExpressionNode(Id, ASTTypeBitset), BV(S, true),
         NR(static_cast<size_t>(~0x0)), SR(), SZ(S), QOP(nullptr), BOP(B),
-        OTy(B->GetASTType()), P(false), NBC(true) {
+        OTy(B->GetASTType()), P(false), NBC(true), SRV(false) {
     assert(S > 0 && "Invalid bitset of size zero!");
-    SR.assign(S, u8'1');
-    BV.assign(S, true);
   }
 
   ASTCBitNode(const ASTIdentifierNode *Id, std::size_t S,
               const ASTUnaryOpNode *U)
-      : ASTExpressionNode(Id, ASTTypeBitset), BV(),
+      : ASTExpressionNode(Id, ASTTypeBitset), BV(S, true),
         NR(static_cast<size_t>(~0x0)), SR(), SZ(S), QOP(nullptr), UOP(U),
-        OTy(U->GetASTType()), P(false), NBC(true) {
+        OTy(U->GetASTType()), P(false), NBC(true), SRV(false) {
     assert(S > 0 && "Invalid bitset of size zero!");
-    SR.assign(S, u8'1');
-    BV.assign(S, true);
   }
 
   virtual ~ASTCBitNode() = default;
@@ -153,181 +155,59 @@ public:
 
   virtual std::size_t GetBits() const { return Size(); }
 
-  virtual unsigned Popcount() const {
-    unsigned R = 0U;
-    for (const_iterator I = BV.begin(); I != BV.end(); ++I)
-      R += *I;
+  virtual unsigned Popcount() const { return BV.count(); }
 
-    return R;
+  virtual void SetAllTo(bool BM) {
+    BV.assign(BV.size(), BM);
+    Modified();
   }
 
-  virtual void SetAllTo(bool BM) {
-    for (iterator I = BV.begin(); I != BV.end(); ++I)
-      *I = BM;
+  virtual void Flip() {
+    BV.flip();
+    Modified();
   }
 
-  virtual void Flip() { BV.flip(); }
+  virtual const std::string &AsString() const {
+    if (!SRV) {
+      SR.clear();
+      BV.AppendTo(SR);
+      SRV = true;
+    }
 
-  virtual const std::string &AsString() const { return SR; }
+    return SR;
+  }
 
   virtual bool ResolveCast();
 
   virtual void Rotl(int SH) {
-    if (SZ == 0) {
+    if (SZ == 0)
       return;
-    } else if (SZ && SZ <= 64) {
-      std::bitset<64> BS(SR);
-      std::bitset<64> BR = ASTMathUtils::Instance().rotl(BS, SH);
-      std::size_t VL = BV.size();
-      BV.clear();
-
-      for (std::size_t I = 0; I < VL; ++I)
-        BV.push_back(BR[I]);
-
-      NR = BR.to_ullong();
-      SR = BR.to_string();
-    } else {
-      NR = static_cast<uint64_t>(~0x0);
-      std::size_t VL = BV.size();
-      BV.clear();
-
-      if (SZ > 64 && SZ <= 128) {
-        std::bitset<128> BS = NR;
-        std::bitset<128> BR = ASTMathUtils::Instance().rotl(BS, SH);
-
-        for (std::size_t I = 0; I < VL; ++I)
-          BV.push_back(BR[I]);
-
-        SR = BR.to_string();
-      } else if (SZ > 128 && SZ <= 256) {
-        std::bitset<256> BS = NR;
-        std::bitset<256> BR = ASTMathUtils::Instance().rotl(BS, SH);
-
-        for (std::size_t I = 0; I < VL; ++I)
-          BV.push_back(BR[I]);
-
-        SR = BR.to_string();
-      } else if (SZ > 256 && SZ <= 512) {
-        std::bitset<512> BS = NR;
-        std::bitset<512> BR = ASTMathUtils::Instance().rotl(BS, SH);
-
-        for (std::size_t I = 0; I < VL; ++I)
-          BV.push_back(BR[I]);
-
-        SR = BR.to_string();
-      } else if (SZ > 512 && SZ <= 1024) {
-        std::bitset<1024> BS = NR;
-        std::bitset<1024> BR = ASTMathUtils::Instance().rotl(BS, SH);
-
-        for (std::size_t I = 0; I < VL; ++I)
-          BV.push_back(BR[I]);
-
-        SR = BR.to_string();
-      } else if (SZ > 1024 && SZ <= 2048) {
-        std::bitset<2048> BS = NR;
-        std::bitset<2048> BR = ASTMathUtils::Instance().rotl(BS, SH);
-
-        for (std::size_t I = 0; I < VL; ++I)
-          BV.push_back(BR[I]);
-
-        SR = BR.to_string();
-      } else if (SZ > 2048 && SZ <= 4096) {
-        std::bitset<4096> BS = NR;
-        std::bitset<4096> BR = ASTMathUtils::Instance().rotl(BS, SH);
 
-        for (std::size_t I = 0; I < VL; ++I)
-          BV.push_back(BR[I]);
-
-        SR = BR.to_string();
-      } else {
-        std::bitset<8192> BS = NR;
-        std::bitset<8192> BR = ASTMathUtils::Instance().rotl(BS, SH);
-
-        for (std::size_t I = 0; I < VL; ++I)
-          BV.push_back(BR[I]);
-
-        SR = BR.to_string();
-      }
-    }
+    BV.rotl(SH);
+    Modified();
   }
 
   virtual void Rotr(int SH) {
-    if (SZ == 0) {
+    if (SZ == 0)
       return;
-    } else if (SZ && SZ <= 64) {
-      std::bitset<64> BS(SR);
-      std::bitset<64> BR = ASTMathUtils::Instance().rotr(BS, SH);
-      std::size_t VL = BV.size();
-      BV.clear();
-
-      for (std::size_t I = 0; I < VL; ++I)
-        BV.push_back(BR[I]);
-
-      NR = BR.to_ullong();
-      SR = BR.to_string();
-    } else {
-      NR = static_cast<uint64_t>(~0x0);
-      std::size_t VL = BV.size();
-      BV.clear();
-
-      if (SZ > 64 && SZ <= 128) {
-        std::bitset<128> BS = NR;
-        std::bitset<128> BR = ASTMathUtils::Instance().rotr(BS, SH);
-
-        for (std::size_t I = 0; I < VL; ++I)
-          BV.push_back(BR[I]);
-
-        SR = BR.to_string();
-      } else if (SZ > 128 && SZ <= 256) {
-        std::bitset<256> BS = NR;
-        std::bitset<256> BR = ASTMathUtils::Instance().rotr(BS, SH);
-
-        for (std::size_t I = 0; I < VL; ++I)
-          BV.push_back(BR[I]);
-
-        SR = BR.to_string();
-      } else if (SZ > 256 && SZ <= 512) {
-        std::bitset<512> BS = NR;
-        std::bitset<512> BR = ASTMathUtils::Instance().rotr(BS, SH);
-
-        for (std::size_t I = 0; I < VL; ++I)
-          BV.push_back(BR[I]);
 
-        SR = BR.to_string();
-      } else if (SZ > 512 && SZ <= 1024) {
-        std::bitset<1024> BS = NR;
-        std::bitset<1024> BR = ASTMathUtils::Instance().rotr(BS, SH);
-
-        for (std::size_t I = 0; I < VL; ++I)
-          BV.push_back(BR[I]);
-
-        SR = BR.to_string();
-      } else if (SZ > 1024 && SZ <= 2048) {
-        std::bitset<2048> BS = NR;
-        std::bitset<2048> BR = ASTMathUtils::Instance().rotr(BS, SH);
-
-        for (std::size_t I = 0; I < VL; ++I)
-          BV.push_back(BR[I]);
-
-        SR = BR.to_string();
-      } else if (SZ > 2048 && SZ <= 4096) {
-        std::bitset<4096> BS = NR;
-        std::bitset<4096> BR = ASTMathUtils::Instance().rotr(BS, SH);
-
-        for (std::size_t I = 0; I < VL; ++I)
-          BV.push_back(BR[I]);
+    BV.rotr(SH);
+    Modified();
+  }
 
-        SR = BR.to_string();
-      } else {
-        std::bitset<8192> BS = NR;
-        std::bitset<8192> BR = ASTMathUtils::Instance().rotr(BS, SH);
+  virtual void And(const ASTCBitNode *CBN) {
+    BV &= CBN->BV;
+    Modified();
+  }
 
-        for (std::size_t I = 0; I < VL; ++I)
-          BV.push_back(BR[I]);
+  virtual void Or(const ASTCBitNode *CBN) {
+    BV |= CBN->BV;
+    Modified();
+  }
 
-        SR = BR.to_string();
-      }
-    }
+  virtual void Xor(const ASTCBitNode *CBN) {
+    BV ^= CBN->BV;
+    Modified();
   }
 
   virtual bool IsSet(unsigned Index) const {
@@ -335,15 +215,9 @@ public:
     return BV[Index];
   }
 
-  virtual bool AsBool() const {
-    unsigned U = 0U;
-    for (const_iterator I = BV.begin(); I != BV.end(); ++I)
-      U |= *I;
+  virtual bool AsBool() const { return BV.any(); }
 
-    return static_cast<bool>(U);
-  }
-
-  virtual const std::vector<bool> &AsVector() const { return BV; }
+  virtual const ASTBitVector &AsVector() const { return BV; }
 
   const ASTIdentifierNode *GetIdentifier() const override {
     return ASTExpressionNode::Ident;
@@ -415,7 +289,10 @@ public:
 
   virtual bool NeedsBitcast() const { return NBC; }
 
-  iterator begin() { return BV.begin(); }
+  iterator begin() {
+    SRV = false;
+    return BV.begin();
+  }
 
   const_iterator begin() const { return BV.begin(); }
 
@@ -425,6 +302,7 @@ public:
 
   reference operator[](unsigned Index) {
     assert(Index < BV.size() && "Index is out-of-range!");
+    SRV = false;
     return BV[Index];
   }
 
@@ -456,10 +334,7 @@ public:
     if (P) {
       std::cout << "<CBit>" << std::endl;
       Ident->print();
-      std::cout << "<Bitmask>";
-      for (ASTCBitNode::const_iterator I = BV.begin(); I != BV.end(); ++I)
-        std::cout << std::noboolalpha << *I;
-      std::cout << "</Bitmask>" << std::endl;
+      std::cout << "<Bitmask>" << AsString() << "</Bitmask>" << std::endl;
 
       if (QOP)
         QOP->print();
@@ -470,10 +345,7 @@ public:
 
     std::cout << "<CBit>" << std::endl;
     Ident->print();
-    std::cout << "<Bitmask>";
-    for (ASTCBitNode::const_iterator I = BV.begin(); I != BV.end(); ++I)
-      std::cout << std::noboolalpha << *I;
-    std::cout << "</Bitmask>" << std::endl;
+    std::cout << "<Bitmask>" << AsString() << "</Bitmask>" << std::endl;
 
     if (QOP)
       QOP->print();
@@ -195,6 +195,8 @@ public:
 
   virtual ASTType GetCastTo() const { return CastToType; }
 
+  virtual unsigned GetBits() const { return Bits; }
+
   virtual ASTTypeConversionMethod GetConversionMethod() const { return CM; }
 
   virtual bool IsBadCast() const {
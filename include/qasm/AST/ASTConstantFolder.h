@@ -0,0 +1,207 @@
+/* -*- coding: utf-8 -*-
+ *
+ * Copyright 2023 IBM RESEARCH. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#ifndef __QASM_AST_CONSTANT_FOLDER_H
+#define __QASM_AST_CONSTANT_FOLDER_H
+
+#include <qasm/AST/ASTAngleFixedPoint.h>
+#include <qasm/AST/ASTTypeEnums.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+namespace QASM {
+
+class ASTExpressionNode;
+class ASTBinaryOpNode;
+class ASTUnaryOpNode;
+class ASTCastExpressionNode;
+
+// The value of a folded constant expression.
+class ASTConstantValue {
+public:
+  enum Kind { None = 0, Bool, Int, UInt, Double };
+
+private:
+  Kind K;
+
+  union {
+    bool B;
+    int64_t I;
+    uint64_t U;
+    double D;
+  };
+
+public:
+  ASTConstantValue() : K(None), U(0) {}
+
+  explicit ASTConstantValue(bool V) : K(Bool), B(V) {}
+
+  explicit ASTConstantValue(int64_t V) : K(Int), I(V) {}
+
+  explicit ASTConstantValue(uint64_t V) : K(UInt), U(V) {}
+
+  explicit ASTConstantValue(double V) : K(Double), D(V) {}
+
+  ASTConstantValue(const ASTConstantValue &RHS) = default;
+  ASTConstantValue &operator=(const ASTConstantValue &RHS) = default;
+
+  ~ASTConstantValue() = default;
+
+  Kind GetKind() const { return K; }
+
+  bool IsValid() const { return K != None; }
+
+  bool IsBool() const { return K == Bool; }
+
+  bool IsIntegral() const { return K == Int || K == UInt; }
+
+  bool IsUnsigned() const { return K == UInt; }
+
+  bool IsDouble() const { return K == Double; }
+
+  bool GetBool() const { return B; }
+
+  int64_t GetInt() const { return I; }
+
+  uint64_t GetUInt() const { return U; }
+
+  double GetDouble() const { return D; }
+
+  bool AsBool() const {
+    switch (K) {
+    case Bool:
+      return B;
+      break;
+    case Int:
+      return I != 0;
+      break;
+    case UInt:
+      return U != 0;
+      break;
+    case Double:
+      return D != 0.0;
+      break;
+    default:
+      break;
+    }
+
+    return false;
+  }
+
+  double AsDouble() const {
+    switch (K) {
+    case Bool:
+      return B ? 1.0 : 0.0;
+      break;
+    case Int:
+      return static_cast<double>(I);
+      break;
+    case UInt:
+      return static_cast<double>(U);
+      break;
+    case Double:
+      return D;
+      break;
+    default:
+      break;
+    }
+
+    return 0.0;
+  }
+};
+
+// Bottom-up constant folding of expression trees.
+//
+// Evaluate() folds the constant subtrees of ASTBinaryOpNode,
+// ASTUnaryOpNode (which includes the builtin sin, cos, tan, arcsin,
+// arccos, arctan, exp, ln, sqrt and popcount) and ASTCastExpressionNode,
+// down to constant literals and the reserved constants pi, tau and
+// euler. Integer arithmetic is exact and overflow-checked; expressions
+// that overflow, divide by zero or produce a non-finite value from
+// finite operands are not folded.
+//
+// Every visited node is memoized, so that repeated traversals of the
+// same expression, and shared subtrees, are only evaluated once. Folded
+// operator nodes are marked constant-folded. The memo table holds raw
+// node addresses: it is cleared when a new parse starts, and when
+// ASTObjectTracker releases the AST.
+class ASTConstantFolder {
+private:
+  struct Entry {
+    ASTConstantValue V;
+    bool OK;
+  };
+
+  using map_type = std::unordered_map<const ASTExpressionNode *, Entry>;
+
+private:
+  static ASTConstantFolder CF;
+  map_type Memo;
+  std::size_t Hits;
+  std::size_t Misses;
+
+private:
+  bool EvaluateNode(const ASTExpressionNode *EN, ASTConstantValue &R);
+
+  bool EvaluateLeaf(const ASTExpressionNode *EN, ASTConstantValue &R);
+
+  bool EvaluateBinaryOp(const ASTBinaryOpNode *BOP, ASTConstantValue &R);
+
+  bool EvaluateUnaryOp(const ASTUnaryOpNode *UOP, ASTConstantValue &R);
+
+  bool EvaluateCast(const ASTCastExpressionNode *XOP, ASTConstantValue &R);
+
+protected:
+  ASTConstantFolder() : Memo(), Hits(0), Misses(0) {}
+
+public:
+  static ASTConstantFolder &Instance() { return CF; }
+
+  ~ASTConstantFolder() = default;
+
+  void Init() { Clear(); }
+
+  // Folds EN. Returns false if EN is not a constant expression.
+  bool Evaluate(const ASTExpressionNode *EN, ASTConstantValue &R);
+
+  // Folds EN and rounds the result to an angle[Bits].
+  bool EvaluateAngle(const ASTExpressionNode *EN, unsigned Bits,
+                     ASTAngleFixedPoint &R);
+
+  bool IsConstant(const ASTExpressionNode *EN) {
+    ASTConstantValue V;
+    return Evaluate(EN, V);
+  }
+
+  std::size_t GetHits() const { return Hits; }
+
+  std::size_t GetMisses() const { return Misses; }
+
+  std::size_t Size() const { return Memo.size(); }
+
+  void Clear() {
+    Memo.clear();
+    Hits = Misses = 0;
+  }
+};
+
+} // namespace QASM
+
+#endif // __QASM_AST_CONSTANT_FOLDER_H
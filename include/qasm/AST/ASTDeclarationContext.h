@@ -27,8 +27,10 @@
 #include <cstdio>
 #include <iomanip>
 #include <iostream>
+#include <iterator>
 #include <map>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace QASM {
@@ -41,11 +43,48 @@ private:
   mutable ASTType CTy;
   mutable ASTScopeState SCS;
   const ASTDeclarationContext *PCX;
+
+  // Symbol registrations are appended to a journal, which costs one
+  // vector append per node. The journal is replayed into STM only when
+  // the symbol map is queried. STX maps every symbol in the journal to
+  // its slot, so that registering a symbol twice keeps one entry, and
+  // unregistering it leaves a tombstone (a null X) in its slot. The
+  // journal is compacted when the tombstones outnumber the live entries.
+  struct JournalEntry {
+    const ASTBase *X;
+    ASTType Ty;
+  };
+
+  static const std::size_t MinCompactSize = 64U;
+
+  mutable std::vector<JournalEntry> STJ;
+  mutable std::unordered_map<const ASTBase *, std::size_t> STX;
   mutable std::map<const ASTBase *, ASTType> STM;
 
 private:
   ASTDeclarationContext() = delete;
 
+  void Replay() const {
+    for (const JournalEntry &E : STJ)
+      if (E.X)
+        STM.insert(std::make_pair(E.X, E.Ty));
+
+    STJ.clear();
+    STX.clear();
+  }
+
+  void Compact() const {
+    std::size_t J = 0;
+    for (std::size_t I = 0; I < STJ.size(); ++I) {
+      if (STJ[I].X) {
+        STX[STJ[I].X] = J;
+        STJ[J++] = STJ[I];
+      }
+    }
+
+    STJ.resize(J);
+  }
+
 public:
   using map_type = std::map<const ASTBase *, ASTType>;
   using iterator = typename map_type::iterator;
@@ -55,12 +94,12 @@ public:
   ASTDeclarationContext(const std::string &S, unsigned Idx,
                         const ASTDeclarationContext *Parent = nullptr)
       : ASTBase(), DCS(S), Hash(std::hash<std::string>{}(S)), IX(Idx),
-        CTy(ASTTypeUndefined), SCS(Alive), PCX(Parent), STM() {}
+        CTy(ASTTypeUndefined), SCS(Alive), PCX(Parent), STJ(), STX(), STM() {}
 
   ASTDeclarationContext(const std::string &S, unsigned Idx, ASTType CXTy,
                         const ASTDeclarationContext *Parent = nullptr)
       : ASTBase(), DCS(S), Hash(std::hash<std::string>{}(S)), IX(Idx),
-        CTy(CXTy), SCS(Alive), PCX(Parent), STM() {}
+        CTy(CXTy), SCS(Alive), PCX(Parent), STJ(), STX(), STM() {}
 
   virtual ~ASTDeclarationContext() = default;
 
@@ -76,26 +115,47 @@ public:
 
   const ASTDeclarationContext *GetParentContext() const { return PCX; }
 
-  bool RegisterSymbol(const ASTBase *X, ASTType Ty) {
+  // Like an insertion into STM, registering a symbol that is already
+  // registered keeps its first type.
+  void RegisterSymbol(const ASTBase *X, ASTType Ty) const {
     assert(X && "Invalid ASTBase argument!");
-    return STM.insert(std::make_pair(X, Ty)).second;
+    if (!STM.empty() && STM.count(X))
+      return;
+
+    if (STX.insert(std::make_pair(X, STJ.size())).second)
+      STJ.push_back({X, Ty});
   }
 
-  bool RegisterSymbol(const ASTBase *X, ASTType Ty) const {
-    assert(X && "Invalid ASTBase argument!");
-    return STM.insert(std::make_pair(X, Ty)).second;
+  // Unregistering a symbol that is not registered is a no-op.
+  void UnregisterSymbol(const ASTBase *X) const {
+    if (!STM.empty() && STM.erase(X))
+      return;
+
+    std::unordered_map<const ASTBase *, std::size_t>::iterator I = STX.find(X);
+    if (I == STX.end())
+      return;
+
+    STJ[(*I).second].X = nullptr;
+    STX.erase(I);
+
+    if (STJ.size() >= MinCompactSize && STJ.size() > 2 * STX.size())
+      Compact();
   }
 
-  void UnregisterSymbol(const ASTBase *X) { STM.erase(X); }
+  // The number of journal slots, tombstones included.
+  std::size_t GetJournalSize() const { return STJ.size(); }
 
-  void UnregisterSymbol(const ASTBase *X) const { STM.erase(X); }
+  // The number of symbols in the journal.
+  std::size_t GetJournalLiveSize() const { return STX.size(); }
 
   bool HasSymbol(const ASTBase *XS) const {
+    Replay();
     std::map<const ASTBase *, ASTType>::const_iterator I = STM.find(XS);
     return I != STM.end();
   }
 
   const std::map<const ASTBase *, ASTType> &GetSymbolTable() const {
+    Replay();
     return STM;
   }
 
@@ -122,13 +182,25 @@ public:
 
   bool IsAlive() const { return SCS == Alive; }
 
-  iterator begin() { return STM.begin(); }
+  iterator begin() {
+    Replay();
+    return STM.begin();
+  }
 
-  const_iterator begin() const { return STM.begin(); }
+  const_iterator begin() const {
+    Replay();
+    return STM.begin();
+  }
 
-  iterator end() { return STM.end(); }
+  iterator end() {
+    Replay();
+    return STM.end();
+  }
 
-  const_iterator end() const { return STM.end(); }
+  const_iterator end() const {
+    Replay();
+    return STM.end();
+  }
 
   virtual void print() const override {
     std::cout << "<DeclarationContext>" << std::endl;
@@ -194,6 +266,13 @@ public:
     }
   }
 
+  // Pops the contexts that a parse abandoned on an error left open, back
+  // to the global context.
+  void PopToGlobalContext() {
+    while (CCV.size() > 1)
+      PopCurrentContext();
+  }
+
   const ASTDeclarationContext *GetGlobalContext() const {
     assert(M.size() >= 1 && "Global Declaration Context is not initialized!");
     assert(CCV.size() >= 1 && "Global Declaration Context is not initialized!");
@@ -63,6 +63,8 @@ protected:
   std::string Grammar;
   std::string Name;
   bool IsCall;
+  // The declaration a defcal call was cloned from.
+  const ASTDefcalNode *Origin = nullptr;
 
 protected:
   static unsigned QIC;
@@ -163,6 +165,8 @@ public:
 
   virtual bool IsDefcalCall() const { return IsCall; }
 
+  virtual const ASTDefcalNode *GetResolvedDefcal() const { return Origin; }
+
   virtual bool HasResult() const {
     return OTy == ASTTypeMeasure && Measure && Measure->HasResult();
   }
@@ -198,6 +202,8 @@ public:
 
   virtual const ASTIdentifierList &GetQubitTargets() const { return QIL; }
 
+  virtual const ASTBoundQubitList *GetBoundQubits() const { return QTarget; }
+
   virtual const ASTExpressionNodeList &GetParameters() const { return Params; }
 
   virtual const ASTStatementList &GetStatements() const { return Statements; }
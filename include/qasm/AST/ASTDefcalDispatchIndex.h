@@ -0,0 +1,155 @@
+/* -*- coding: utf-8 -*-
+ *
+ * Copyright 2023 IBM RESEARCH. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#ifndef __QASM_AST_DEFCAL_DISPATCH_INDEX_H
+#define __QASM_AST_DEFCAL_DISPATCH_INDEX_H
+
+#include <qasm/AST/ASTTypeEnums.h>
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace QASM {
+
+class ASTAnyTypeList;
+class ASTArgumentNode;
+class ASTArgumentNodeList;
+class ASTDefcalNode;
+class ASTExpressionNode;
+class ASTSymbolTableEntry;
+
+// Defcal overload resolution index.
+//
+// Defcals are bucketed by defcal group name, then by the tuple of
+// physical qubits they are bound to, then by the tuple of the type
+// classes of their parameters (angle, integer, floating point, duration
+// or boolean). Every level is a hash table, so resolving a call does not
+// depend on the number of defcals declared.
+//
+// A qubit operand that is not a physical qubit ($N), and a parameter, or
+// an argument, whose type class is not known -- an untyped identifier or
+// an expression -- are recorded as wildcards. Resolution tries the qubit
+// tuples reachable from the call site from the most specific (all
+// physical qubits bound) to the least specific (all wildcards). Among
+// equally specific tuples, the one that binds the leftmost physical
+// qubit wins. For each qubit tuple, the parameter tuples are tried the
+// same way, from the types of the arguments down to all wildcards. If
+// none of them is declared, a parameter tuple the arguments convert to
+// (an integer to a floating point or an angle, a floating point to an
+// angle) is chosen, preferring the most exact matches.
+// Within a bucket, the most recently declared defcal wins.
+class ASTDefcalDispatchIndex {
+public:
+  using qubit_key = std::vector<uint32_t>;
+  using param_key = std::vector<uint32_t>;
+
+  static const uint32_t Wildcard = static_cast<uint32_t>(~0x0);
+
+  // The type classes of a param_key.
+  enum ParamClass : uint32_t {
+    ParamAngle = 0,
+    ParamInt,
+    ParamFloat,
+    ParamDuration,
+    ParamBool
+  };
+
+  // Beyond this many physical qubit operands, or typed arguments, only
+  // the exact and the all-wildcard tuples are tried.
+  static const unsigned MaxSpecializedQubits = 8U;
+
+private:
+  struct KeyHash {
+    std::size_t operator()(const std::vector<uint32_t> &K) const {
+      std::size_t H = K.size();
+      for (uint32_t Q : K)
+        H ^= std::hash<uint32_t>{}(Q) + 0x9e3779b9 + (H << 6) + (H >> 2);
+      return H;
+    }
+  };
+
+  using bucket_type = std::vector<const ASTSymbolTableEntry *>;
+  using param_map = std::unordered_map<param_key, bucket_type, KeyHash>;
+  using qubit_map = std::unordered_map<qubit_key, param_map, KeyHash>;
+  using group_map = std::unordered_map<std::string, qubit_map>;
+
+private:
+  static group_map DGM;
+  static std::size_t DSZ;
+  static ASTDefcalDispatchIndex DDI;
+
+protected:
+  ASTDefcalDispatchIndex() = default;
+
+  const ASTSymbolTableEntry *Find(const param_map &PM,
+                                  const param_key &PK) const;
+
+  const ASTSymbolTableEntry *FindConvertible(const param_map &PM,
+                                             const param_key &PK) const;
+
+public:
+  static ASTDefcalDispatchIndex &Instance() { return DDI; }
+
+  ~ASTDefcalDispatchIndex() = default;
+
+  static uint32_t PhysicalQubitIndex(const std::string &S);
+
+  static qubit_key MakeQubitKey(const ASTDefcalNode *DN);
+
+  static qubit_key MakeQubitKey(const ASTAnyTypeList &QL);
+
+  // The type class of an expression of type Ty, or Wildcard.
+  static uint32_t GetParamClass(ASTType Ty);
+
+  static uint32_t GetParamClass(const ASTExpressionNode *EN);
+
+  static uint32_t GetParamClass(const ASTArgumentNode *AN);
+
+  // Whether an argument of type class A can be passed to a parameter
+  // of type class P.
+  static bool IsConvertible(uint32_t A, uint32_t P);
+
+  static param_key MakeParamKey(const ASTDefcalNode *DN);
+
+  static param_key MakeParamKey(const ASTArgumentNodeList &AL);
+
+  bool Insert(const std::string &GN, const ASTSymbolTableEntry *STE);
+
+  const ASTSymbolTableEntry *Resolve(const std::string &GN,
+                                     const qubit_key &QK,
+                                     const param_key &PK) const;
+
+  const ASTSymbolTableEntry *Resolve(const std::string &GN,
+                                     const ASTArgumentNodeList &AL,
+                                     const ASTAnyTypeList &QL) const;
+
+  std::size_t Size() const { return DSZ; }
+
+  bool Empty() const { return DSZ == 0; }
+
+  void Clear() {
+    DGM.clear();
+    DSZ = 0;
+  }
+};
+
+} // namespace QASM
+
+#endif // __QASM_AST_DEFCAL_DISPATCH_INDEX_H
@@ -19,6 +19,7 @@
 #ifndef __QASM_AST_DURATION_NODE_H
 #define __QASM_AST_DURATION_NODE_H
 
+#include <qasm/AST/ASTDurationTicks.h>
 #include <qasm/AST/ASTTypes.h>
 
 #include <cassert>
@@ -174,21 +175,41 @@ private:
   const ASTBinaryOpNode *BOP;
   const ASTExpressionNode *EX;
 
+  // Duration in ticks of the ASTDurationTimeBase, valid if TV is set and
+  // TG matches the generation of the time base.
+  mutable int64_t Ticks;
+  mutable unsigned TG;
+  mutable bool TV;
+
 private:
   ASTDurationNode() = delete;
   void ParseDuration(const std::string &Unit);
   const char *ParseUnits() const;
 
+  void Normalize() const {
+    const ASTDurationTimeBase &TB = ASTDurationTimeBase::Instance();
+    TG = TB.GetGeneration();
+    TV = Duration != static_cast<uint64_t>(~0x0UL) &&
+         TB.ToTicks(Duration, Units, Ticks);
+  }
+
 protected:
   ASTDurationNode(const ASTIdentifierNode *Id, const std::string &ERM,
                   ASTType ETy)
       : ASTExpressionNode(Id, ASTExpressionNode::ExpressionError(Id, ERM), ETy),
         Duration(static_cast<uint64_t>(~0x0UL)), Units(LengthUnspecified),
-        DTy(ETy), LO(nullptr), BOP(nullptr), EX(nullptr) {}
+        DTy(ETy), LO(nullptr), BOP(nullptr), EX(nullptr), Ticks(0), TG(0),
+        TV(false) {}
 
-  virtual void SetLengthUnit(LengthUnit LU) { Units = LU; }
+  virtual void SetLengthUnit(LengthUnit LU) {
+    Units = LU;
+    Normalize();
+  }
 
-  virtual void SetDuration(uint64_t D) { Duration = D; }
+  virtual void SetDuration(uint64_t D) {
+    Duration = D;
+    Normalize();
+  }
 
 public:
   static const unsigned DurationBits = 64U;
@@ -197,28 +218,35 @@ public:
   ASTDurationNode(const ASTIdentifierNode *Id, const std::string &Unit)
       : ASTExpressionNode(Id, ASTTypeDuration),
         Duration(static_cast<uint64_t>(~0x0UL)), Units(LengthUnspecified),
-        DTy(ASTTypeDuration), LO(nullptr), BOP(nullptr), EX(nullptr) {
+        DTy(ASTTypeDuration), LO(nullptr), BOP(nullptr), EX(nullptr),
+        Ticks(0), TG(0), TV(false) {
     ParseDuration(Unit);
+    Normalize();
   }
 
   ASTDurationNode(const ASTIdentifierNode *Id, uint64_t D, LengthUnit U)
       : ASTExpressionNode(Id, ASTTypeDuration), Duration(D), Units(U),
-        DTy(ASTTypeDuration), LO(nullptr), BOP(nullptr), EX(nullptr) {}
+        DTy(ASTTypeDuration), LO(nullptr), BOP(nullptr), EX(nullptr),
+        Ticks(0), TG(0), TV(false) {
+    Normalize();
+  }
 
   ASTDurationNode(const ASTIdentifierNode *Id, const ASTDurationOfNode *LON)
       : ASTExpressionNode(Id, ASTTypeDuration), Duration(0UL),
         Units(LengthOfDependent), DTy(LON->GetASTType()), LO(LON),
-        BOP(nullptr) {}
+        BOP(nullptr), EX(nullptr), Ticks(0), TG(0), TV(false) {}
 
   ASTDurationNode(const ASTIdentifierNode *Id, const ASTBinaryOpNode *BOp)
       : ASTExpressionNode(Id, ASTTypeDuration),
         Duration(static_cast<uint64_t>(~0x0UL)), Units(BinaryOpDependent),
-        DTy(BOp->GetASTType()), LO(nullptr), BOP(BOp), EX(nullptr) {}
+        DTy(BOp->GetASTType()), LO(nullptr), BOP(BOp), EX(nullptr),
+        Ticks(0), TG(0), TV(false) {}
 
   ASTDurationNode(const ASTIdentifierNode *Id, const ASTExpressionNode *EXP)
       : ASTExpressionNode(Id, ASTTypeDuration),
         Duration(static_cast<uint64_t>(~0x0UL)), Units(FunctionCallDependent),
-        DTy(EXP->GetASTType()), LO(nullptr), BOP(nullptr), EX(EXP) {}
+        DTy(EXP->GetASTType()), LO(nullptr), BOP(nullptr), EX(EXP),
+        Ticks(0), TG(0), TV(false) {}
 
   virtual ~ASTDurationNode() = default;
 
@@ -248,6 +276,25 @@ public:
 
   virtual ASTType GetDurationType() const { return DTy; }
 
+  // Sets T to the duration in ticks of the ASTDurationTimeBase. Fails if
+  // the duration is not a constant, is expressed in dt and no dt is set,
+  // or does not fit in 64 bits.
+  bool GetTicks(int64_t &T) const {
+    if (TG != ASTDurationTimeBase::Instance().GetGeneration())
+      Normalize();
+
+    if (!TV)
+      return false;
+
+    T = Ticks;
+    return true;
+  }
+
+  bool HasTicks() const {
+    int64_t T;
+    return GetTicks(T);
+  }
+
   virtual bool IsDurationOf() const { return DTy == ASTTypeDurationOf; }
 
   virtual bool IsDuration() const { return DTy == ASTTypeDuration; }
@@ -312,6 +359,11 @@ public:
     std::cout << "<Duration>" << Duration << "</Duration>" << std::endl;
     std::cout << "<LengthUnit>" << PrintLengthUnit(Units) << "</LengthUnit>"
               << std::endl;
+
+    int64_t T;
+    if (GetTicks(T))
+      std::cout << "<Ticks>" << T << "</Ticks>" << std::endl;
+
     std::cout << "</Duration>" << std::endl;
   }
 
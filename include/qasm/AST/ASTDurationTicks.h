@@ -0,0 +1,146 @@
+/* -*- coding: utf-8 -*-
+ *
+ * Copyright 2023 IBM RESEARCH. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#ifndef __QASM_AST_DURATION_TICKS_H
+#define __QASM_AST_DURATION_TICKS_H
+
+#include <qasm/AST/ASTTypeEnums.h>
+
+#include <cstdint>
+#include <limits>
+#include <string>
+
+namespace QASM {
+
+// Exact integer arithmetic on durations.
+//
+// The device dt is kept as a reduced rational P / Q nanoseconds. A tick
+// is 1 / Q nanoseconds, so that 1ns is Q ticks and 1dt is P ticks, and
+// every duration expressed in ns, us, ms, s or dt is a whole number of
+// ticks. Until a dt is set, a tick is one nanosecond and durations
+// expressed in dt cannot be converted.
+//
+// Every change of dt bumps the generation, which invalidates the tick
+// counts cached by the ASTDurationNodes.
+class ASTDurationTimeBase {
+private:
+  static ASTDurationTimeBase TB;
+
+  uint64_t P;
+  uint64_t Q;
+  unsigned Gen;
+
+protected:
+  constexpr ASTDurationTimeBase() : P(0), Q(1), Gen(1) {}
+
+public:
+  static ASTDurationTimeBase &Instance() { return TB; }
+
+  ~ASTDurationTimeBase() = default;
+
+  // Sets dt to Num / Den nanoseconds. Fails if the value is zero, or if
+  // one second cannot be represented in ticks.
+  bool SetDT(uint64_t Num, uint64_t Den);
+
+  // Sets dt from a string of the form <value>[<unit>], where <value> is
+  // a decimal number (e.g. "0.222") or a fraction (e.g. "2/9") and
+  // <unit> is one of ns (the default), us, ms or s.
+  bool SetDT(const std::string &S);
+
+  void ResetDT() {
+    P = 0;
+    Q = 1;
+    ++Gen;
+  }
+
+  bool HasDT() const { return P != 0; }
+
+  uint64_t GetDTNumerator() const { return P; }
+
+  uint64_t GetDTDenominator() const { return Q; }
+
+  unsigned GetGeneration() const { return Gen; }
+
+  // Returns the number of ticks in one U, or zero if U has no fixed
+  // length in the current time base.
+  uint64_t TicksPerUnit(LengthUnit U) const;
+
+  // Converts D units of U to ticks. Fails if U cannot be converted, or
+  // on overflow.
+  bool ToTicks(uint64_t D, LengthUnit U, int64_t &T) const;
+};
+
+// Overflow-checked tick arithmetic. On overflow, R is left unchanged
+// and false is returned.
+class ASTDurationTicks {
+public:
+  static bool Add(int64_t A, int64_t B, int64_t &R) {
+#if defined(__GNUC__) || defined(__clang__)
+    int64_t S;
+    if (__builtin_add_overflow(A, B, &S))
+      return false;
+    R = S;
+    return true;
+#else
+    if ((B > 0 && A > std::numeric_limits<int64_t>::max() - B) ||
+        (B < 0 && A < std::numeric_limits<int64_t>::min() - B))
+      return false;
+    R = A + B;
+    return true;
+#endif
+  }
+
+  static bool Sub(int64_t A, int64_t B, int64_t &R) {
+#if defined(__GNUC__) || defined(__clang__)
+    int64_t S;
+    if (__builtin_sub_overflow(A, B, &S))
+      return false;
+    R = S;
+    return true;
+#else
+    if ((B < 0 && A > std::numeric_limits<int64_t>::max() + B) ||
+        (B > 0 && A < std::numeric_limits<int64_t>::min() + B))
+      return false;
+    R = A - B;
+    return true;
+#endif
+  }
+
+  static bool Scale(int64_t A, int64_t K, int64_t &R) {
+#if defined(__GNUC__) || defined(__clang__)
+    int64_t S;
+    if (__builtin_mul_overflow(A, K, &S))
+      return false;
+    R = S;
+    return true;
+#else
+    const int64_t Max = std::numeric_limits<int64_t>::max();
+    const int64_t Min = std::numeric_limits<int64_t>::min();
+
+    if (A > 0 ? (K > 0 ? A > Max / K : K < Min / A)
+              : (K > 0 ? A < Min / K : (A != 0 && K < Max / A)))
+      return false;
+    R = A * K;
+    return true;
+#endif
+  }
+};
+
+} // namespace QASM
+
+#endif // __QASM_AST_DURATION_TICKS_H
@@ -24,16 +24,36 @@
 #include <qasm/AST/ASTTypes.h>
 
 #include <cstdlib>
+#include <functional>
 #include <map>
+#include <unordered_map>
+#include <vector>
 
 namespace QASM {
 
 class ASTExpressionEvaluator {
+private:
+  using cache_type = std::unordered_map<const ASTExpressionNode *, ASTType>;
+
 private:
   static ASTExpressionEvaluator EXE;
   static std::map<ASTType, unsigned> RM;
   static std::map<unsigned, ASTType> TM;
 
+  // Result types of the binary and unary operations evaluated so far.
+  // Mixed angle arithmetic depends on the angle context, so there is
+  // one cache for each state of the context.
+  mutable cache_type TC[2];
+
+private:
+  ASTType ComputeType(const ASTBinaryOpNode *BOp) const;
+
+  ASTType ComputeType(const ASTUnaryOpNode *UOp) const;
+
+  cache_type &GetTypeCache() const;
+
+  void ResolveOperations(const ASTExpressionNode *E) const;
+
 protected:
   ASTExpressionEvaluator() = default;
 
@@ -44,6 +64,28 @@ public:
 
   void Init();
 
+  void ClearCache() {
+    TC[0].clear();
+    TC[1].clear();
+  }
+
+  // Returns the ASTBinaryOpNode or ASTUnaryOpNode that E is, or wraps in
+  // operator and operand nodes, or nullptr.
+  static const ASTExpressionNode *GetOperation(const ASTExpressionNode *E);
+
+  // Appends to PO the binary and unary operations of the tree rooted at
+  // E, E included, children before parents. The subtrees of operations
+  // for which Known returns true are skipped. Unless LookThrough is set,
+  // only operands that are themselves operations are followed, and not
+  // those wrapped in operator and operand nodes. The traversal uses an
+  // explicit stack, so that deep trees (e.g. long left-deep chains of
+  // additions) do not exhaust the call stack.
+  static void
+  CollectOperations(const ASTExpressionNode *E,
+                    const std::function<bool(const ASTExpressionNode *)> &Known,
+                    std::vector<const ASTExpressionNode *> &PO,
+                    bool LookThrough = true);
+
   unsigned GetRank(ASTType Ty) const {
     std::map<ASTType, unsigned>::const_iterator RI = RM.find(Ty);
     return RI == RM.end() ? static_cast<unsigned>(~0x0) : (*RI).second;
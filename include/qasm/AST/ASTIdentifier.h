@@ -21,6 +21,7 @@
 
 #include <qasm/AST/ASTDeclarationContext.h>
 #include <qasm/AST/ASTExpression.h>
+#include <qasm/AST/ASTStringUtils.h>
 
 #include <functional>
 #include <list>
@@ -52,6 +53,12 @@ protected:
   mutable std::map<unsigned, const ASTIdentifierRefNode *> References;
   mutable unsigned Bits;
   unsigned NumericIndex;
+  // The structure of Name, computed once by ParseName().
+  std::string BaseName;
+  std::string ReservedBase;
+  unsigned NameIndex;
+  ASTReservedSuffix RSX;
+  bool NameIndexed;
   mutable bool Indexed;
   mutable bool NoQubit;
   mutable bool GateLocal;
@@ -77,6 +84,10 @@ protected:
 
   static uint64_t SI;
 
+  // Bumped every time the type of a symbol is changed after the fact, so
+  // that the types cached by the operations on it are recomputed.
+  static unsigned TG;
+
 private:
   ASTIdentifierNode() = delete;
 
@@ -95,6 +106,24 @@ private:
       NumericIndex = static_cast<unsigned>(std::stoul(IX));
   }
 
+  void ParseName() {
+    const ASTStringUtils &SU = ASTStringUtils::Instance();
+    std::string::size_type LB = Name.find_last_of('[');
+    std::string::size_type RB = Name.find_last_of(']');
+    if (LB != std::string::npos && RB != std::string::npos) {
+      SetIndexed(true);
+      SetIndexIdentifier(LB, RB);
+      SetNumericIndex(LB, RB);
+      NameIndexed = true;
+      BaseName = SU.GetIdentifierBase(Name);
+    }
+
+    NameIndex = SU.ParseIdentifierIndex(Name);
+    RSX = SU.GetReservedSuffixKind(Name);
+    if (RSX != ReservedSuffixNone)
+      ReservedBase = SU.GetReservedBase(Name);
+  }
+
 public:
   static const unsigned IdentifierBits = 64U;
 
@@ -103,7 +132,9 @@ public:
       : ASTExpression(), Name(Id), MangledName(), PolymorphicName(Id),
         MangledLiteralName(), IndexIdentifier(), Hash(0UL), MHash(0UL),
         MLHash(0UL), References(), Bits(B),
-        NumericIndex(static_cast<unsigned>(~0x0)), Indexed(false),
+        NumericIndex(static_cast<unsigned>(~0x0)), BaseName(), ReservedBase(),
+        NameIndex(static_cast<unsigned>(~0x0)), RSX(ReservedSuffixNone),
+        NameIndexed(false), Indexed(false),
         NoQubit(false), GateLocal(false), ComplexPart(false), HasSTE(false),
         RV(nullptr), BOP(nullptr), EXP(nullptr), STE(nullptr),
         CTX(ASTDeclarationContextTracker::Instance().GetCurrentContext()),
@@ -112,20 +143,16 @@ public:
         SymScope(ASTDeclarationContextTracker::Instance().GetCurrentScope()),
         RD(false), IV(false), PRD(nullptr) {
     CTX->RegisterSymbol(this, GetASTType());
-    std::string::size_type LB = Id.find_last_of('[');
-    std::string::size_type RB = Id.find_last_of(']');
-    if (LB != std::string::npos && RB != std::string::npos) {
-      SetIndexed(true);
-      SetIndexIdentifier(LB, RB);
-      SetNumericIndex(LB, RB);
-    }
+    ParseName();
   }
 
   ASTIdentifierNode(const std::string &Id, ASTType STy, unsigned B = ~0x0)
       : ASTExpression(), Name(Id), MangledName(), PolymorphicName(Id),
         MangledLiteralName(), IndexIdentifier(), Hash(0UL), MHash(0UL),
         MLHash(0UL), References(), Bits(B),
-        NumericIndex(static_cast<unsigned>(~0x0)), Indexed(false),
+        NumericIndex(static_cast<unsigned>(~0x0)), BaseName(), ReservedBase(),
+        NameIndex(static_cast<unsigned>(~0x0)), RSX(ReservedSuffixNone),
+        NameIndexed(false), Indexed(false),
         NoQubit(false), GateLocal(false), ComplexPart(false), HasSTE(false),
         RV(nullptr), BOP(nullptr), EXP(nullptr), STE(nullptr),
         CTX(ASTDeclarationContextTracker::Instance().GetCurrentContext()),
@@ -134,13 +161,7 @@ public:
         SymScope(ASTDeclarationContextTracker::Instance().GetCurrentScope()),
         RD(false), IV(false), PRD(nullptr) {
     CTX->RegisterSymbol(this, GetASTType());
-    std::string::size_type LB = Id.find_last_of('[');
-    std::string::size_type RB = Id.find_last_of(']');
-    if (LB != std::string::npos && RB != std::string::npos) {
-      SetIndexed(true);
-      SetIndexIdentifier(LB, RB);
-      SetNumericIndex(LB, RB);
-    }
+    ParseName();
   }
 
   ASTIdentifierNode(const std::string &Id, const ASTBinaryOpNode *BOp,
@@ -213,6 +234,8 @@ public:
 
   virtual void RestoreType();
 
+  static unsigned GetTypeGeneration() { return TG; }
+
   virtual void SetInductionVariable(bool V) { IV = V; }
 
   virtual void SetInductionVariable(bool V) const { IV = V; }
@@ -402,6 +425,25 @@ public:
 
   virtual bool IsIndexed() const { return Indexed; }
 
+  // True if Name has an index subscript, e.g. 'q[3]'. IsIndexed() is also
+  // true for identifiers that are the result of an indexing operation.
+  bool HasIndexedName() const { return NameIndexed; }
+
+  // Name without its index subscript and leading '%'.
+  const std::string &GetBaseName() const {
+    return NameIndexed ? BaseName : Name;
+  }
+
+  // The numeric index in Name ('q[3]', '%q:3'), or ~0x0.
+  unsigned GetNameIndex() const { return NameIndex; }
+
+  ASTReservedSuffix GetReservedSuffixKind() const { return RSX; }
+
+  bool HasReservedSuffix() const { return RSX != ReservedSuffixNone; }
+
+  // Name without its reserved suffix, e.g. 'f' for 'f.phase'.
+  const std::string &GetReservedBase() const { return ReservedBase; }
+
   virtual bool HasInvalidBitWidth() const {
     return Bits == 0 || Bits == static_cast<unsigned>(~0x0);
   }
@@ -748,6 +790,8 @@ public:
         ASN(nullptr), ASL(nullptr), IVX(), Index(static_cast<unsigned>(~0x0)),
         RTy(ASTTypeUndefined), IITy(ASTEXTypeSSA), ULV(LV) {
     this->CTX->UnregisterSymbol(IDN);
+    // The reference moves to the context of the identifier it refers to.
+    this->CTX->UnregisterSymbol(this);
     this->CTX = IDN->GetDeclarationContext();
     this->CTX->RegisterSymbol(this, GetASTType());
     SetIndex(IDN->GetName());
@@ -769,6 +813,7 @@ public:
         ASN(nullptr), ASL(nullptr), IVX(), Index(static_cast<unsigned>(~0x0)),
         RTy(ASTTypeUndefined), IITy(ASTEXTypeSSA), ULV(LV) {
     this->CTX->UnregisterSymbol(IDN);
+    this->CTX->UnregisterSymbol(this);
     this->CTX = IDN->GetDeclarationContext();
     this->CTX->RegisterSymbol(this, GetASTType());
     SetIndex(ID);
@@ -792,6 +837,7 @@ public:
         IVX(), Index(static_cast<unsigned>(~0x0)), RTy(ASTTypeUndefined),
         IITy(ASTEXTypeSSA), ULV(LV) {
     this->CTX->UnregisterSymbol(IDN);
+    this->CTX->UnregisterSymbol(this);
     this->CTX = IDN->GetDeclarationContext();
     this->CTX->RegisterSymbol(this, GetASTType());
     SetIndex(ID);
@@ -0,0 +1,186 @@
+/* -*- coding: utf-8 -*-
+ *
+ * Copyright 2023 IBM RESEARCH. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#ifndef __QASM_AST_INSTRUMENTATION_H
+#define __QASM_AST_INSTRUMENTATION_H
+
+#include <qasm/AST/ASTTypeEnums.h>
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <map>
+
+namespace QASM {
+
+// Phase timers and event counters of the parser.
+//
+// The instrumentation points are only compiled in when the library is
+// built with OPENQASM_INSTRUMENTATION defined (the CMake option of the
+// same name). Otherwise the QASM_INSTR_* macros expand to nothing and
+// every query returns zero.
+//
+// Phases nest: Parse includes Scan and everything the grammar actions
+// do, such as symbol table operations, mangling and gate clones. A phase
+// that is entered again while it is open, such as an Insert that calls
+// another Insert, or a mangler created while another one is live, is
+// timed and counted once.
+//
+// The results are reset when ASTParser::ParseAST starts, and can be
+// queried after it returns. The node counts by ASTType are taken at the
+// end of ParseAST from the ASTObjectTracker, and are only available if
+// the tracker is enabled. Release is recorded when
+// ASTObjectTracker::Release runs.
+class ASTInstrumentation {
+public:
+  enum Phase : unsigned {
+    Preprocess = 0,
+    IncludeResolution,
+    Scan,
+    Parse,
+    TypeSystemInit,
+    Mangle,
+    SymbolInsert,
+    SymbolLookup,
+    GateClone,
+    Release,
+    NumPhases
+  };
+
+  enum Counter : unsigned { Tokens = 0, Chars, Lines, Nodes, NumCounters };
+
+private:
+  using clock_type = std::chrono::steady_clock;
+
+private:
+  static ASTInstrumentation AI;
+
+  uint64_t Nanos[NumPhases];
+  uint64_t Calls[NumPhases];
+  unsigned Depth[NumPhases];
+  clock_type::time_point Start[NumPhases];
+  uint64_t Counters[NumCounters];
+  std::map<ASTType, uint64_t> NM;
+
+protected:
+  ASTInstrumentation() : NM() { Clear(); }
+
+public:
+  static ASTInstrumentation &Instance() { return AI; }
+
+  ~ASTInstrumentation() = default;
+
+  static constexpr bool IsEnabled() {
+#if defined(OPENQASM_INSTRUMENTATION)
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  static const char *PhaseName(Phase P);
+
+  static const char *CounterName(Counter C);
+
+  void Enter(Phase P) {
+    if (Depth[P]++ == 0) {
+      ++Calls[P];
+      Start[P] = clock_type::now();
+    }
+  }
+
+  void Leave(Phase P) {
+    if (Depth[P] && --Depth[P] == 0)
+      Nanos[P] += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      clock_type::now() - Start[P])
+                      .count();
+  }
+
+  void Count(Counter C, uint64_t N = 1) { Counters[C] += N; }
+
+  uint64_t GetNanoseconds(Phase P) const { return Nanos[P]; }
+
+  double GetMilliseconds(Phase P) const {
+    return static_cast<double>(Nanos[P]) / 1.0e6;
+  }
+
+  uint64_t GetCalls(Phase P) const { return Calls[P]; }
+
+  uint64_t GetCounter(Counter C) const { return Counters[C]; }
+
+  uint64_t GetNodeCount(ASTType Ty) const {
+    std::map<ASTType, uint64_t>::const_iterator I = NM.find(Ty);
+    return I == NM.end() ? 0 : (*I).second;
+  }
+
+  const std::map<ASTType, uint64_t> &GetNodeCounts() const { return NM; }
+
+  // Counts the live nodes registered with the ASTObjectTracker, by
+  // ASTType.
+  void CountNodes();
+
+  void Clear();
+
+  void PrintJSON(std::ostream &OS = std::cout) const;
+};
+
+// Times a phase for the lifetime of the object.
+class ASTInstrumentationScope {
+private:
+  ASTInstrumentation::Phase P;
+
+public:
+  explicit ASTInstrumentationScope(ASTInstrumentation::Phase PH) : P(PH) {
+    ASTInstrumentation::Instance().Enter(P);
+  }
+
+  ASTInstrumentationScope(const ASTInstrumentationScope &RHS) = delete;
+  ASTInstrumentationScope &
+  operator=(const ASTInstrumentationScope &RHS) = delete;
+
+  ~ASTInstrumentationScope() { ASTInstrumentation::Instance().Leave(P); }
+};
+
+} // namespace QASM
+
+#if defined(OPENQASM_INSTRUMENTATION)
+#define QASM_INSTR_CONCAT_(A, B) A##B
+#define QASM_INSTR_CONCAT(A, B) QASM_INSTR_CONCAT_(A, B)
+#define QASM_INSTR_SCOPE(P)                                                   \
+  ::QASM::ASTInstrumentationScope QASM_INSTR_CONCAT(QIS, __LINE__)(          \
+      ::QASM::ASTInstrumentation::P)
+#define QASM_INSTR_ENTER(P)                                                   \
+  ::QASM::ASTInstrumentation::Instance().Enter(::QASM::ASTInstrumentation::P)
+#define QASM_INSTR_LEAVE(P)                                                   \
+  ::QASM::ASTInstrumentation::Instance().Leave(::QASM::ASTInstrumentation::P)
+#define QASM_INSTR_COUNT(C, N)                                                \
+  ::QASM::ASTInstrumentation::Instance().Count(::QASM::ASTInstrumentation::C, \
+                                               (N))
+#define QASM_INSTR_CLEAR() ::QASM::ASTInstrumentation::Instance().Clear()
+#define QASM_INSTR_COUNT_NODES()                                              \
+  ::QASM::ASTInstrumentation::Instance().CountNodes()
+#else
+#define QASM_INSTR_SCOPE(P) static_cast<void>(0)
+#define QASM_INSTR_ENTER(P) static_cast<void>(0)
+#define QASM_INSTR_LEAVE(P) static_cast<void>(0)
+#define QASM_INSTR_COUNT(C, N) static_cast<void>(0)
+#define QASM_INSTR_CLEAR() static_cast<void>(0)
+#define QASM_INSTR_COUNT_NODES() static_cast<void>(0)
+#endif
+
+#endif // __QASM_AST_INSTRUMENTATION_H
@@ -0,0 +1,127 @@
+/* -*- coding: utf-8 -*-
+ *
+ * Copyright 2023 IBM RESEARCH. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#ifndef __QASM_AST_LITERAL_POOL_H
+#define __QASM_AST_LITERAL_POOL_H
+
+#include <qasm/AST/ASTTypeEnums.h>
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <unordered_map>
+
+namespace QASM {
+
+class ASTDeclarationContext;
+class ASTExpressionNode;
+
+// Per-parse pool of constant literal nodes.
+//
+// Once enabled, the integer, floating-point and boolean literals of the
+// grammar are looked up by (type, width, declaration context, spelling)
+// before a node is created, and identical literals share one node, one
+// ASTIdentifierNode and one Symbol Table entry. The shared node keeps the
+// location of the first occurrence.
+//
+// Pooled nodes are constant-folded and are never modified after they are
+// created: declarations, casts and conversions copy the literal value
+// into a node of their own. The pool is cleared when a new parse starts,
+// and when ASTObjectTracker releases the AST.
+class ASTLiteralPool {
+private:
+  struct Key {
+    ASTType Ty;
+    unsigned Bits;
+    const ASTDeclarationContext *CTX;
+    std::string S;
+
+    bool operator==(const Key &RHS) const {
+      return Ty == RHS.Ty && Bits == RHS.Bits && CTX == RHS.CTX && S == RHS.S;
+    }
+  };
+
+  struct KeyHash {
+    std::size_t operator()(const Key &K) const {
+      std::size_t R = std::hash<std::string>()(K.S);
+      R ^= std::hash<const void *>()(K.CTX) + 0x9e3779b9 + (R << 6) + (R >> 2);
+      R ^= (static_cast<std::size_t>(K.Ty) << 16) ^ K.Bits;
+      return R;
+    }
+  };
+
+  using map_type = std::unordered_map<Key, ASTExpressionNode *, KeyHash>;
+
+private:
+  static ASTLiteralPool LP;
+  map_type Map;
+  std::size_t Hits;
+  std::size_t Misses;
+  bool Enabled;
+
+protected:
+  ASTLiteralPool() : Map(), Hits(0), Misses(0), Enabled(false) {}
+
+public:
+  static ASTLiteralPool &Instance() { return LP; }
+
+  ~ASTLiteralPool() = default;
+
+  void Enable(bool V = true) { Enabled = V; }
+
+  bool IsEnabled() const { return Enabled; }
+
+  // Returns the pooled node for the literal, or nullptr if the pool is
+  // disabled or the literal has not been seen yet.
+  template <typename __Type>
+  __Type *Find(ASTType Ty, unsigned Bits, const ASTDeclarationContext *CTX,
+               const std::string &S) {
+    if (!Enabled)
+      return nullptr;
+
+    map_type::const_iterator I = Map.find(Key{Ty, Bits, CTX, S});
+    if (I == Map.end()) {
+      ++Misses;
+      return nullptr;
+    }
+
+    ++Hits;
+    return static_cast<__Type *>((*I).second);
+  }
+
+  void Insert(ASTType Ty, unsigned Bits, const ASTDeclarationContext *CTX,
+              const std::string &S, ASTExpressionNode *EN) {
+    if (Enabled && EN)
+      Map.emplace(Key{Ty, Bits, CTX, S}, EN);
+  }
+
+  std::size_t GetHits() const { return Hits; }
+
+  std::size_t GetMisses() const { return Misses; }
+
+  std::size_t Size() const { return Map.size(); }
+
+  void Clear() {
+    Map.clear();
+    Hits = Misses = 0;
+  }
+};
+
+} // namespace QASM
+
+#endif // __QASM_AST_LITERAL_POOL_H
@@ -41,6 +41,7 @@ private:
   };
 
   ASTType RType;
+  bool OC;
 
 private:
   ASTMPComplexRep() = delete;
@@ -50,31 +51,31 @@ protected:
 
 public:
   explicit ASTMPComplexRep(ASTMPComplexNode *X)
-      : MPC(X), Void(nullptr), RType(X->GetASTType()) {}
+      : MPC(X), Void(nullptr), RType(X->GetASTType()), OC(false) {}
 
   explicit ASTMPComplexRep(const ASTBinaryOpNode *X)
-      : MPC(nullptr), BOP(X), RType(X->GetASTType()) {}
+      : MPC(nullptr), BOP(X), RType(X->GetASTType()), OC(false) {}
 
   explicit ASTMPComplexRep(const ASTBinaryOpNode *X, ASTMPComplexNode *CX)
-      : MPC(CX), BOP(X), RType(X->GetASTType()) {}
+      : MPC(CX), BOP(X), RType(X->GetASTType()), OC(false) {}
 
   explicit ASTMPComplexRep(const ASTUnaryOpNode *X)
-      : MPC(nullptr), UOP(X), RType(X->GetASTType()) {}
+      : MPC(nullptr), UOP(X), RType(X->GetASTType()), OC(false) {}
 
   explicit ASTMPComplexRep(const ASTUnaryOpNode *X, ASTMPComplexNode *CX)
-      : MPC(CX), UOP(X), RType(X->GetASTType()) {}
+      : MPC(CX), UOP(X), RType(X->GetASTType()), OC(false) {}
 
   explicit ASTMPComplexRep(const ASTIdentifierNode *X)
-      : MPC(nullptr), ID(X), RType(X->GetASTType()) {}
+      : MPC(nullptr), ID(X), RType(X->GetASTType()), OC(false) {}
 
   explicit ASTMPComplexRep(const ASTIdentifierNode *X, ASTMPComplexNode *CX)
-      : MPC(CX), ID(X), RType(X->GetASTType()) {}
+      : MPC(CX), ID(X), RType(X->GetASTType()), OC(false) {}
 
   explicit ASTMPComplexRep(const ASTIdentifierRefNode *X)
-      : MPC(nullptr), IDR(X), RType(X->GetASTType()) {}
+      : MPC(nullptr), IDR(X), RType(X->GetASTType()), OC(false) {}
 
   explicit ASTMPComplexRep(const ASTIdentifierRefNode *X, ASTMPComplexNode *CX)
-      : MPC(CX), IDR(X), RType(X->GetASTType()) {}
+      : MPC(CX), IDR(X), RType(X->GetASTType()), OC(false) {}
 
   virtual ~ASTMPComplexRep() = default;
 
@@ -84,6 +85,12 @@ public:
 
   virtual const ASTMPComplexNode *GetComplex() const { return MPC; }
 
+  // True if the ASTMPComplexNode was created for this sample, and is
+  // not shared with a declaration or with the symbol table.
+  virtual bool OwnsComplex() const { return OC; }
+
+  virtual void SetOwnsComplex(bool V) { OC = V; }
+
   virtual const ASTBinaryOpNode *GetBinaryOp() const {
     return RType == ASTTypeBinaryOp ? BOP : nullptr;
   }
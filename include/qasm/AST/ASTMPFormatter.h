@@ -0,0 +1,52 @@
+/* -*- coding: utf-8 -*-
+ *
+ * Copyright 2023 IBM RESEARCH. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#ifndef __QASM_AST_MP_FORMATTER_H
+#define __QASM_AST_MP_FORMATTER_H
+
+#include <gmp.h>
+#include <mpfr.h>
+
+#include <cstddef>
+#include <string>
+
+namespace QASM {
+
+// Formats MPFR values in the canonical positional form of the AST
+// (e.g. "3.14159", "-0.5", "12.0", "NaN", "Inf").
+//
+// The significand digits are the ones mpfr_get_str returns for n = 0,
+// i.e. enough digits to round-trip at the value's precision. Values
+// with no integral digits keep at most 8, 16, 32 or 34 significant
+// digits, depending on the bit width of the node. Trailing zeros and
+// trailing rounding noise are trimmed as by
+// ASTStringUtils::RemoveTrailingZeros.
+class ASTMPFormatter {
+public:
+  // Writes the formatted value of MPV and a terminating NUL into Buf,
+  // and returns its length. If Buf is too small, nothing is written and
+  // the return value is not less than Size.
+  static std::size_t Format(char *Buf, std::size_t Size, const mpfr_t &MPV,
+                            int Base, unsigned Bits);
+
+  static std::string ToString(const mpfr_t &MPV, int Base, unsigned Bits);
+};
+
+} // namespace QASM
+
+#endif // __QASM_AST_MP_FORMATTER_H
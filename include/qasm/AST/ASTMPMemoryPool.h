@@ -0,0 +1,140 @@
+/* -*- coding: utf-8 -*-
+ *
+ * Copyright 2023 IBM RESEARCH. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#ifndef __QASM_AST_MP_MEMORY_POOL_H
+#define __QASM_AST_MP_MEMORY_POOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_set>
+
+namespace QASM {
+
+// Limb storage allocator for GMP, MPFR and MPC.
+//
+// Once enabled, it is installed with mp_set_memory_functions, so every
+// mpz_t, mpfr_t and mpc_t allocates its limbs from here. Small blocks
+// are served from power-of-two size classes. Each size class owns a set
+// of ChunkSize-aligned chunks, and freed blocks go back to the free list
+// of their size class. Blocks larger than MaxBlockSize, and blocks that
+// were allocated before the pool was installed, are handed to the C
+// library allocator, which is what GMP uses by default.
+//
+// The chunks are grouped in epochs. Release() ends the current epoch:
+// the chunks of the epoch that have no block in use are returned to the
+// system, and the others are retired. A retired chunk serves no new
+// block, and is returned to the system as soon as its last block is
+// freed. Blocks that outlive a release, such as the limbs of the
+// builtin constants, only hold on to their own chunks.
+class ASTMPMemoryPool {
+public:
+  static const std::size_t ChunkSize = 65536U;
+  static const std::size_t MinBlockSize = 16U;
+  static const std::size_t MaxBlockSize = 4096U;
+  static const unsigned NumClasses = 9U;
+
+private:
+  struct FreeBlock {
+    FreeBlock *Next;
+  };
+
+  // At the start of every chunk.
+  struct ChunkHeader {
+    unsigned Class;
+    unsigned Epoch;
+    std::size_t Live;
+  };
+
+  struct SizeClass {
+    FreeBlock *FreeList = nullptr;
+    char *Cur = nullptr;
+    char *End = nullptr;
+  };
+
+private:
+  static ASTMPMemoryPool MMP;
+
+  SizeClass SC[NumClasses];
+  // Heap allocated and never destroyed: GMP values in other static
+  // objects may be cleared after this object is destroyed.
+  std::unordered_set<uintptr_t> *Chunks;
+  std::size_t Live;
+  std::size_t Allocs;
+  std::size_t Recycled;
+  unsigned Epoch;
+  bool Installed;
+
+protected:
+  ASTMPMemoryPool()
+      : SC(), Chunks(nullptr), Live(0), Allocs(0), Recycled(0), Epoch(0U),
+        Installed(false) {}
+
+  static unsigned ClassOf(std::size_t Size);
+
+  static std::size_t ClassSize(unsigned C) { return MinBlockSize << C; }
+
+  bool Owns(const void *P) const {
+    uintptr_t B = reinterpret_cast<uintptr_t>(P) & ~(ChunkSize - 1);
+    return Chunks && Chunks->find(B) != Chunks->end();
+  }
+
+  static ChunkHeader *HeaderOf(const void *P) {
+    return reinterpret_cast<ChunkHeader *>(reinterpret_cast<uintptr_t>(P) &
+                                           ~(ChunkSize - 1));
+  }
+
+  bool NewChunk(unsigned C);
+
+  void FreeChunk(ChunkHeader *H);
+
+  static void *Allocate(std::size_t Size);
+
+  static void *Reallocate(void *P, std::size_t OldSize, std::size_t NewSize);
+
+  static void Free(void *P, std::size_t Size);
+
+public:
+  static ASTMPMemoryPool &Instance() { return MMP; }
+
+  ~ASTMPMemoryPool() = default;
+
+  // Installs the pool as the GMP memory allocator. GMP values created
+  // before this call remain valid.
+  void Enable();
+
+  bool IsEnabled() const { return Installed; }
+
+  // Ends the current epoch. Returns the chunks that have no block in
+  // use to the system, and retires the others.
+  void Release();
+
+  std::size_t GetLiveBlocks() const { return Live; }
+
+  std::size_t GetNumChunks() const { return Chunks ? Chunks->size() : 0U; }
+
+  // The number of chunks that hold no block in use.
+  std::size_t GetNumEmptyChunks() const;
+
+  std::size_t GetNumAllocations() const { return Allocs; }
+
+  std::size_t GetNumRecycled() const { return Recycled; }
+};
+
+} // namespace QASM
+
+#endif // __QASM_AST_MP_MEMORY_POOL_H
@@ -22,6 +22,7 @@
 #include <qasm/AST/ASTDeclarationContext.h>
 #include <qasm/AST/ASTExpressionEvaluator.h>
 #include <qasm/AST/ASTExpressionValidator.h>
+#include <qasm/AST/ASTInstrumentation.h>
 #include <qasm/AST/ASTObjectTracker.h>
 #include <qasm/AST/ASTTypes.h>
 
@@ -77,9 +78,13 @@ protected:
   static std::map<ASTOpType, Mangler::MToken> ODMM;
 
 public:
-  ASTMangler() : S() {}
+  // Mangling is timed from the construction to the destruction of the
+  // mangler.
+  ASTMangler() : S() { QASM_INSTR_ENTER(Mangle); }
 
-  ASTMangler(const ASTMangler &RHS) : S(RHS.S.str()) {}
+  ASTMangler(const ASTMangler &RHS) : S(RHS.S.str()) {
+    QASM_INSTR_ENTER(Mangle);
+  }
 
   ASTMangler &operator=(const ASTMangler &RHS) {
     if (this != &RHS) {
@@ -90,7 +95,7 @@ public:
     return *this;
   }
 
-  ~ASTMangler() = default;
+  ~ASTMangler() { QASM_INSTR_LEAVE(Mangle); }
 
   static void Init();
 
@@ -19,6 +19,8 @@
 #ifndef __QASM_AST_MATH_UTILS_H
 #define __QASM_AST_MATH_UTILS_H
 
+#include <qasm/AST/ASTBitVector.h>
+
 #include <cstdint>
 #include <limits>
 #include <type_traits>
@@ -50,6 +52,11 @@ public:
     return R;
   }
 
+  template <typename __Type>
+  __Type BoolVectorToIntegral(const ASTBitVector &BV) const {
+    return BV.ToIntegral<__Type>();
+  }
+
   template <typename __Type>
   unsigned popcount(__Type X) noexcept {
     static_assert(!std::is_floating_point<__Type>::value,
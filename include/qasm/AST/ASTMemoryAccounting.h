@@ -0,0 +1,160 @@
+/* -*- coding: utf-8 -*-
+ *
+ * Copyright 2023 IBM RESEARCH. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#ifndef __QASM_AST_MEMORY_ACCOUNTING_H
+#define __QASM_AST_MEMORY_ACCOUNTING_H
+
+#include <qasm/AST/ASTTypeEnums.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <string>
+#include <unordered_map>
+
+namespace QASM {
+
+// Memory accounting of the AST, by ASTType.
+//
+// When enabled, ASTBase::operator new records the size of every AST node
+// it allocates. Collect() then walks the live nodes registered with the
+// ASTObjectTracker, and attributes their count and allocated size to
+// their ASTType. It also estimates the memory held by auxiliary
+// structures: the symbol table maps and entries, the MP integer, decimal,
+// complex and angle limbs, the tokens and their strings, and the mangled
+// names of the identifiers.
+//
+// The accounting must be enabled before the nodes are allocated, and it
+// needs the ASTObjectTracker. Nodes allocated while it was disabled are
+// counted with a size of zero. The auxiliary sizes are estimates: they
+// add the container node overhead and the heap storage of the strings,
+// but not the allocator's own overhead.
+class ASTMemoryAccounting {
+public:
+  enum Category : unsigned {
+    SymbolTableMaps = 0,
+    SymbolTableEntries,
+    MPLimbs,
+    Tokens,
+    TokenStrings,
+    MangledNames,
+    NumCategories
+  };
+
+  struct Record {
+    uint64_t Count;
+    uint64_t Bytes;
+
+    Record() : Count(0UL), Bytes(0UL) {}
+
+    void Add(uint64_t B, uint64_t C = 1UL) {
+      Count += C;
+      Bytes += B;
+    }
+  };
+
+private:
+  static ASTMemoryAccounting MA;
+
+  std::unordered_map<const void *, std::size_t> AM;
+  std::map<ASTType, Record> TM;
+  Record Aux[NumCategories];
+  Record Nodes;
+  uint64_t LiveBytes;
+  uint64_t PeakBytes;
+  bool Enabled;
+
+private:
+  void CollectNodes();
+  void CollectSymbolTable();
+  void CollectTokens();
+
+protected:
+  ASTMemoryAccounting()
+      : AM(), TM(), Aux(), Nodes(), LiveBytes(0UL), PeakBytes(0UL),
+        Enabled(false) {}
+
+public:
+  static ASTMemoryAccounting &Instance() { return MA; }
+
+  ~ASTMemoryAccounting() = default;
+
+  static const char *CategoryName(Category C);
+
+  // The heap storage of a std::string, zero if the string is stored
+  // inline in the object.
+  static std::size_t HeapSize(const std::string &S);
+
+  void Enable() { Enabled = true; }
+
+  void Disable() { Enabled = false; }
+
+  bool IsEnabled() const { return Enabled; }
+
+  void RecordAllocation(const void *P, std::size_t S) {
+    if (Enabled) {
+      AM[P] = S;
+      LiveBytes += S;
+      if (LiveBytes > PeakBytes)
+        PeakBytes = LiveBytes;
+    }
+  }
+
+  void RecordDeallocation(const void *P) {
+    if (AM.empty())
+      return;
+
+    std::unordered_map<const void *, std::size_t>::iterator I = AM.find(P);
+    if (I != AM.end()) {
+      LiveBytes -= (*I).second;
+      AM.erase(I);
+    }
+  }
+
+  std::size_t GetAllocationSize(const void *P) const {
+    std::unordered_map<const void *, std::size_t>::const_iterator I =
+        AM.find(P);
+    return I == AM.end() ? 0UL : (*I).second;
+  }
+
+  // Attributes the live AST nodes and the auxiliary structures.
+  // The results replace those of the previous call.
+  void Collect();
+
+  void Clear();
+
+  const std::map<ASTType, Record> &GetTypeRecords() const { return TM; }
+
+  const Record &GetRecord(Category C) const { return Aux[C]; }
+
+  const Record &GetNodeRecord() const { return Nodes; }
+
+  uint64_t GetTotalBytes() const;
+
+  // The largest number of bytes of AST nodes that were allocated at the
+  // same time, since the accounting was enabled.
+  uint64_t GetPeakBytes() const { return PeakBytes; }
+
+  // Prints the histogram of the last Collect(), largest first.
+  void Print(std::ostream &OS = std::cerr) const;
+};
+
+} // namespace QASM
+
+#endif // __QASM_AST_MEMORY_ACCOUNTING_H
@@ -29,6 +29,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 #if defined(__APPLE__)
 #include <malloc/malloc.h>
@@ -77,6 +78,8 @@ struct ASTMapObject {
 class ASTObjectTracker {
   friend class ASTIdentifierNode;
   friend class ASTDemangledRegistry;
+  friend class ASTInstrumentation;
+  friend class ASTMemoryAccounting;
 
 private:
   std::map<std::uintptr_t, ASTMapObject> OM;
@@ -84,15 +87,18 @@ private:
   ASTSegmentMap Heap;
   uint64_t RLimitHeap;
   uint64_t SbrkZero;
+  std::vector<const ASTBase *> MV;
   bool EnableFree;
+  bool SuspendedFree;
+  bool Marking;
 
 private:
   static ASTObjectTracker IOM;
 
 private:
   ASTObjectTracker()
-      : OM(), Stack(), Heap(), RLimitHeap(0UL), SbrkZero(0UL),
-        EnableFree(false) {}
+      : OM(), Stack(), Heap(), RLimitHeap(0UL), SbrkZero(0UL), MV(),
+        EnableFree(false), SuspendedFree(false), Marking(false) {}
 
   bool IsOnHeap(const ASTBase *O) {
 #if defined(__APPLE__)
@@ -165,13 +171,48 @@ public:
 
   bool IsEnabled() const { return EnableFree; }
 
-  void Clear() { OM.clear(); }
+  // Objects created between Suspend() and Resume() are not registered,
+  // and are never deleted by Release().
+  void Suspend() {
+    SuspendedFree = EnableFree;
+    EnableFree = false;
+  }
+
+  void Resume() { EnableFree = SuspendedFree; }
+
+  void Clear() {
+    OM.clear();
+    MV.clear();
+  }
+
+  // Records the objects registered from now on, until the next call to
+  // Mark(), ReleaseMarked() or Unmark().
+  void Mark() {
+    MV.clear();
+    Marking = true;
+  }
+
+  void Unmark() {
+    MV.clear();
+    Marking = false;
+  }
+
+  // Deletes the recorded objects that Release() would delete, and the
+  // recorded ASTIdentifierNodes, newest first, and removes them from
+  // their Declaration Context. The caller guarantees that nothing else
+  // refers to them: nothing created before the mark, and no Symbol Table
+  // entry. Recording starts again.
+  void ReleaseMarked();
+
+  std::size_t Size() const { return OM.size(); }
 
   void Register(ASTBase *O) {
     if (EnableFree && O && IsOnHeap(O)) {
       uintptr_t H = reinterpret_cast<uintptr_t>(O);
       ASTMapObject MO(O);
       OM.insert(std::make_pair(H, MO));
+      if (Marking)
+        MV.push_back(O);
     }
   }
 
@@ -180,6 +221,8 @@ public:
       uintptr_t H = reinterpret_cast<uintptr_t>(O);
       ASTMapObject MO(O);
       OM.insert(std::make_pair(H, MO));
+      if (Marking)
+        MV.push_back(O);
     }
   }
 
@@ -0,0 +1,206 @@
+/* -*- coding: utf-8 -*-
+ *
+ * Copyright 2023 IBM RESEARCH. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#ifndef __QASM_AST_PARSE_BUDGET_H
+#define __QASM_AST_PARSE_BUDGET_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+namespace QASM {
+
+// The limit of an ASTParseBudget that a parse went over.
+class ASTParseBudgetExceeded : public std::runtime_error {
+public:
+  enum Limit : unsigned { Time = 0, Nodes, Symbols, Bytes };
+
+private:
+  Limit L;
+
+public:
+  ASTParseBudgetExceeded(Limit LT, const std::string &M)
+      : std::runtime_error(M), L(LT) {}
+
+  Limit GetLimit() const { return L; }
+};
+
+// Limits on the wall time, the number of AST nodes, the number of symbol
+// table entries and the bytes of AST nodes of a single parse.
+//
+// ASTParser::ParseAST starts the budget before it parses, and stops it
+// when it is done. While it runs, ASTBase::operator new records every
+// AST node, and ASTSymbolTableEntry::operator new every symbol. A record
+// that goes over a limit only marks the budget as overrun: throwing out
+// of operator new would abandon a node in the middle of its constructor,
+// and leak the MP values and the strings its members already hold.
+//
+// The scanner ticks the budget before every token. No AST node is being
+// constructed then, and a tick throws ASTParseBudgetExceeded if the
+// budget was overrun, or, once every DeadlineStride ticks, if the
+// deadline has passed. A parse thus stops at the first token after it
+// went over a limit. ParseAST catches the exception, releases the AST,
+// the symbol table, the tokens and the builders of the parse, emits an
+// error diagnostic, and returns nullptr.
+//
+// The builtin environment, which is created once per process, is not
+// counted. A limit of zero is no limit. The default diagnostic handler
+// exits once the maximum number of errors has been emitted, so a process
+// that must outlive an aborted parse installs its own handler.
+class ASTParseBudget {
+public:
+  using Clock = std::chrono::steady_clock;
+  using ClockSource = Clock::time_point (*)();
+
+  static const unsigned DeadlineStride = 256U;
+
+private:
+  static ASTParseBudget PB;
+
+  ClockSource Now;
+  std::chrono::milliseconds Timeout;
+  uint64_t MaxNodes;
+  uint64_t MaxSymbols;
+  uint64_t MaxBytes;
+  Clock::time_point Deadline;
+  uint64_t NumNodes;
+  uint64_t NumSymbols;
+  uint64_t NumBytes;
+  unsigned Ticks;
+  ASTParseBudgetExceeded::Limit OverrunLimit;
+  bool Overrun;
+  bool Running;
+  bool SuspendedRunning;
+
+private:
+  [[noreturn]] void Exceed(ASTParseBudgetExceeded::Limit L);
+  void CheckDeadline();
+
+  void SetOverrun(ASTParseBudgetExceeded::Limit L) {
+    if (!Overrun) {
+      OverrunLimit = L;
+      Overrun = true;
+    }
+  }
+
+protected:
+  ASTParseBudget()
+      : Now(&Clock::now), Timeout(0), MaxNodes(0UL), MaxSymbols(0UL),
+        MaxBytes(0UL), Deadline(), NumNodes(0UL), NumSymbols(0UL),
+        NumBytes(0UL), Ticks(0U), OverrunLimit(ASTParseBudgetExceeded::Time),
+        Overrun(false), Running(false), SuspendedRunning(false) {}
+
+public:
+  static ASTParseBudget &Instance() { return PB; }
+
+  ~ASTParseBudget() = default;
+
+  void SetTimeout(std::chrono::milliseconds T) { Timeout = T; }
+
+  // Reads the deadline from C instead of the steady clock, so that a test
+  // of the timeout does not depend on the speed of the machine. nullptr
+  // restores the steady clock.
+  void SetClock(ClockSource C) { Now = C ? C : &Clock::now; }
+
+  void SetMaxNodes(uint64_t N) { MaxNodes = N; }
+
+  void SetMaxSymbols(uint64_t N) { MaxSymbols = N; }
+
+  void SetMaxBytes(uint64_t N) { MaxBytes = N; }
+
+  std::chrono::milliseconds GetTimeout() const { return Timeout; }
+
+  uint64_t GetMaxNodes() const { return MaxNodes; }
+
+  uint64_t GetMaxSymbols() const { return MaxSymbols; }
+
+  uint64_t GetMaxBytes() const { return MaxBytes; }
+
+  // True if any of the limits is set.
+  bool IsEnabled() const {
+    return Timeout.count() > 0 || MaxNodes || MaxSymbols || MaxBytes;
+  }
+
+  bool IsRunning() const { return Running; }
+
+  // Resets the counters, and arms the deadline.
+  void Start();
+
+  void Stop() { Running = false; }
+
+  // Nothing is recorded between Suspend() and Resume().
+  void Suspend() {
+    SuspendedRunning = Running;
+    Running = false;
+  }
+
+  void Resume() { Running = SuspendedRunning; }
+
+  // True if a record went over a limit since Start().
+  bool IsOverrun() const { return Overrun; }
+
+  // Throws ASTParseBudgetExceeded if the budget was overrun. Called where
+  // no AST node is being constructed.
+  void Check() {
+    if (Running && Overrun)
+      Exceed(OverrunLimit);
+  }
+
+  void Tick() {
+    Check();
+
+    if (Running && Timeout.count() > 0 &&
+        (++Ticks % DeadlineStride) == 0U)
+      CheckDeadline();
+  }
+
+  void RecordNode(std::size_t S) {
+    if (!Running)
+      return;
+
+    ++NumNodes;
+    NumBytes += S;
+
+    if (MaxNodes && NumNodes > MaxNodes)
+      SetOverrun(ASTParseBudgetExceeded::Nodes);
+    if (MaxBytes && NumBytes > MaxBytes)
+      SetOverrun(ASTParseBudgetExceeded::Bytes);
+  }
+
+  void RecordSymbol() {
+    if (!Running)
+      return;
+
+    ++NumSymbols;
+
+    if (MaxSymbols && NumSymbols > MaxSymbols)
+      SetOverrun(ASTParseBudgetExceeded::Symbols);
+  }
+
+  uint64_t GetNumNodes() const { return NumNodes; }
+
+  uint64_t GetNumSymbols() const { return NumSymbols; }
+
+  uint64_t GetNumBytes() const { return NumBytes; }
+};
+
+} // namespace QASM
+
+#endif // __QASM_AST_PARSE_BUDGET_H
@@ -206,6 +206,15 @@ public:
     else if (IType == ASTTypeBitset)
       CBI->print();
     std::cout << "</Target>" << std::endl;
+    if (IType == ASTTypeBitset) {
+      ASTBitVector RV = CBI->AsVector();
+      if (OpType == ASTRotationTypeLeft)
+        RV.rotl(S);
+      else if (OpType == ASTRotationTypeRight)
+        RV.rotr(S);
+      std::cout << "<RotatedValue>" << RV.ToString() << "</RotatedValue>"
+                << std::endl;
+    }
     std::cout << "</RotationNode>" << std::endl;
   }
 
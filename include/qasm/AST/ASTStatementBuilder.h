@@ -21,8 +21,10 @@
 
 #include <qasm/AST/ASTStatement.h>
 
+#include <functional>
 #include <iostream>
 #include <map>
+#include <vector>
 
 namespace QASM {
 
@@ -30,10 +32,30 @@ class ASTSymbolTableEntry;
 class ASTStatementNode;
 
 class ASTStatementBuilder {
+public:
+  using stream_callback = std::function<void(ASTStatement *)>;
+
+  // The statements [Begin, End) of the list that a top-level statement
+  // appended. Transient is set when Flush() would have released them in
+  // streaming mode.
+  struct Boundary {
+    std::size_t Begin;
+    std::size_t End;
+    bool Transient;
+  };
+
 private:
   static ASTStatementList SL;
   static ASTStatementBuilder B;
   static std::map<uintptr_t, const ASTStatement *> SM;
+  static stream_callback SCB;
+  static std::vector<Boundary> BV;
+  static uint64_t NSE;
+  static bool FSN;
+
+private:
+  static void MarkStream();
+  static bool IsTransient(const ASTStatement *SN);
 
 protected:
   ASTStatementBuilder() {}
@@ -80,6 +102,10 @@ public:
         }
 
         SL.Prepend(SN);
+        for (Boundary &SB : BV) {
+          ++SB.Begin;
+          ++SB.End;
+        }
       }
     }
   }
@@ -88,7 +114,51 @@ public:
     return dynamic_cast<ASTStatement *>(SL.List.front());
   }
 
-  void Clear() { SL.List.clear(); }
+  void Clear();
+
+  // In streaming mode, the statements appended while a top-level
+  // statement is being reduced are handed to the callback by Flush(),
+  // in order, and are then removed from the statement list. The list
+  // then only holds the statements of the top-level statement that is
+  // being parsed.
+  //
+  // When the top-level statement is a quantum operation other than a
+  // measurement, and creating it did not add a Symbol Table entry,
+  // nothing parsed later can refer to the nodes created since the
+  // previous top-level statement. Once the callback has returned, Flush()
+  // deletes those nodes through the ASTObjectTracker. This keeps the
+  // memory of a long circuit bounded by its declarations, and needs the
+  // ASTObjectTracker to be enabled when the callback is set.
+  void SetStreamCallback(const stream_callback &CB);
+
+  void ClearStreamCallback();
+
+  bool IsStreaming() const { return static_cast<bool>(SCB); }
+
+  // Hands a statement to the callback without appending it. The
+  // statement is kept.
+  void Stream(ASTStatement *SN) {
+    if (SN && SCB) {
+      SCB(SN);
+      MarkStream();
+    }
+  }
+
+  void Flush();
+
+  // When the statements are not streamed, Flush() records the statements
+  // of every top-level statement in the list, in order.
+  const std::vector<Boundary> &GetBoundaries() const { return BV; }
+
+  // Exchanges the statement list and its boundaries with V and SBV. This
+  // lets a fragment be parsed into an empty list, and the list of the
+  // program be put back afterwards.
+  void Swap(list_type &V, std::vector<Boundary> &SBV);
+
+  // Replaces the statements of the top-level statement at index K of
+  // GetBoundaries() with V, as the statements of a single top-level
+  // statement. The boundaries after it are shifted.
+  void Replace(std::size_t K, const list_type &V, bool Transient);
 
   std::size_t Size() { return SL.List.size(); }
 
@@ -24,11 +24,11 @@
 #include <cctype>
 #include <climits>
 #include <codecvt>
+#include <cstdlib>
 #include <cstring>
 #include <locale>
 #include <memory>
 #include <random>
-#include <regex>
 #include <sstream>
 #include <string>
 #include <string_view>
@@ -36,14 +36,22 @@
 
 namespace QASM {
 
+// The reserved member suffixes of complex values (.creal, .cimag) and of
+// OpenPulse frames (.freq, .frequency, .phase, .time).
+enum ASTReservedSuffix : unsigned {
+  ReservedSuffixNone = 0,
+  ReservedSuffixCReal,
+  ReservedSuffixCImag,
+  ReservedSuffixFreq,
+  ReservedSuffixFrequency,
+  ReservedSuffixPhase,
+  ReservedSuffixTime,
+};
+
 class ASTStringUtils {
 private:
   // In ASTBuilder.cpp.
   static ASTStringUtils SU;
-  static std::regex ZRD;
-  static std::regex ZRZ;
-  static std::regex MPNAN;
-  static std::regex MPINF;
   static std::string ES;
 
 protected:
@@ -288,54 +296,91 @@ public:
     }
   }
 
-  void RemoveTrailingZeros(std::string &S) const {
-    if (!S.empty()) {
-      std::smatch SM;
-      if (std::regex_match(S, SM, ASTStringUtils::MPNAN)) {
-        S = "NaN";
-        return;
-      } else if (std::regex_match(S, SM, ASTStringUtils::MPINF)) {
-        S = "Inf";
-        return;
-      }
+  // Matches @?[Nn]a[Nn]@?
+  bool IsMPNaN(std::string_view S) const {
+    if (!S.empty() && S.front() == '@')
+      S.remove_prefix(1);
+    if (!S.empty() && S.back() == '@')
+      S.remove_suffix(1);
 
-      std::smatch ZM;
-      if (std::regex_match(S, ZM, ASTStringUtils::ZRD) ||
-          std::regex_match(S, ZM, ASTStringUtils::ZRZ)) {
-        S = "0.0";
-        return;
-      }
+    return S.length() == 3U && (S[0] == 'N' || S[0] == 'n') && S[1] == 'a' &&
+           (S[2] == 'N' || S[2] == 'n');
+  }
+
+  // Matches @?[Ii]nf@?
+  bool IsMPInf(std::string_view S) const {
+    if (!S.empty() && S.front() == '@')
+      S.remove_prefix(1);
+    if (!S.empty() && S.back() == '@')
+      S.remove_suffix(1);
+
+    return S.length() == 3U && (S[0] == 'I' || S[0] == 'i') && S[1] == 'n' &&
+           S[2] == 'f';
+  }
 
-      std::string R = S.substr(0, S.find_last_not_of(u8'0') + 1);
-      if (R[R.length() - 1] == u8'.')
-        R += u8'0';
+  // Matches [0]+ or [0]+.[0]+, where '.' is any character other than a
+  // line terminator.
+  bool IsZeroDecimal(std::string_view S) const {
+    std::string_view::size_type P = S.find_first_not_of(u8'0');
+    if (P == std::string_view::npos)
+      return !S.empty();
 
-      if (R[R.length() - 1] != (u8'0')) {
-        unsigned N = 2U;
-        unsigned C = 1U;
-        unsigned Z = 0U;
+    return P >= 1U && P + 2U <= S.length() && S[P] != '\n' && S[P] != '\r' &&
+           S.find_first_not_of(u8'0', P + 1) == std::string_view::npos;
+  }
 
-        while (R[R.length() - C] != (u8'0') && R[R.length() - C] != (u8'.'))
-          ++C;
+  // Removes the trailing zeros of the decimal string S of length L, and
+  // the rounding noise that follows a run of zeros longer than the noise
+  // itself ("1.50000000000000003" becomes "1.5"). A trailing '.' gets a
+  // '0' appended, so S must have room for L + 2 characters. Returns the
+  // new length.
+  std::size_t TrimTrailingZeros(char *S, std::size_t L) const {
+    while (L > 1U && S[L - 1] == u8'0')
+      --L;
 
-        N = C;
-        while (R[R.length() - N++] == (u8'0')) {
-          ++Z;
-          if (Z > C) {
-            unsigned K = 1U;
-            while (K < C)
-              R[R.length() - K++] = (u8'0');
+    if (S[L - 1] == u8'.') {
+      S[L++] = u8'0';
+    } else if (S[L - 1] != u8'0') {
+      std::size_t C = 1U;
+      while (C < L && S[L - C] != u8'0' && S[L - C] != u8'.')
+        ++C;
 
-            break;
-          }
+      std::size_t Z = 0U;
+      for (std::size_t N = C; N <= L && S[L - N] == u8'0'; ++N) {
+        if (++Z > C) {
+          for (std::size_t K = 1U; K < C; ++K)
+            S[L - K] = u8'0';
+          break;
         }
       }
 
-      R = R.substr(0, R.find_last_not_of(u8'0') + 1);
-      if (R[R.length() - 1] == (u8'.'))
-        R += '0';
+      while (L > 1U && S[L - 1] == u8'0')
+        --L;
 
-      S = R;
+      if (S[L - 1] == u8'.')
+        S[L++] = u8'0';
+    }
+
+    S[L] = u8'\0';
+    return L;
+  }
+
+  void RemoveTrailingZeros(std::string &S) const {
+    if (!S.empty()) {
+      if (IsMPNaN(S)) {
+        S = "NaN";
+        return;
+      } else if (IsMPInf(S)) {
+        S = "Inf";
+        return;
+      } else if (IsZeroDecimal(S)) {
+        S = "0.0";
+        return;
+      }
+
+      std::size_t L = S.length();
+      S.resize(L + 2U);
+      S.resize(TrimTrailingZeros(S.data(), L));
     }
   }
 
@@ -343,9 +388,7 @@ public:
     if (S.empty()) {
       S = "0.0";
     } else {
-      std::smatch SM;
-      if (std::regex_match(S, SM, ASTStringUtils::MPNAN) ||
-          std::regex_match(S, SM, ASTStringUtils::MPINF))
+      if (IsMPNaN(S) || IsMPInf(S))
         return;
 
       if (S.find('.') == std::string::npos)
@@ -460,7 +503,7 @@ public:
       return static_cast<unsigned>(std::stoi(IS.substr(X + 1)));
 
     X = IS.find_last_of('[');
-    std::string::size_type Y = IS.find_last_of('[');
+    std::string::size_type Y = IS.find_last_of(']');
     if (X != std::string::npos && Y != std::string::npos) {
       std::string IXS = IS.substr(X + 1, Y - X - 1);
       return static_cast<unsigned>(std::stoi(IXS));
@@ -469,6 +512,22 @@ public:
     return static_cast<unsigned>(~0x0);
   }
 
+  // Like GetIdentifierIndex, but returns ~0x0 instead of throwing when
+  // the index is not a number.
+  unsigned ParseIdentifierIndex(const std::string &IS) const {
+    std::string::size_type X = IS.find_last_of(':');
+    if (X == std::string::npos) {
+      X = IS.find_last_of('[');
+      if (X == std::string::npos || IS.find_last_of(']') == std::string::npos)
+        return static_cast<unsigned>(~0x0);
+    }
+
+    const char *B = IS.c_str() + X + 1;
+    char *E = nullptr;
+    long V = std::strtol(B, &E, 10);
+    return E == B ? static_cast<unsigned>(~0x0) : static_cast<unsigned>(V);
+  }
+
   bool IsIndexed(const std::string &S) const {
     return S.find('[') != std::string::npos && S.find(']') != std::string::npos;
   }
@@ -487,17 +546,30 @@ public:
     return S.length() >= 3U && S[0] == '_' && S[1] == 'Q';
   }
 
-  bool IsReservedSuffix(const std::string &S) const {
-    if (S.length()) {
-      std::string::size_type D = S.find_last_of(u8'.');
-      if (D != std::string::npos) {
-        std::string F = S.substr(D);
-        return F == ".creal" || F == ".cimag" || F == ".freq" ||
-               F == ".frequency" || F == ".phase" || F == ".time";
-      }
-    }
+  ASTReservedSuffix GetReservedSuffixKind(std::string_view S) const {
+    std::string_view::size_type D = S.find_last_of(u8'.');
+    if (D == std::string_view::npos)
+      return ReservedSuffixNone;
+
+    std::string_view F = S.substr(D + 1);
+    if (F == u8"creal")
+      return ReservedSuffixCReal;
+    else if (F == u8"cimag")
+      return ReservedSuffixCImag;
+    else if (F == u8"freq")
+      return ReservedSuffixFreq;
+    else if (F == u8"frequency")
+      return ReservedSuffixFrequency;
+    else if (F == u8"phase")
+      return ReservedSuffixPhase;
+    else if (F == u8"time")
+      return ReservedSuffixTime;
+
+    return ReservedSuffixNone;
+  }
 
-    return false;
+  bool IsReservedSuffix(const std::string &S) const {
+    return GetReservedSuffixKind(S) != ReservedSuffixNone;
   }
 
   std::string GetReservedSuffix(const std::string &S) const {
@@ -521,80 +593,35 @@ public:
   }
 
   bool IsOpenPulseFramePhase(const std::string &S) const {
-    if (S.length()) {
-      std::string::size_type D = S.find_last_of(u8'.');
-      if (D != std::string::npos && D < S.length())
-        return S.substr(D + 1) == u8"phase";
-    }
-
-    return false;
+    return GetReservedSuffixKind(S) == ReservedSuffixPhase;
   }
 
   bool IsOpenPulseFrameTime(const std::string &S) const {
-    if (S.length()) {
-      std::string::size_type D = S.find_last_of(u8'.');
-      if (D != std::string::npos && D < S.length())
-        return S.substr(D + 1) == u8"time";
-    }
-
-    return false;
+    return GetReservedSuffixKind(S) == ReservedSuffixTime;
   }
 
   bool IsOpenPulseFrameFrequency(const std::string &S) const {
-    if (S.length()) {
-      std::string::size_type D = S.find_last_of(u8'.');
-      if (D != std::string::npos && D < S.length()) {
-        std::string SS = S.substr(D + 1);
-        return SS == u8"freq" || SS == u8"frequency";
-      }
-    }
-
-    return false;
+    ASTReservedSuffix K = GetReservedSuffixKind(S);
+    return K == ReservedSuffixFreq || K == ReservedSuffixFrequency;
   }
 
   bool IsComplexCReal(const std::string &S) const {
-    if (S.length()) {
-      std::string::size_type D = S.find_last_of(u8'.');
-      if (D != std::string::npos && D < S.length())
-        return S.substr(D + 1) == u8"creal";
-    }
-
-    return false;
+    return GetReservedSuffixKind(S) == ReservedSuffixCReal;
   }
 
   bool IsComplexCImag(const std::string &S) const {
-    if (S.length()) {
-      std::string::size_type D = S.find_last_of(u8'.');
-      if (D != std::string::npos && D < S.length())
-        return S.substr(D + 1) == u8"cimag";
-    }
-
-    return false;
+    return GetReservedSuffixKind(S) == ReservedSuffixCImag;
   }
 
   bool IsOpenPulseFrameReservedSuffix(const std::string &S) const {
-    if (S.length()) {
-      std::string::size_type D = S.find_last_of(u8'.');
-      if (D != std::string::npos) {
-        std::string F = S.substr(D);
-        return F == ".freq" || F == ".frequency" || F == ".phase" ||
-               F == ".time";
-      }
-    }
-
-    return false;
+    ASTReservedSuffix K = GetReservedSuffixKind(S);
+    return K != ReservedSuffixNone && K != ReservedSuffixCReal &&
+           K != ReservedSuffixCImag;
   }
 
   bool IsMPComplexReservedSuffix(const std::string &S) const {
-    if (S.length()) {
-      std::string::size_type D = S.find_last_of(u8'.');
-      if (D != std::string::npos) {
-        std::string F = S.substr(D);
-        return F == ".creal" || F == ".cimag";
-      }
-    }
-
-    return false;
+    ASTReservedSuffix K = GetReservedSuffixKind(S);
+    return K == ReservedSuffixCReal || K == ReservedSuffixCImag;
   }
 
   std::string GetDefcalBaseName(const std::string &S) const {
@@ -23,10 +23,12 @@
 #include <qasm/AST/ASTCalContextBuilder.h>
 #include <qasm/AST/ASTDeclarationContext.h>
 #include <qasm/AST/ASTDeclarationList.h>
+#include <qasm/AST/ASTDefcalDispatchIndex.h>
 #include <qasm/AST/ASTExpressionValidator.h>
 #include <qasm/AST/ASTFunctionContextBuilder.h>
 #include <qasm/AST/ASTIdentifier.h>
 #include <qasm/AST/ASTIdentifierTypeController.h>
+#include <qasm/AST/ASTInstrumentation.h>
 #include <qasm/AST/ASTKernelContextBuilder.h>
 #include <qasm/AST/ASTObjectTracker.h>
 #include <qasm/AST/ASTStringUtils.h>
@@ -116,6 +118,14 @@ public:
 
   virtual ~ASTSymbolTableEntry() = default;
 
+  // Record the entry with the ASTParseBudget when it is running.
+  static void *operator new(std::size_t S);
+
+  // The number of entries allocated so far.
+  static uint64_t GetNumAllocated();
+
+  static void operator delete(void *P);
+
   ASTSymbolTableEntry &operator=(const ASTSymbolTableEntry &RHS) {
     if (this != &RHS) {
       if (ITy == RHS.ITy) {
@@ -354,6 +364,7 @@ class ASTSymbolTable {
   friend class ASTDefcalNode;
   friend class ASTFunctionDefinitionNode;
   friend class ASTKernelNode;
+  friend class ASTMemoryAccounting;
 
 private:
   enum STMapIndex : unsigned {
@@ -417,6 +428,31 @@ private:
   // Undefined Types under construction:
   static std::map<std::string, ASTSymbolTableEntry *> USTM;
 
+  // The builtin environment: the maps as they were when it was saved,
+  // and the entries it holds.
+  struct BuiltinEnvironment {
+    std::multimap<std::string, ASTSymbolTableEntry *> STM;
+    std::map<std::string, ASTSymbolTableEntry *> ASTM;
+    std::map<std::string, ASTSymbolTableEntry *> QSTM;
+    std::map<std::string, ASTSymbolTableEntry *> GSTM;
+    std::map<std::string, ASTSymbolTableEntry *> SGSTM;
+    std::map<uint64_t, ASTSymbolTableEntry *> HGSTM;
+    std::map<std::string, ASTSymbolTableEntry *> GPSTM;
+    std::map<std::string, ASTSymbolTableEntry *> DSTM;
+    std::map<std::string, ASTSymbolTableEntry *> SDSTM;
+    std::map<uint64_t, ASTSymbolTableEntry *> HDSTM;
+    std::map<std::string, ASTSymbolTableEntry *> FSTM;
+    std::map<std::string, ASTSymbolTableEntry *> SFSTM;
+    std::map<uint64_t, ASTSymbolTableEntry *> HFSTM;
+    std::map<std::string, ASTSymbolTableEntry *> CSTM;
+    std::map<std::string, ASTSymbolTableEntry *> GLSTM;
+    std::map<std::string, ASTSymbolTableEntry *> LSTM;
+    std::map<std::string, ASTSymbolTableEntry *> USTM;
+    std::set<const ASTSymbolTableEntry *> E;
+  };
+
+  static BuiltinEnvironment BE;
+
   static ASTSymbolTable ST;
 
 public:
@@ -540,6 +576,8 @@ public:
   }
 
   bool Insert(const std::string &S, ASTIdentifierNode *Id) {
+    QASM_INSTR_SCOPE(SymbolInsert);
+
     if (ASTAngleContextControl::Instance().InOpenContext() &&
         ASTTypeSystemBuilder::Instance().IsImplicitAngle(S)) {
       map_iterator AI = ASTM.find(S);
@@ -633,6 +671,8 @@ public:
   }
 
   bool Insert(const std::string &S, ASTIdentifierNode *Id, ASTType Ty) {
+    QASM_INSTR_SCOPE(SymbolInsert);
+
     if (ASTAngleContextControl::Instance().InOpenContext() &&
         ASTTypeSystemBuilder::Instance().IsImplicitAngle(S) &&
         Ty == ASTTypeAngle) {
@@ -865,6 +905,8 @@ public:
   }
 
   bool Insert(ASTIdentifierNode *Id, unsigned Bits, ASTType Ty) {
+    QASM_INSTR_SCOPE(SymbolInsert);
+
     assert(Id && "Invalid ASTIdentifierNode argument!");
 
     if (ASTAngleContextControl::Instance().InOpenContext() &&
@@ -1235,6 +1277,8 @@ public:
   }
 
   bool Insert(ASTIdentifierNode *Id, ASTSymbolTableEntry *STE) {
+    QASM_INSTR_SCOPE(SymbolInsert);
+
     assert(Id && "Invalid ASTIdentifierNode argument!");
     assert(STE && "Invalid ASTSymbolTableEntry argument!");
 
@@ -1634,6 +1678,8 @@ public:
             DiagLevel::ICE);
         return false;
       }
+
+      ASTDefcalDispatchIndex::Instance().Insert(Id->GetDefcalGroupName(), STE);
     }
 
     return true;
@@ -1827,6 +1873,8 @@ public:
   }
 
   bool Insert(ASTIdentifierRefNode *Id, ASTSymbolTableEntry *STE) {
+    QASM_INSTR_SCOPE(SymbolInsert);
+
     assert(Id && "Invalid ASTIdentifierNode argument!");
     assert(STE && "Invalid ASTSymbolTableEntry argument!");
 
@@ -2363,6 +2411,8 @@ public:
   }
 
   ASTSymbolTableEntry *Lookup(const std::string &S) const {
+    QASM_INSTR_SCOPE(SymbolLookup);
+
     if (S.empty())
       return nullptr;
 
@@ -2441,6 +2491,8 @@ public:
   }
 
   ASTSymbolTableEntry *Lookup(const std::string &S, unsigned Bits, ASTType Ty) {
+    QASM_INSTR_SCOPE(SymbolLookup);
+
     if (S.empty())
       return nullptr;
 
@@ -3025,6 +3077,8 @@ public:
   }
 
   ASTSymbolTableEntry *Lookup(const ASTIdentifierNode *Id) {
+    QASM_INSTR_SCOPE(SymbolLookup);
+
     assert(Id && "Invalid ASTIdentifierNode!");
 
     if (Id->GetBits() != static_cast<unsigned>(~0x0) &&
@@ -3036,6 +3090,8 @@ public:
   }
 
   ASTSymbolTableEntry *Lookup(const ASTIdentifierRefNode *IdR) {
+    QASM_INSTR_SCOPE(SymbolLookup);
+
     assert(IdR && "Invalid ASTIdentifierRefNode!");
 
     if (IdR->GetBits() != static_cast<unsigned>(~0x0) &&
@@ -3055,6 +3111,8 @@ public:
   }
 
   ASTSymbolTableEntry *Lookup(const std::string &S, ASTType Ty) const {
+    QASM_INSTR_SCOPE(SymbolLookup);
+
     if (!S.empty()) {
       map_iterator SI;
 
@@ -6569,7 +6627,20 @@ public:
     return nullptr;
   }
 
+  // Records every entry of the Symbol Table as part of the builtin
+  // environment.
+  void SaveBuiltinEnvironment();
+
+  bool IsBuiltin(const ASTSymbolTableEntry *STE) const {
+    return BE.E.find(STE) != BE.E.end();
+  }
+
+  // Deletes the entries, and empties the Symbol Table. The entries of
+  // the builtin environment are kept, and put back in the Symbol Table.
   void Release();
+
+  // Empties the Symbol Table, without deleting the entries.
+  void Clear();
 };
 
 } // namespace QASM
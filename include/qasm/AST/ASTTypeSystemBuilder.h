@@ -41,12 +41,14 @@ private:
   static std::set<std::string> OQ2RG;
   static std::set<std::string> RS;
   static std::set<std::string> FR;
+  static bool BEI;
 
 protected:
   ASTTypeSystemBuilder() = default;
   bool LocateImplicitSymbol(const std::string &S) const;
 
 protected:
+  static void CreateBuiltinEnvironment();
   void CreateASTBuiltinCXGate() const;
   void CreateASTBuiltinUGate() const;
   void CreateASTReservedAngles() const;
@@ -57,6 +59,8 @@ public:
 
   static void Init();
 
+  bool HasBuiltinEnvironment() const { return BEI; }
+
   bool IsReservedAngle(const std::string &S) const {
     if (LM.find(S) == LM.end())
       return GM.find(S) != GM.end();
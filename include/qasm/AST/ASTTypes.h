@@ -19,10 +19,12 @@
 #ifndef __QASM_AST_TYPES_H
 #define __QASM_AST_TYPES_H
 
+#include <qasm/AST/ASTAngleFixedPoint.h>
 #include <qasm/AST/ASTAnyTypeList.h>
 #include <qasm/AST/ASTDeclarationContext.h>
 #include <qasm/AST/ASTExpression.h>
 #include <qasm/AST/ASTIdentifier.h>
+#include <qasm/AST/ASTMPFormatter.h>
 #include <qasm/AST/ASTMissingConstants.h>
 #include <qasm/AST/ASTPrimitives.h>
 #include <qasm/AST/ASTProgramBlock.h>
@@ -34,16 +36,19 @@
 #include <mpc.h>
 #include <mpfr.h>
 
+#include <algorithm>
 #include <any>
 #include <array>
 #include <bitset>
 #include <cassert>
+#include <cfloat>
 #include <climits>
 #include <cmath>
 #include <cstdlib>
 #include <cstring>
 #include <iomanip>
 #include <iostream>
+#include <limits>
 #include <string>
 #include <variant>
 #include <vector>
@@ -1090,12 +1095,44 @@ class ASTMPIntegerNode : public ASTExpressionNode {
 private:
   ASTSignbit Signbit;
   unsigned Bits;
-  mpz_t MPValue;
+  // Values declared with at most 64 bits are kept inline as a magnitude
+  // and a sign, and are only promoted to a GMP integer when a caller
+  // asks for the mpz_t. MPValue is uninitialized while Inline is true.
+  mutable mpz_t MPValue;
+  mutable bool Inline;
+  bool INeg;
+  uint64_t IMag;
   const ASTExpressionNode *Expr;
 
 private:
   ASTMPIntegerNode() = delete;
 
+  static bool CanInline(unsigned NumBits) { return NumBits <= 64U; }
+
+  void SetInline(uint64_t Mag, bool Neg) {
+    IMag = Mag;
+    INeg = Neg && Mag != 0;
+  }
+
+  void SetInline(int64_t V) {
+    SetInline(V < 0 ? 0ULL - static_cast<uint64_t>(V)
+                    : static_cast<uint64_t>(V),
+              V < 0);
+  }
+
+  void Materialize() const {
+    if (!Inline)
+      return;
+
+    mpz_init2(MPValue, DefaultBits);
+    mpz_set_ui(MPValue, IMag);
+    if (INeg)
+      mpz_neg(MPValue, MPValue);
+    Inline = false;
+  }
+
+  bool SetFromString(const char *S, int Base);
+
 protected:
   void InitFromString(const char *NS, ASTSignbit SB, unsigned NumBits,
                       int Base);
@@ -1103,7 +1140,7 @@ protected:
   ASTMPIntegerNode(const ASTIdentifierNode *Id, const std::string &ERM)
       : ASTExpressionNode(Id, new ASTStringNode(ERM), ASTTypeExpressionError),
         Signbit(Unsigned), Bits(static_cast<unsigned>(~0x0)), MPValue(),
-        Expr(this) {}
+        Inline(true), INeg(false), IMag(0), Expr(this) {}
 
 public:
   static const unsigned DefaultBits = 64U;
@@ -1112,19 +1149,19 @@ public:
   explicit ASTMPIntegerNode(const ASTIdentifierNode *Id, ASTSignbit S,
                             unsigned NumBits)
       : ASTExpressionNode(Id, ASTTypeMPInteger), Signbit(S), Bits(NumBits),
-        MPValue(), Expr(nullptr) {
+        MPValue(), Inline(true), INeg(false), IMag(0), Expr(nullptr) {
     Id->SetBits(NumBits);
-    mpz_init2(MPValue, Bits);
-    if (Signbit == Signed)
-      mpz_set_si(MPValue, 0L);
-    else
+    if (!CanInline(Bits)) {
+      mpz_init2(MPValue, Bits);
       mpz_set_ui(MPValue, 0UL);
+      Inline = false;
+    }
   }
 
   explicit ASTMPIntegerNode(const ASTIdentifierNode *Id, ASTSignbit S,
                             unsigned NumBits, const char *String, int Base = 10)
       : ASTExpressionNode(Id, ASTTypeMPInteger), Signbit(S), Bits(NumBits),
-        MPValue(), Expr(nullptr) {
+        MPValue(), Inline(true), INeg(false), IMag(0), Expr(nullptr) {
     Id->SetBits(NumBits);
     InitFromString(String, S, NumBits, Base);
   }
@@ -1132,48 +1169,73 @@ public:
   explicit ASTMPIntegerNode(const ASTIdentifierNode *Id, ASTSignbit S,
                             unsigned NumBits, const ASTExpressionNode *E)
       : ASTExpressionNode(Id, ASTTypeMPInteger), Signbit(S), Bits(NumBits),
-        MPValue(), Expr(E) {
+        MPValue(), Inline(true), INeg(false), IMag(0), Expr(E) {
     Id->SetBits(NumBits);
-    mpz_init2(MPValue, Bits);
-    if (Signbit == Signed)
-      mpz_set_si(MPValue, 0L);
-    else
+    if (!CanInline(Bits)) {
+      mpz_init2(MPValue, Bits);
       mpz_set_ui(MPValue, 0UL);
+      Inline = false;
+    }
   }
 
   explicit ASTMPIntegerNode(const ASTIntNode *I, unsigned NumBits)
       : ASTExpressionNode(&ASTIdentifierNode::MPInt, ASTTypeMPInteger),
-        Signbit(I->GetSignBit()), Bits(NumBits), MPValue(), Expr(I) {
-    mpz_init2(MPValue, Bits);
+        Signbit(I->GetSignBit()), Bits(NumBits), MPValue(), Inline(true),
+        INeg(false), IMag(0), Expr(I) {
     if (I->IsSigned())
-      mpz_set_si(MPValue, static_cast<int64_t>(I->GetSignedValue()));
+      SetInline(static_cast<int64_t>(I->GetSignedValue()));
     else
-      mpz_set_ui(MPValue, static_cast<uint64_t>(I->GetUnsignedValue()));
+      SetInline(static_cast<uint64_t>(I->GetUnsignedValue()), false);
+
+    if (!CanInline(Bits)) {
+      mpz_init2(MPValue, Bits);
+      mpz_set_ui(MPValue, IMag);
+      if (INeg)
+        mpz_neg(MPValue, MPValue);
+      Inline = false;
+    }
   }
 
   explicit ASTMPIntegerNode(const ASTIdentifierNode *Id, const ASTIntNode *I,
                             unsigned NumBits)
       : ASTExpressionNode(Id, ASTTypeMPInteger), Signbit(I->GetSignBit()),
-        Bits(NumBits), MPValue(), Expr(I) {
+        Bits(NumBits), MPValue(), Inline(true), INeg(false), IMag(0),
+        Expr(I) {
     Id->SetBits(NumBits);
-    mpz_init2(MPValue, Bits);
     if (I->IsSigned())
-      mpz_set_si(MPValue, static_cast<int64_t>(I->GetSignedValue()));
+      SetInline(static_cast<int64_t>(I->GetSignedValue()));
     else
-      mpz_set_ui(MPValue, static_cast<uint64_t>(I->GetUnsignedValue()));
+      SetInline(static_cast<uint64_t>(I->GetUnsignedValue()), false);
+
+    if (!CanInline(Bits)) {
+      mpz_init2(MPValue, Bits);
+      mpz_set_ui(MPValue, IMag);
+      if (INeg)
+        mpz_neg(MPValue, MPValue);
+      Inline = false;
+    }
   }
 
   explicit ASTMPIntegerNode(const ASTIdentifierNode *Id, unsigned NumBits,
                             const mpz_t &MPZ, bool Unsigned)
       : ASTExpressionNode(Id, ASTTypeMPInteger),
         Signbit(Unsigned ? ASTSignbit::Unsigned : ASTSignbit::Signed),
-        Bits(NumBits), MPValue(), Expr(nullptr) {
+        Bits(NumBits), MPValue(), Inline(true), INeg(false), IMag(0),
+        Expr(nullptr) {
     Id->SetBits(NumBits);
-    mpz_init2(MPValue, NumBits);
-    mpz_set(MPValue, MPZ);
+    if (CanInline(Bits) && mpz_sizeinbase(MPZ, 2) <= 64U) {
+      SetInline(static_cast<uint64_t>(mpz_get_ui(MPZ)), mpz_sgn(MPZ) < 0);
+    } else {
+      mpz_init2(MPValue, NumBits);
+      mpz_set(MPValue, MPZ);
+      Inline = false;
+    }
   }
 
-  virtual ~ASTMPIntegerNode() { mpz_clear(MPValue); }
+  virtual ~ASTMPIntegerNode() {
+    if (!Inline)
+      mpz_clear(MPValue);
+  }
 
   virtual ASTType GetASTType() const override { return ASTTypeMPInteger; }
 
@@ -1201,24 +1263,25 @@ public:
 
   virtual void SetImplicitConversion(const ASTImplicitConversionNode *ICX);
 
-  virtual bool IsZero() const { return mpz_sgn(MPValue) == 0; }
+  virtual bool IsZero() const {
+    return Inline ? IMag == 0 : mpz_sgn(MPValue) == 0;
+  }
 
-  virtual bool IsNegative() const { return mpz_sgn(MPValue) == -1; }
+  virtual bool IsNegative() const {
+    return Inline ? INeg : mpz_sgn(MPValue) == -1;
+  }
 
-  virtual bool IsPositive() const { return mpz_sgn(MPValue) == 1; }
+  virtual bool IsPositive() const {
+    return Inline ? !INeg && IMag != 0 : mpz_sgn(MPValue) == 1;
+  }
 
   virtual std::string GetValue(int Base = 10) const;
 
   static std::string GetValue(const mpz_t &MPZ, int Base = 10);
 
   virtual bool SetValue(const char *String, int Base = 10) {
-    if (mpz_set_str(MPValue, String, Base) != 0) {
-      if (Signbit == Signed)
-        mpz_set_si(MPValue, 0L);
-      else
-        mpz_set_ui(MPValue, 0UL);
+    if (!SetFromString(String, Base)) {
       Bits = 0;
-
       return false;
     }
 
@@ -1237,9 +1300,23 @@ public:
     return ASTExpressionNode::Ident->GetName();
   }
 
-  virtual const mpz_t &GetMPValue() const { return MPValue; }
+  virtual const mpz_t &GetMPValue() const {
+    Materialize();
+    return MPValue;
+  }
+
+  virtual void GetMPValue(mpz_t &Out) {
+    if (Inline) {
+      mpz_set_ui(Out, IMag);
+      if (INeg)
+        mpz_neg(Out, Out);
+    } else {
+      mpz_set(Out, MPValue);
+    }
+  }
 
-  virtual void GetMPValue(mpz_t &Out) { mpz_set(Out, MPValue); }
+  // True if the value is held inline rather than in a GMP integer.
+  virtual bool IsInline() const { return Inline; }
 
   virtual void SetSignBit(ASTSignbit S) { Signbit = S; }
 
@@ -1248,16 +1325,28 @@ public:
   virtual bool IsSigned() const { return Signbit == Signed; }
 
   virtual uint32_t ToUnsignedInt() const {
-    return static_cast<uint32_t>(mpz_get_ui(MPValue));
+    return static_cast<uint32_t>(ToUnsignedLong());
   }
 
   virtual int32_t ToSignedInt() const {
-    return static_cast<int32_t>(mpz_get_si(MPValue));
+    return static_cast<int32_t>(ToSignedLong());
   }
 
-  virtual uint64_t ToUnsignedLong() const { return mpz_get_ui(MPValue); }
+  // Same truncation semantics as mpz_get_ui.
+  virtual uint64_t ToUnsignedLong() const {
+    return Inline ? IMag : mpz_get_ui(MPValue);
+  }
+
+  // Same truncation semantics as mpz_get_si.
+  virtual int64_t ToSignedLong() const {
+    if (!Inline)
+      return mpz_get_si(MPValue);
 
-  virtual int64_t ToSignedLong() const { return mpz_get_si(MPValue); }
+    if (!INeg)
+      return static_cast<int64_t>(IMag & INT64_MAX);
+
+    return -1 - static_cast<int64_t>((IMag - 1) & INT64_MAX);
+  }
 
   ASTMPDecimalNode *AsMPDecimal() const;
 
@@ -1272,6 +1361,10 @@ public:
   }
 
   virtual uint64_t Popcount() const {
+    if (Inline)
+      return INeg ? static_cast<uint64_t>(~0x0ULL)
+                  : static_cast<uint64_t>(__builtin_popcountll(IMag));
+
     return static_cast<uint64_t>(mpz_popcount(MPValue));
   }
 
@@ -1974,7 +2067,14 @@ private:
   unsigned Bits;
   unsigned Precision;
   unsigned DeclBits;
-  mpfr_t MPValue;
+  // Values that a double represents exactly at the requested precision
+  // are kept inline, and are only promoted to an MPFR number (of IPrec
+  // bits) when a caller needs one. MPValue is uninitialized while
+  // Inline is true.
+  mutable mpfr_t MPValue;
+  mutable bool Inline;
+  unsigned IPrec;
+  double DValue;
   const ASTExpressionNode *Expr;
 
 private:
@@ -1983,12 +2083,27 @@ private:
 private:
   ASTMPDecimalNode() = delete;
 
+  void Materialize() const {
+    if (!Inline)
+      return;
+
+    mpfr_init2(MPValue, IPrec);
+    if (std::isnan(DValue))
+      mpfr_set_nan(MPValue);
+    else if (mpfr_set_d(MPValue, DValue, MPFR_RNDN) != 0)
+      mpfr_set_nan(MPValue);
+    Inline = false;
+  }
+
+  static double NaN() { return std::numeric_limits<double>::quiet_NaN(); }
+
 protected:
   ASTMPDecimalNode(const ASTIdentifierNode *Id, const std::string &ERM)
       : ASTExpressionNode(Id, new ASTStringNode(ERM), ASTTypeExpressionError),
         Bits(static_cast<unsigned>(~0x0)),
         Precision(static_cast<unsigned>(~0x0)),
-        DeclBits(static_cast<unsigned>(~0x0)), MPValue(), Expr(this) {}
+        DeclBits(static_cast<unsigned>(~0x0)), MPValue(), Inline(true),
+        IPrec(DefaultBits), DValue(NaN()), Expr(this) {}
 
 public:
   static const unsigned DefaultBits = 64U;
@@ -1998,27 +2113,25 @@ public:
       : ASTExpressionNode(Id, ASTTypeMPDecimal),
         Bits(NumBits >= 32 ? NumBits : 32),
         Precision(NumBits >= 32 ? NumBits : 32), DeclBits(NumBits), MPValue(),
+        Inline(true), IPrec(NumBits > 32 ? NumBits : 32), DValue(NaN()),
         Expr(nullptr) {
     Id->SetBits(NumBits > 32 ? NumBits : 32);
-    mpfr_init2(MPValue, NumBits > 32 ? NumBits : 32);
-    mpfr_set_nan(MPValue);
   }
 
   explicit ASTMPDecimalNode(const ASTIdentifierNode *Id, unsigned NumBits,
                             unsigned Prec)
       : ASTExpressionNode(Id, ASTTypeMPDecimal), Bits(NumBits),
         Precision(Prec >= NumBits ? Prec : NumBits), DeclBits(NumBits),
-        MPValue(), Expr(nullptr) {
+        MPValue(), Inline(true), IPrec(NumBits), DValue(NaN()),
+        Expr(nullptr) {
     Id->SetBits(NumBits);
-    mpfr_init2(MPValue, NumBits);
-    mpfr_set_nan(MPValue);
   }
 
   explicit ASTMPDecimalNode(const ASTIdentifierNode *Id, unsigned NumBits,
                             const char *String, int Base = 10)
       : ASTExpressionNode(Id, ASTTypeMPDecimal), Bits(NumBits),
         Precision(NumBits >= 32 ? NumBits : 32), DeclBits(NumBits), MPValue(),
-        Expr(nullptr) {
+        Inline(false), IPrec(NumBits), DValue(0.0), Expr(nullptr) {
     Id->SetBits(NumBits);
     mpfr_init2(MPValue, NumBits);
     // MPFR_RNDN == round-to-nearest. This is IEEE-754 compliant.
@@ -2030,7 +2143,8 @@ public:
                             unsigned Prec, const char *String, int Base = 10)
       : ASTExpressionNode(Id, ASTTypeMPDecimal), Bits(NumBits),
         Precision(Prec >= NumBits ? Prec : NumBits), DeclBits(NumBits),
-        MPValue(), Expr(nullptr) {
+        MPValue(), Inline(false), IPrec(NumBits), DValue(0.0),
+        Expr(nullptr) {
     Id->SetBits(NumBits);
     mpfr_init2(MPValue, NumBits);
     // MPFR_RNDN == round-to-nearest. This is IEEE-754 compliant.
@@ -2042,7 +2156,7 @@ public:
                    const mpfr_t &Value)
       : ASTExpressionNode(Id, ASTTypeMPDecimal), Bits(NumBits),
         Precision(NumBits >= 32 ? NumBits : 32), DeclBits(NumBits), MPValue(),
-        Expr(nullptr) {
+        Inline(false), IPrec(NumBits), DValue(0.0), Expr(nullptr) {
     Id->SetBits(NumBits);
     mpfr_init2(MPValue, NumBits);
     if (mpfr_set(MPValue, Value, MPFR_RNDN) != 0)
@@ -2053,7 +2167,7 @@ public:
                             unsigned Prec, const mpfr_t &Value)
       : ASTExpressionNode(Id, ASTTypeMPDecimal), Bits(NumBits),
         Precision(Prec >= 32 ? Prec : 32), DeclBits(NumBits), MPValue(),
-        Expr(nullptr) {
+        Inline(false), IPrec(NumBits), DValue(0.0), Expr(nullptr) {
     Id->SetBits(NumBits);
     mpfr_init2(MPValue, NumBits);
     if (mpfr_set(MPValue, Value, MPFR_RNDN) != 0)
@@ -2063,50 +2177,48 @@ public:
   ASTMPDecimalNode(const ASTIdentifierNode *Id, unsigned NumBits, double Value)
       : ASTExpressionNode(Id, ASTTypeMPDecimal), Bits(NumBits),
         Precision(NumBits >= 64 ? NumBits : 64), DeclBits(NumBits), MPValue(),
-        Expr(nullptr) {
+        Inline(true), IPrec(NumBits), DValue(Value), Expr(nullptr) {
     Id->SetBits(NumBits);
-    mpfr_init2(MPValue, NumBits);
-    if (mpfr_set_d(MPValue, Value, MPFR_RNDN) != 0)
-      mpfr_set_nan(MPValue);
+    if (NumBits < DBL_MANT_DIG)
+      Materialize();
   }
 
   explicit ASTMPDecimalNode(const ASTIdentifierNode *Id, unsigned NumBits,
                             unsigned Prec, double Value)
       : ASTExpressionNode(Id, ASTTypeMPDecimal), Bits(NumBits),
         Precision(Prec >= NumBits ? Prec : NumBits), DeclBits(NumBits),
-        MPValue(), Expr(nullptr) {
+        MPValue(), Inline(true), IPrec(NumBits), DValue(Value),
+        Expr(nullptr) {
     Id->SetBits(NumBits);
-    mpfr_init2(MPValue, NumBits);
-    if (mpfr_set_d(MPValue, Value, MPFR_RNDN) != 0)
-      mpfr_set_nan(MPValue);
+    if (NumBits < DBL_MANT_DIG)
+      Materialize();
   }
 
   ASTMPDecimalNode(const ASTIdentifierNode *Id, unsigned NumBits, float Value)
       : ASTExpressionNode(Id, ASTTypeMPDecimal), Bits(NumBits),
         Precision(NumBits >= 32 ? NumBits : 32), DeclBits(NumBits), MPValue(),
-        Expr(nullptr) {
+        Inline(true), IPrec(NumBits), DValue(Value), Expr(nullptr) {
     Id->SetBits(NumBits);
-    mpfr_init2(MPValue, NumBits);
-    if (mpfr_set_d(MPValue, static_cast<double>(Value), MPFR_RNDN) != 0)
-      mpfr_set_nan(MPValue);
+    if (NumBits < FLT_MANT_DIG)
+      Materialize();
   }
 
   ASTMPDecimalNode(const ASTIdentifierNode *Id, unsigned NumBits, unsigned Prec,
                    float Value)
       : ASTExpressionNode(Id, ASTTypeMPDecimal), Bits(NumBits),
         Precision(Prec >= NumBits ? Prec : NumBits), DeclBits(NumBits),
-        MPValue(), Expr(nullptr) {
+        MPValue(), Inline(true), IPrec(NumBits), DValue(Value),
+        Expr(nullptr) {
     Id->SetBits(NumBits);
-    mpfr_init2(MPValue, NumBits);
-    if (mpfr_set_d(MPValue, static_cast<double>(Value), MPFR_RNDN) != 0)
-      mpfr_set_nan(MPValue);
+    if (NumBits < FLT_MANT_DIG)
+      Materialize();
   }
 
   ASTMPDecimalNode(const ASTIdentifierNode *Id, unsigned NumBits,
                    long double Value)
       : ASTExpressionNode(Id, ASTTypeMPDecimal), Bits(NumBits),
         Precision(NumBits >= 128 ? NumBits : 128), DeclBits(NumBits), MPValue(),
-        Expr(nullptr) {
+        Inline(false), IPrec(NumBits), DValue(0.0), Expr(nullptr) {
     Id->SetBits(NumBits);
     mpfr_init2(MPValue, NumBits);
     if (mpfr_set_ld(MPValue, Value, MPFR_RNDN) != 0)
@@ -2117,7 +2229,8 @@ public:
                             const ASTMPIntegerNode *MPI)
       : ASTExpressionNode(Id, ASTTypeMPDecimal), Bits(NumBits),
         Precision(NumBits >= MPI->GetBits() ? NumBits : MPI->GetBits()),
-        DeclBits(NumBits), MPValue(), Expr(MPI) {
+        DeclBits(NumBits), MPValue(), Inline(false), IPrec(NumBits),
+        DValue(0.0), Expr(MPI) {
     Id->SetBits(NumBits >= MPI->GetBits() ? NumBits : MPI->GetBits());
     mpfr_init2(MPValue, NumBits);
     // MPFR_RNDD == round to nearest.
@@ -2128,55 +2241,57 @@ public:
                             const ASTMPDecimalNode *MPD)
       : ASTExpressionNode(Id, ASTTypeMPDecimal), Bits(NumBits),
         Precision(NumBits >= MPD->GetBits() ? NumBits : MPD->GetBits()),
-        DeclBits(NumBits), MPValue(), Expr(MPD) {
+        DeclBits(NumBits), MPValue(), Inline(false), IPrec(NumBits),
+        DValue(0.0), Expr(MPD) {
     Id->SetBits(NumBits >= MPD->GetBits() ? NumBits : MPD->GetBits());
-    mpfr_init2(MPValue, NumBits);
-    // MPFR_RNDD == round to nearest.
-    mpfr_set(MPValue, MPD->GetMPValue(), MPFR_RNDN);
+    if (MPD->Inline && NumBits >= DBL_MANT_DIG) {
+      DValue = MPD->DValue;
+      Inline = true;
+    } else {
+      mpfr_init2(MPValue, NumBits);
+      // MPFR_RNDD == round to nearest.
+      mpfr_set(MPValue, MPD->GetMPValue(), MPFR_RNDN);
+    }
   }
 
   ASTMPDecimalNode(const ASTIdentifierNode *Id, unsigned NumBits,
                    const ASTExpressionNode *E)
       : ASTExpressionNode(Id, ASTTypeMPDecimal), Bits(NumBits),
         Precision(NumBits >= 32 ? NumBits : 32), DeclBits(NumBits), MPValue(),
-        Expr(E) {
+        Inline(true), IPrec(NumBits), DValue(0.0), Expr(E) {
     Id->SetBits(NumBits);
-    mpfr_init2(MPValue, NumBits);
-    // MPFR_RNDD == round to nearest.
-    mpfr_set_d(MPValue, 0.0, MPFR_RNDN);
   }
 
   ASTMPDecimalNode(const ASTIdentifierNode *Id, unsigned NumBits, unsigned Prec,
                    const ASTExpressionNode *E)
       : ASTExpressionNode(Id, ASTTypeMPDecimal), Bits(NumBits),
         Precision(Prec >= NumBits ? Prec : NumBits), DeclBits(NumBits),
-        MPValue(), Expr(E) {
+        MPValue(), Inline(true), IPrec(NumBits), DValue(0.0), Expr(E) {
     Id->SetBits(NumBits);
-    mpfr_init2(MPValue, NumBits);
-    // MPFR_RNDD == round to nearest.
-    if (mpfr_set_d(MPValue, 0.0, MPFR_RNDN) != 0)
-      mpfr_set_nan(MPValue);
   }
 
   ASTMPDecimalNode(const ASTDoubleNode *D, unsigned NumBits = 64U)
       : ASTExpressionNode(&ASTIdentifierNode::MPDec, ASTTypeMPDecimal),
         Bits(NumBits), Precision(NumBits >= 32 ? NumBits : 32),
-        DeclBits(NumBits), MPValue(), Expr(nullptr) {
-    mpfr_init2(MPValue, NumBits);
-    if (mpfr_set_d(MPValue, D->GetValue(), MPFR_RNDN) != 0)
-      mpfr_set_nan(MPValue);
+        DeclBits(NumBits), MPValue(), Inline(true), IPrec(NumBits),
+        DValue(D->GetValue()), Expr(nullptr) {
+    if (NumBits < DBL_MANT_DIG)
+      Materialize();
   }
 
   ASTMPDecimalNode(double Value, unsigned NumBits = 64U)
       : ASTExpressionNode(&ASTIdentifierNode::MPDec, ASTTypeMPDecimal),
         Bits(NumBits), Precision(NumBits >= 32 ? NumBits : 32),
-        DeclBits(NumBits), MPValue(), Expr(nullptr) {
-    mpfr_init2(MPValue, NumBits);
-    if (mpfr_set_d(MPValue, Value, MPFR_RNDN) != 0)
-      mpfr_set_nan(MPValue);
+        DeclBits(NumBits), MPValue(), Inline(true), IPrec(NumBits),
+        DValue(Value), Expr(nullptr) {
+    if (NumBits < DBL_MANT_DIG)
+      Materialize();
   }
 
-  virtual ~ASTMPDecimalNode() { mpfr_clear(MPValue); }
+  virtual ~ASTMPDecimalNode() {
+    if (!Inline)
+      mpfr_clear(MPValue);
+  }
 
   virtual ASTType GetASTType() const override { return ASTTypeMPDecimal; }
 
@@ -2212,21 +2327,39 @@ public:
 
   unsigned GetPrecision() const { return Precision; }
 
-  virtual bool IsNan() const { return mpfr_nan_p(MPValue) != 0; }
+  // True if the value is held inline rather than in an MPFR number.
+  virtual bool IsInline() const { return Inline; }
+
+  virtual bool IsNan() const {
+    return Inline ? std::isnan(DValue) : mpfr_nan_p(MPValue) != 0;
+  }
 
-  virtual bool IsInf() const { return mpfr_inf_p(MPValue) != 0; }
+  virtual bool IsInf() const {
+    return Inline ? std::isinf(DValue) : mpfr_inf_p(MPValue) != 0;
+  }
 
-  virtual bool IsZero() const { return mpfr_zero_p(MPValue) != 0; }
+  virtual bool IsZero() const {
+    return Inline ? DValue == 0.0 : mpfr_zero_p(MPValue) != 0;
+  }
 
-  virtual bool IsNegative() const { return mpfr_sgn(MPValue) < 0; }
+  virtual bool IsNegative() const {
+    return Inline ? DValue < 0.0 : mpfr_sgn(MPValue) < 0;
+  }
 
-  virtual bool IsPositive() const { return mpfr_sgn(MPValue) > 0; }
+  virtual bool IsPositive() const {
+    return Inline ? DValue > 0.0 : mpfr_sgn(MPValue) > 0;
+  }
 
   // return true if MPValue is neither NaN nor Inf.
-  virtual bool IsNumber() const { return mpfr_number_p(MPValue) != 0; }
+  virtual bool IsNumber() const {
+    return Inline ? std::isfinite(DValue) : mpfr_number_p(MPValue) != 0;
+  }
 
   // return true if MPValue is neither NaN nor Inf nor Zero.
-  virtual bool IsRegular() const { return mpfr_regular_p(MPValue) != 0; }
+  virtual bool IsRegular() const {
+    return Inline ? std::isfinite(DValue) && DValue != 0.0
+                  : mpfr_regular_p(MPValue) != 0;
+  }
 
   static ASTMPDecimalNode *Pi(int Bits = 64);
   static ASTMPDecimalNode *Pi(int Bits, int Prec);
@@ -2247,21 +2380,36 @@ public:
   static ASTMPDecimalNode *NegEuler(int Bits, int Prec);
 
   virtual ASTSignbit GetSignBit() const {
+    if (Inline)
+      return std::signbit(DValue) ? Signed : Unsigned;
+
     return mpfr_signbit(MPValue) == 0 ? Unsigned : Signed;
   }
 
-  virtual float ToFloat() const { return mpfr_get_flt(MPValue, MPFR_RNDN); }
+  virtual float ToFloat() const {
+    // A double to float conversion rounds to nearest, like MPFR_RNDN,
+    // as long as the result does not overflow.
+    if (Inline && !(std::fabs(DValue) > FLT_MAX))
+      return static_cast<float>(DValue);
 
-  virtual double ToDouble() const { return mpfr_get_d(MPValue, MPFR_RNDN); }
+    return mpfr_get_flt(GetMPValue(), MPFR_RNDN);
+  }
+
+  virtual double ToDouble() const {
+    return Inline ? DValue : mpfr_get_d(MPValue, MPFR_RNDN);
+  }
 
   virtual long double ToLongDouble() const {
+    if (Inline)
+      return static_cast<long double>(DValue);
+
     return mpfr_get_ld(MPValue, MPFR_RNDN);
   }
 
   virtual ASTMPIntegerNode *ToMPInteger() const {
     mpz_t ROP;
     mpz_init2(ROP, Bits + Bits / 2);
-    (void)mpfr_get_z(ROP, MPValue, MPFR_RNDN);
+    (void)mpfr_get_z(ROP, GetMPValue(), MPFR_RNDN);
 
     ASTMPIntegerNode *MPI = new ASTMPIntegerNode(
         ASTIdentifierNode::MPInt.Clone(), Bits + Bits / 2, ROP, false);
@@ -2274,44 +2422,7 @@ public:
   static int InitMPFRFromString(mpfr_t &MPV, const char *S, int Base = 10);
 
   virtual std::string GetValue(int Base) const {
-    if (IsNan())
-      return "NaN";
-    else if (IsZero())
-      return "0.0";
-    else if (IsInf())
-      return "Inf";
-
-    std::string R;
-    mpfr_exp_t E = 0;
-    char *S = mpfr_get_str(NULL, &E, Base, 0, MPValue, MPFR_RNDN);
-    if (S) {
-      std::stringstream SSR;
-      if (E) {
-        if (S[0] == u8'-' || S[0] == u8'+')
-          E += 1U;
-        SSR.write(S, (std::size_t)E);
-        SSR << u8'.';
-        const char *SP = S + (std::size_t)E;
-        SSR << SP;
-        R = SSR.str();
-      } else {
-        SSR << "0.";
-        if (Bits <= 32U)
-          SSR.write(S, 8U);
-        else if (Bits <= 64U)
-          SSR.write(S, 16U);
-        else if (Bits <= 128U)
-          SSR.write(S, 32U);
-        else
-          SSR.write(S, 34U);
-        R = SSR.str();
-      }
-
-      mpfr_free_str(S);
-    }
-
-    ASTStringUtils::Instance().SaneDecimal(R);
-    return R;
+    return ASTMPFormatter::ToString(GetMPValue(), Base, Bits);
   }
 
   virtual std::string GetValue(const char *Format) const {
@@ -2326,7 +2437,7 @@ public:
     char S[1024];
     (void)memset(S, 0, sizeof(S));
 
-    if (mpfr_sprintf(S, Format, MPValue) < 0)
+    if (mpfr_sprintf(S, Format, GetMPValue()) < 0)
       return R;
 
     R = S;
@@ -2346,6 +2457,7 @@ public:
   }
 
   virtual bool SetValue(const char *String, int Base = 10) {
+    Materialize();
     if (mpfr_set_str(MPValue, String, Base, MPFR_RNDN) != 0) {
       mpfr_set_nan(MPValue);
       return false;
@@ -2370,10 +2482,13 @@ public:
     return ASTExpressionNode::Ident->GetName();
   }
 
-  virtual const mpfr_t &GetMPValue() const { return MPValue; }
+  virtual const mpfr_t &GetMPValue() const {
+    Materialize();
+    return MPValue;
+  }
 
   virtual bool GetMPValue(mpfr_t &Out) {
-    if (mpfr_set(Out, MPValue, MPFR_RNDN) != 0) {
+    if (mpfr_set(Out, GetMPValue(), MPFR_RNDN) != 0) {
       mpfr_set_nan(Out);
       return false;
     }
@@ -2910,6 +3025,8 @@ private:
   const ASTExpressionNode *Left;
   const ASTExpressionNode *Right;
   mutable ASTImaginaryNode *IM;
+  mutable ASTType ETy;
+  mutable unsigned ETG;
 
 private:
   ASTBinaryOpNode() = delete;
@@ -2920,14 +3037,16 @@ protected:
       : ASTExpressionNode(Id, new ASTStringNode(ERM), ASTTypeExpressionError),
         OpType(OT), EM(Arithmetic), Parens(false),
         SQP(OT == ASTOpTypeLogicalAnd || OT == ASTOpTypeLogicalOr),
-        Left(nullptr), Right(nullptr), IM(nullptr) {}
+        Left(nullptr), Right(nullptr), IM(nullptr),
+        ETy(ASTTypeUndefined), ETG(0U) {}
 
   ASTBinaryOpNode(const std::string &ERM, ASTOpType OT)
       : ASTExpressionNode(ASTIdentifierNode::BinaryOp.Clone(),
                           new ASTStringNode(ERM), ASTTypeExpressionError),
         OpType(OT), EM(Arithmetic), Parens(false),
         SQP(OT == ASTOpTypeLogicalAnd || OT == ASTOpTypeLogicalOr),
-        Left(nullptr), Right(nullptr), IM(nullptr) {}
+        Left(nullptr), Right(nullptr), IM(nullptr),
+        ETy(ASTTypeUndefined), ETG(0U) {}
 
 public:
   static const unsigned BinaryOpBits = 64U;
@@ -2939,7 +3058,7 @@ public:
       : ASTExpressionNode(this, Identifier, ASTTypeBinaryOp), OpType(OT),
         EM(Arithmetic), Parens(false),
         SQP(OT == ASTOpTypeLogicalAnd || OT == ASTOpTypeLogicalOr), Left(LHS),
-        Right(RHS), IM(nullptr) {}
+        Right(RHS), IM(nullptr), ETy(ASTTypeUndefined), ETG(0U) {}
 
   virtual ~ASTBinaryOpNode() = default;
 
@@ -2949,8 +3068,17 @@ public:
     return SemaTypeExpression;
   }
 
+  // The type of the result of the operation. It is cached on the node:
+  // the operands never change, and the cached type is recomputed if the
+  // type of a symbol has been changed since (see ASTIdentifierNode::
+  // GetTypeGeneration). Implemented in ASTBinaryOp.cpp.
   virtual ASTType GetExpressionType() const;
 
+  virtual bool HasExpressionType() const {
+    return ETy != ASTTypeUndefined &&
+           ETG == ASTIdentifierNode::GetTypeGeneration();
+  }
+
   virtual ASTEvaluationMethod GetEvalMethod() const { return EM; }
 
   virtual void Mangle() override;
@@ -3112,6 +3240,12 @@ public:
   // Implemented in ASTBinaryOp.cpp.
   virtual ASTType GetExpressionType() const;
 
+  // The type of the operand is resolved in place by GetExpressionType.
+  virtual bool HasExpressionType() const {
+    return RTy != ASTTypeBinaryOp && RTy != ASTTypeUnaryOp &&
+           RTy != ASTTypeOpTy && RTy != ASTTypeOpndTy;
+  }
+
   virtual bool GetIsLValue() const { return IsLValue; }
 
   virtual void SetIsLValue(bool LV = true) const { IsLValue = LV; }
@@ -5631,7 +5765,11 @@ protected:
 
 protected:
   unsigned Bits;
-  mpfr_t MPValue;
+  // Angles built from a native number keep it in DV, and only create
+  // MPValue when it is asked for. MPL tells whether MPValue exists.
+  mutable mpfr_t MPValue;
+  double DV = std::numeric_limits<double>::quiet_NaN();
+  mutable bool MPL = false;
   union {
     const ASTIntNode *I;
     const ASTFloatNode *F;
@@ -5667,6 +5805,16 @@ protected:
     IR[IX] = PV;
   }
 
+  mpfr_t &MP() const {
+    if (!MPL) {
+      mpfr_init2(MPValue, std::max<mpfr_prec_t>(Bits, MPFR_PREC_MIN));
+      mpfr_set_d(MPValue, DV, MPFR_RNDN);
+      MPL = true;
+    }
+
+    return MPValue;
+  }
+
   ASTAngleNode(const ASTIdentifierNode *Id, const std::string &ERM)
       : ASTExpressionNode(Id, new ASTStringNode(ERM), ASTTypeExpressionError),
         Bits(0U), MPValue(), I(nullptr), IR(), IIR(), BST(), GateParamName(),
@@ -5689,8 +5837,6 @@ public:
         I(nullptr), IR(), IIR(), BST(), GateParamName(), NC(CNone), Hash(0UL),
         ICE(nullptr), ExprType(ASTTypeUndefined), AngleType(ATy) {
     Id->SetBits(NumBits);
-    mpfr_init2(MPValue, Bits);
-    mpfr_set_nan(MPValue);
     Hash = std::hash<std::string>{}(Id->GetName());
     IR.fill(0UL);
     IIR.fill(nullptr);
@@ -5703,6 +5849,7 @@ public:
         ICE(nullptr), ExprType(ASTTypeMPDecimal), AngleType(ATy) {
     Id->SetBits(NumBits);
     mpfr_init2(MPValue, Bits);
+    MPL = true;
     // MPFR_RNDN == round-to-nearest. This is IEEE-754 compliant.
     if (mpfr_set(MPValue, MPV, MPFR_RNDN) != 0) {
       mpfr_set_d(MPValue, 0.0, MPFR_RNDD);
@@ -5722,6 +5869,7 @@ public:
         ICE(nullptr), ExprType(ASTTypeMPDecimal), AngleType(ATy) {
     Id->SetBits(NumBits);
     mpfr_init2(MPValue, Bits);
+    MPL = true;
     // MPFR_RNDN == round-to-nearest. This is IEEE-754 compliant.
     if (mpfr_set_str(MPValue, String.c_str(), Base, MPFR_RNDN) != 0) {
       mpfr_set_d(MPValue, 0.0, MPFR_RNDN);
@@ -5741,8 +5889,6 @@ public:
         I(nullptr), IR(), IIR(), BST(), GateParamName(), NC(CNone), Hash(0UL),
         ICE(nullptr), ExprType(ASTTypeArray), AngleType(ATy) {
     Id->SetBits(NumBits);
-    mpfr_init2(MPValue, Bits);
-    mpfr_set_nan(MPValue);
     Hash = std::hash<std::string>{}(Id->GetName());
     IR[0] = W;
     IR[1] = X;
@@ -5759,8 +5905,6 @@ public:
         ExprType(E->GetASTType()), AngleType(ATy) {
     assert(E && "Invalid ASTBinaryOpNode argument!");
     Id->SetBits(NumBits);
-    mpfr_init2(MPValue, Bits);
-    mpfr_set_nan(MPValue);
     Hash = std::hash<std::string>{}(Id->GetName());
     IR.fill(0UL);
     IIR.fill(nullptr);
@@ -5774,8 +5918,6 @@ public:
         ExprType(E->GetASTType()), AngleType(ATy) {
     assert(E && "Invalid ASTUnaryOpNode argument!");
     Id->SetBits(NumBits);
-    mpfr_init2(MPValue, Bits);
-    mpfr_set_nan(MPValue);
     Hash = std::hash<std::string>{}(Id->GetName());
     IR.fill(0UL);
     IIR.fill(nullptr);
@@ -5790,6 +5932,7 @@ public:
     assert(E && "Invalid ASTMPIntegerNode argument!");
     Id->SetBits(NumBits);
     mpfr_init2(MPValue, Bits);
+    MPL = true;
     // MPFR_RNDN == round to nearest.
     mpfr_set_z(MPValue, E->GetMPValue(), MPFR_RNDN);
     Hash = std::hash<std::string>{}(Id->GetName());
@@ -5806,6 +5949,7 @@ public:
     assert(E && "Invalid ASTMPDecimalNode argument!");
     Id->SetBits(NumBits);
     mpfr_init2(MPValue, Bits);
+    MPL = true;
     // MPFR_RNDN == round to nearest.
     mpfr_set(MPValue, E->GetMPValue(), MPFR_RNDN);
     Hash = std::hash<std::string>{}(Id->GetName());
@@ -5821,12 +5965,8 @@ public:
         ExprType(E->GetASTType()), AngleType(ATy) {
     assert(E && "Invalid ASTIntNode argument!");
     Id->SetBits(NumBits);
-    mpfr_init2(MPValue, Bits);
-    // MPFR_RNDN == round to nearest.
-    mpfr_set_d(MPValue,
-               E->IsSigned() ? static_cast<double>(E->GetSignedValue())
-                             : static_cast<double>(E->GetUnsignedValue()),
-               MPFR_RNDN);
+    DV = E->IsSigned() ? static_cast<double>(E->GetSignedValue())
+                       : static_cast<double>(E->GetUnsignedValue());
     Hash = std::hash<std::string>{}(Id->GetName());
     IR.fill(0UL);
     IIR.fill(nullptr);
@@ -5840,9 +5980,7 @@ public:
         ExprType(E->GetASTType()), AngleType(ATy) {
     assert(E && "Invalid ASTFloatNode argument!");
     Id->SetBits(NumBits);
-    mpfr_init2(MPValue, Bits);
-    // MPFR_RNDN == round to nearest.
-    mpfr_set_flt(MPValue, E->GetValue(), MPFR_RNDN);
+    DV = E->GetValue();
     Hash = std::hash<std::string>{}(Id->GetName());
     IR.fill(0UL);
     IIR.fill(nullptr);
@@ -5856,9 +5994,7 @@ public:
         ExprType(E->GetASTType()), AngleType(ATy) {
     assert(E && "Invalid ASTDoubleNode argument!");
     Id->SetBits(NumBits);
-    mpfr_init2(MPValue, Bits);
-    // MPFR_RNDN == round to nearest.
-    mpfr_set_d(MPValue, E->GetValue(), MPFR_RNDN);
+    DV = E->GetValue();
     Hash = std::hash<std::string>{}(Id->GetName());
     IR.fill(0UL);
     IIR.fill(nullptr);
@@ -5872,6 +6008,7 @@ public:
     assert(E && "Invalid ASTDoubleNode argument!");
     Id->SetBits(NumBits);
     mpfr_init2(MPValue, Bits);
+    MPL = true;
     // MPFR_RNDN == round to nearest.
     mpfr_set_ld(MPValue, E->GetValue(), MPFR_RNDN);
     Hash = std::hash<std::string>{}(Id->GetName());
@@ -5887,8 +6024,6 @@ public:
         ExprType(E->GetASTType()), AngleType(ATy) {
     assert(E && "Invalid ASTDoubleNode argument!");
     Id->SetBits(NumBits);
-    mpfr_init2(MPValue, Bits);
-    mpfr_set_nan(MPValue);
     Hash = std::hash<std::string>{}(Id->GetName());
     IR.fill(0UL);
     IIR.fill(nullptr);
@@ -5901,9 +6036,7 @@ public:
         D(nullptr), IR(), IIR(), BST(), GateParamName(), NC(CNone), Hash(0UL),
         ICE(nullptr), ExprType(ASTTypeDouble), AngleType(ATy) {
     Id->SetBits(NumBits);
-    mpfr_init2(MPValue, Bits);
-    // MPFR_RNDN == round to nearest.
-    mpfr_set_d(MPValue, DD, MPFR_RNDN);
+    DV = DD;
     Hash = std::hash<std::string>{}(Id->GetName());
     IR.fill(0UL);
     IIR.fill(nullptr);
@@ -5917,6 +6050,7 @@ public:
         ICE(nullptr), ExprType(ASTTypeDouble), AngleType(ATy) {
     Id->SetBits(NumBits);
     mpfr_init2(MPValue, Bits);
+    MPL = true;
     // MPFR_RNDN == round to nearest.
     mpfr_set_ld(MPValue, LLD, MPFR_RNDN);
     Hash = std::hash<std::string>{}(Id->GetName());
@@ -5924,11 +6058,15 @@ public:
     IIR.fill(nullptr);
   }
 
-  virtual ~ASTAngleNode() { mpfr_clear(MPValue); }
+  virtual ~ASTAngleNode() {
+    if (MPL)
+      mpfr_clear(MPValue);
+  }
 
   virtual ASTAngleNode *Clone(const ASTIdentifierNode *Id) const {
     ASTAngleNode *R =
-        new ASTAngleNode(Id, GetBits(), GetMPValue(), GetAngleType());
+        MPL ? new ASTAngleNode(Id, GetBits(), GetMPValue(), GetAngleType())
+            : new ASTAngleNode(Id, DV, GetAngleType(), GetBits());
     assert(R && "Could not create a valid ASTAngleNode clone!");
 
     R->ExprType = ExprType;
@@ -5970,7 +6108,7 @@ public:
     R->GateParamName = GateParamName;
     R->NC = NC;
     R->ICE = ICE;
-    mpfr_set(R->MPValue, MPValue, MPFR_RNDN);
+    mpfr_set(R->MP(), MP(), MPFR_RNDN);
   }
 
   virtual ASTType GetASTType() const override { return ASTTypeAngle; }
@@ -6064,61 +6202,42 @@ public:
     return I == ATM.end() ? ASTAngleTypeGeneric : (*I).second;
   }
 
-  virtual bool IsNan() const { return mpfr_nan_p(MPValue) != 0; }
+  // True if the value is held inline rather than in an MPFR number.
+  virtual bool IsInline() const { return !MPL; }
 
-  virtual bool IsInf() const { return mpfr_inf_p(MPValue) != 0; }
+  virtual bool IsNan() const {
+    return MPL ? mpfr_nan_p(MPValue) != 0 : std::isnan(DV);
+  }
 
-  virtual bool IsZero() const { return mpfr_zero_p(MPValue) != 0; }
+  virtual bool IsInf() const {
+    return MPL ? mpfr_inf_p(MPValue) != 0 : std::isinf(DV);
+  }
 
-  virtual bool IsNegative() const { return mpfr_sgn(MPValue) < 0; }
+  virtual bool IsZero() const {
+    return MPL ? mpfr_zero_p(MPValue) != 0 : DV == 0.0;
+  }
 
-  virtual bool IsPositive() const { return mpfr_sgn(MPValue) > 0; }
+  virtual bool IsNegative() const {
+    return MPL ? mpfr_sgn(MPValue) < 0 : DV < 0.0;
+  }
+
+  virtual bool IsPositive() const {
+    return MPL ? mpfr_sgn(MPValue) > 0 : DV > 0.0;
+  }
 
   // return true if MPValue is neither NaN nor Inf.
-  virtual bool IsNumber() const { return mpfr_number_p(MPValue) != 0; }
+  virtual bool IsNumber() const {
+    return MPL ? mpfr_number_p(MPValue) != 0 : std::isfinite(DV);
+  }
 
   // return true if MPValue is neither NaN nor Inf nor Zero.
-  virtual bool IsRegular() const { return mpfr_regular_p(MPValue) != 0; }
+  virtual bool IsRegular() const {
+    return MPL ? mpfr_regular_p(MPValue) != 0
+               : std::isfinite(DV) && DV != 0.0;
+  }
 
   virtual std::string GetValue() const {
-    if (IsNan())
-      return "NaN";
-    else if (IsZero())
-      return "0.0";
-    else if (IsInf())
-      return "Inf";
-
-    std::string R;
-    mpfr_exp_t E = 0;
-    char *S = mpfr_get_str(NULL, &E, 10, 0, MPValue, MPFR_RNDN);
-    if (S) {
-      std::stringstream SSR;
-      if (E) {
-        if (S[0] == u8'-' || S[0] == u8'+')
-          E += 1U;
-        SSR.write(S, (std::size_t)E);
-        SSR << u8'.';
-        const char *SP = S + (std::size_t)E;
-        SSR << SP;
-        R = SSR.str();
-      } else {
-        SSR << "0.";
-        if (Bits <= 32U)
-          SSR.write(S, 8U);
-        else if (Bits <= 64U)
-          SSR.write(S, 16U);
-        else if (Bits <= 128U)
-          SSR.write(S, 32U);
-        else
-          SSR.write(S, 34U);
-        R = SSR.str();
-      }
-
-      mpfr_free_str(S);
-    }
-
-    ASTStringUtils::Instance().SaneDecimal(R);
-    return R;
+    return ASTMPFormatter::ToString(MP(), 10, Bits);
   }
 
   virtual std::string GetValue(std::size_t Sz, const char *Fmt) const {
@@ -6130,14 +6249,14 @@ public:
       return "Inf";
 
     char S[Sz + 1];
-    mpfr_sprintf(S, Fmt, MPValue);
+    mpfr_sprintf(S, Fmt, MP());
     std::string R = S;
     return R;
   }
 
   virtual std::string GetNanString() const {
     char S[4];
-    mpfr_sprintf(S, "%RNf", MPValue);
+    mpfr_sprintf(S, "%RNf", MP());
     S[0] = std::toupper(S[0]);
     S[2] = std::toupper(S[2]);
     std::string R = S;
@@ -6146,15 +6265,15 @@ public:
 
   virtual std::string GetInfString() const {
     char S[4];
-    mpfr_sprintf(S, "%RNf", MPValue);
+    mpfr_sprintf(S, "%RNf", MP());
     S[0] = std::toupper(S[0]);
     std::string R = S;
     return R;
   }
 
-  virtual mpfr_t &GetMPValue() { return MPValue; }
+  virtual mpfr_t &GetMPValue() { return MP(); }
 
-  virtual const mpfr_t &GetMPValue() const { return MPValue; }
+  virtual const mpfr_t &GetMPValue() const { return MP(); }
 
   virtual std::string GetValue(int Base) const {
     std::string R;
@@ -6168,7 +6287,7 @@ public:
         R = "Inf";
       } else {
         mpfr_exp_t E = 0;
-        const char *C = mpfr_get_str(NULL, &E, Base, 64, MPValue, MPFR_RNDN);
+        const char *C = mpfr_get_str(NULL, &E, Base, 64, MP(), MPFR_RNDN);
         R = C ? C : "";
       }
     }
@@ -6177,21 +6296,21 @@ public:
   }
 
   virtual ASTMPDecimalNode *AsMPDecimal() const {
-    return new ASTMPDecimalNode(&ASTIdentifierNode::MPDec, Bits, MPValue);
+    return new ASTMPDecimalNode(&ASTIdentifierNode::MPDec, Bits, MP());
   }
 
-  virtual float AsFloat() const { return mpfr_get_flt(MPValue, MPFR_RNDN); }
+  virtual float AsFloat() const { return mpfr_get_flt(MP(), MPFR_RNDN); }
 
   virtual ASTFloatNode *AsASTFloatNode() const {
     return new ASTFloatNode(&ASTIdentifierNode::Float,
-                            mpfr_get_flt(MPValue, MPFR_RNDN));
+                            mpfr_get_flt(MP(), MPFR_RNDN));
   }
 
-  virtual double AsDouble() const { return mpfr_get_d(MPValue, MPFR_RNDN); }
+  virtual double AsDouble() const { return mpfr_get_d(MP(), MPFR_RNDN); }
 
   virtual ASTDoubleNode *AsASTDoubleNode() const {
     return new ASTDoubleNode(&ASTIdentifierNode::Double,
-                             mpfr_get_d(MPValue, MPFR_RNDN));
+                             mpfr_get_d(MP(), MPFR_RNDN));
   }
 
   virtual std::bitset<64> &AsBitset() {
@@ -6200,7 +6319,7 @@ public:
     if (Bits > 64) {
       mpfr_t MPT;
       mpfr_init2(MPT, 64);
-      (void)mpfr_set(MPT, MPValue, MPFR_RNDN);
+      (void)mpfr_set(MPT, MP(), MPFR_RNDN);
 
       if (char *S = mpfr_get_str(NULL, &E, 2, 0, MPT, MPFR_RNDN)) {
         BST = std::bitset<64>(S);
@@ -6208,7 +6327,7 @@ public:
       }
 
       mpfr_clear(MPT);
-    } else if (char *S = mpfr_get_str(NULL, &E, 2, 0, MPValue, MPFR_RNDN)) {
+    } else if (char *S = mpfr_get_str(NULL, &E, 2, 0, MP(), MPFR_RNDN)) {
       BST = std::bitset<64>(S);
       mpfr_free_str(S);
     }
@@ -6222,7 +6341,7 @@ public:
     if (Bits > ASTAngleNode::AngleBits) {
       mpfr_t MPT;
       mpfr_init2(MPT, ASTAngleNode::AngleBits);
-      (void)mpfr_set(MPT, MPValue, MPFR_RNDN);
+      (void)mpfr_set(MPT, MP(), MPFR_RNDN);
 
       if (char *S = mpfr_get_str(NULL, &E, 2, 0, MPT, MPFR_RNDN)) {
         BST = std::bitset<ASTAngleNode::AngleBits>(S);
@@ -6230,7 +6349,7 @@ public:
       }
 
       mpfr_clear(MPT);
-    } else if (char *S = mpfr_get_str(NULL, &E, 2, 0, MPValue, MPFR_RNDN)) {
+    } else if (char *S = mpfr_get_str(NULL, &E, 2, 0, MP(), MPFR_RNDN)) {
       BST = std::bitset<64>(S);
       mpfr_free_str(S);
     }
@@ -6253,8 +6372,8 @@ public:
   }
 
   virtual bool SetValue(const char *String, int Base = 10) {
-    if (mpfr_set_str(MPValue, String, Base, MPFR_RNDN) != 0) {
-      mpfr_set_d(MPValue, 0.0, MPFR_RNDN);
+    if (mpfr_set_str(MP(), String, Base, MPFR_RNDN) != 0) {
+      mpfr_set_d(MP(), 0.0, MPFR_RNDN);
       Bits = 0;
       return false;
     }
@@ -6293,8 +6412,8 @@ public:
 
   virtual bool SetValue(const mpfr_t &Value) {
     ExprType = ASTTypeMPDecimal;
-    if (mpfr_set(MPValue, Value, MPFR_RNDN) != 0) {
-      mpfr_set_d(MPValue, 0.0, MPFR_RNDD);
+    if (mpfr_set(MP(), Value, MPFR_RNDN) != 0) {
+      mpfr_set_d(MP(), 0.0, MPFR_RNDD);
       Bits = 0;
       return false;
     }
@@ -6314,12 +6433,27 @@ public:
 
   virtual unsigned GetBits() const { return Bits; }
 
-  virtual void SetBits(unsigned B) { Bits = B; }
+  virtual void SetBits(unsigned B) {
+    // The precision of MPValue is fixed when it is created.
+    if (!MPL && std::isfinite(DV))
+      (void)MP();
+    Bits = B;
+  }
 
   virtual void SetGateParamName(const std::string &GPN) { GateParamName = GPN; }
 
   virtual ASTAngleType GetAngleType() const { return AngleType; }
 
+  // Returns the value of an angle[N], N <= 64, as the wrapped N-bit
+  // unsigned integer of the specification. Angles initialized from a
+  // constant expression are folded by ASTConstantFolder. Fails for wider
+  // angles and angles without a numeric value. Implemented in
+  // ASTAngleNodeBuilder.cpp.
+  virtual bool GetFixedPoint(ASTAngleFixedPoint &FP) const;
+
+  // Sets the value and the width of the angle from FP.
+  virtual void SetFixedPoint(const ASTAngleFixedPoint &FP);
+
   virtual bool HasImplicitConversion() const { return ICE != nullptr; }
 
   virtual void SetAngleType(ASTAngleType AT) { AngleType = AT; }
@@ -6387,6 +6521,11 @@ public:
               << std::endl;
     std::cout << "<Bits>" << std::dec << Bits << "</Bits>" << std::endl;
 
+    ASTAngleFixedPoint FP;
+    if (GetFixedPoint(FP))
+      std::cout << "<FixedPoint>0x" << std::hex << FP.GetWord() << std::dec
+                << "</FixedPoint>" << std::endl;
+
     if (!IR.empty()) {
       switch (IR.size()) {
       case 1:
@@ -24,6 +24,7 @@
 #include <qasm/AST/ASTTypes.h>
 
 #include <cassert>
+#include <complex>
 #include <iostream>
 #include <vector>
 
@@ -46,8 +47,14 @@ private:
   const ASTResultNode *FR;
   const ASTFunctionCallNode *FC;
   ASTMPComplexList CXV;
+  // Dense sample storage. Explicit samples that fit the waveform
+  // precision are packed here, and CXV is then left empty.
+  std::vector<std::complex<double>> SMP;
   unsigned TE;
 
+private:
+  static bool PS;
+
 private:
   ASTOpenPulseWaveformNode() = delete;
 
@@ -55,18 +62,24 @@ protected:
   ASTOpenPulseWaveformNode(const ASTIdentifierNode *Id, const std::string &EM)
       : ASTExpressionNode(Id, new ASTStringNode(EM), ASTTypeExpressionError),
         AMP(nullptr), D(nullptr), SQW(nullptr), SIG(nullptr), BTA(nullptr),
-        FRQ(nullptr), PHS(nullptr), FR(nullptr), FC(nullptr), CXV(),
+        FRQ(nullptr), PHS(nullptr), FR(nullptr), FC(nullptr), CXV(), SMP(),
         TE(static_cast<unsigned>(~0x0)) {}
 
 public:
   static const unsigned WaveformBits = 64U;
 
+  // Sample packing is off by default, so that GetSamples and GetComplex
+  // keep returning the multiple precision samples.
+  static void SetPackSamples(bool V) { PS = V; }
+
+  static bool GetPackSamples() { return PS; }
+
 public:
   ASTOpenPulseWaveformNode(const ASTIdentifierNode *Id,
                            const ASTMPComplexList &CV)
       : ASTExpressionNode(Id, ASTTypeOpenPulseWaveform), AMP(nullptr),
         D(nullptr), SQW(nullptr), SIG(nullptr), BTA(nullptr), FRQ(nullptr),
-        PHS(nullptr), FR(nullptr), FC(nullptr), CXV(CV), TE(0U) {}
+        PHS(nullptr), FR(nullptr), FC(nullptr), CXV(CV), SMP(), TE(0U) {}
 
   ASTOpenPulseWaveformNode(const ASTIdentifierNode *Id,
                            const ASTMPComplexNode *AMPC,
@@ -74,7 +87,7 @@ public:
                            const ASTDurationNode *SGM)
       : ASTExpressionNode(Id, ASTTypeOpenPulseWaveform), AMP(AMPC), D(DR),
         SQW(nullptr), SIG(SGM), BTA(nullptr), FRQ(nullptr), PHS(nullptr),
-        FR(nullptr), FC(nullptr), CXV(), TE(1U) {}
+        FR(nullptr), FC(nullptr), CXV(), SMP(), TE(1U) {}
 
   ASTOpenPulseWaveformNode(const ASTIdentifierNode *Id,
                            const ASTMPComplexNode *AMPC,
@@ -82,7 +95,7 @@ public:
                            const ASTDurationNode *SGM)
       : ASTExpressionNode(Id, ASTTypeOpenPulseWaveform), AMP(AMPC), D(DR),
         SQW(SW), SIG(SGM), BTA(nullptr), FRQ(nullptr), PHS(nullptr),
-        FR(nullptr), FC(nullptr), CXV(), TE(2U) {}
+        FR(nullptr), FC(nullptr), CXV(), SMP(), TE(2U) {}
 
   ASTOpenPulseWaveformNode(const ASTIdentifierNode *Id,
                            const ASTMPComplexNode *AMPC,
@@ -90,14 +103,14 @@ public:
                            const ASTMPDecimalNode *BT)
       : ASTExpressionNode(Id, ASTTypeOpenPulseWaveform), AMP(AMPC), D(DR),
         SQW(nullptr), SIG(nullptr), BTA(BT), FRQ(nullptr), PHS(nullptr),
-        FR(nullptr), FC(nullptr), CXV(), TE(3U) {}
+        FR(nullptr), FC(nullptr), CXV(), SMP(), TE(3U) {}
 
   ASTOpenPulseWaveformNode(const ASTIdentifierNode *Id,
                            const ASTMPComplexNode *AMPC,
                            const ASTDurationNode *DR)
       : ASTExpressionNode(Id, ASTTypeOpenPulseWaveform), AMP(AMPC), D(DR),
         SQW(nullptr), SIG(nullptr), BTA(nullptr), FRQ(nullptr), PHS(nullptr),
-        FR(nullptr), FC(nullptr), CXV(), TE(4U) {}
+        FR(nullptr), FC(nullptr), CXV(), SMP(), TE(4U) {}
 
   ASTOpenPulseWaveformNode(const ASTIdentifierNode *Id,
                            const ASTMPComplexNode *AMPC,
@@ -105,7 +118,7 @@ public:
                            const ASTMPDecimalNode *FQ, const ASTAngleNode *PH)
       : ASTExpressionNode(Id, ASTTypeOpenPulseWaveform), AMP(AMPC), D(DR),
         SQW(nullptr), SIG(nullptr), BTA(nullptr), FRQ(FQ), PHS(PH), FR(nullptr),
-        FC(nullptr), CXV(), TE(5U) {}
+        FC(nullptr), CXV(), SMP(), TE(5U) {}
 
   virtual ~ASTOpenPulseWaveformNode() = default;
 
@@ -141,7 +154,23 @@ public:
 
   virtual void SetPhase(const ASTAngleNode *V) { PHS = V; }
 
-  virtual void SetSamples(const ASTMPComplexList &CV) { CXV = CV; }
+  virtual void SetSamples(const ASTMPComplexList &CV) {
+    CXV = CV;
+    SMP.clear();
+  }
+
+  virtual void
+  SetSampleBuffer(const std::vector<std::complex<double>> &S) {
+    SMP = S;
+  }
+
+  // If sample packing is enabled, moves the explicit samples into the
+  // dense sample buffer, and releases the sample nodes the waveform
+  // owns. Samples that are not constants, that reference a complex
+  // declared wider than WaveformBits, or that are not exactly
+  // representable as double, keep the multiple precision representation.
+  // Returns true if the samples were packed.
+  virtual bool PackSamples();
 
   virtual void SetFunctionResult(const ASTResultNode *RN) { FR = RN; }
 
@@ -163,8 +192,22 @@ public:
 
   virtual const ASTMPComplexList &GetSamples() const { return CXV; }
 
+  virtual const std::vector<std::complex<double>> &GetSampleBuffer() const {
+    return SMP;
+  }
+
+  virtual bool IsDense() const { return !SMP.empty(); }
+
+  virtual std::size_t GetNumSamples() const {
+    return SMP.empty() ? CXV.Size() : SMP.size();
+  }
+
+  virtual std::complex<double> GetSample(unsigned Index) const;
+
+  // Returns nullptr for packed samples. Use GetSample instead, which
+  // works for either representation.
   virtual const ASTMPComplexNode *GetComplex(unsigned Index) const {
-    return CXV.GetComplex(Index);
+    return SMP.empty() ? CXV.GetComplex(Index) : nullptr;
   }
 
   virtual const ASTResultNode *GetFunctionResult() const { return FR; }
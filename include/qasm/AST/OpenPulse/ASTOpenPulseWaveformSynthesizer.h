@@ -0,0 +1,195 @@
+/* -*- coding: utf-8 -*-
+ *
+ * Copyright 2023 IBM RESEARCH. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#ifndef __QASM_AST_OPENPULSE_WAVEFORM_SYNTHESIZER_H
+#define __QASM_AST_OPENPULSE_WAVEFORM_SYNTHESIZER_H
+
+#include <qasm/AST/ASTTypeEnums.h>
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace QASM {
+
+class ASTBase;
+class ASTDurationNode;
+class ASTFunctionCallNode;
+
+namespace OpenPulse {
+
+class ASTOpenPulseWaveformNode;
+
+// Generates the samples of the OpenPulse parametric waveforms.
+//
+// All times are expressed in samples (multiples of dt), and the
+// frequency of a sine in cycles per sample. Sample k is taken at
+// t = k, for 0 <= k < round(Duration). Durations that are not
+// expressed in dt, and the frequency of a sine, which is expressed in
+// Hz, are converted with the dt of the ASTDurationTimeBase.
+//
+// Every envelope sample is computed in closed form from its index,
+// so the envelope loops carry no dependency from one sample to the
+// next. Waveforms longer than MaxSamples are not synthesized.
+//
+// Results are memoized by parameter tuple, up to MaxCacheBytes of
+// samples. The memo is cleared for every parse.
+//
+// The samples of calls to the extern waveform functions are only
+// synthesized if SetSynthesizeExterns(true) was called.
+class ASTOpenPulseWaveformSynthesizer {
+public:
+  enum Shape : unsigned {
+    ShapeConstant = 0,
+    ShapeGaussian,
+    ShapeGaussianSquare,
+    ShapeDrag,
+    ShapeSech,
+    ShapeSine,
+    ShapeUnknown,
+  };
+
+  struct Parameters {
+    Shape S = ShapeUnknown;
+    std::complex<double> Amp;
+    double Duration = 0.0;
+    double Sigma = 0.0;
+    double Width = 0.0;
+    double Beta = 0.0;
+    double Frequency = 0.0;
+    double Phase = 0.0;
+
+    bool operator==(const Parameters &RHS) const {
+      return S == RHS.S && Amp == RHS.Amp && Duration == RHS.Duration &&
+             Sigma == RHS.Sigma && Width == RHS.Width && Beta == RHS.Beta &&
+             Frequency == RHS.Frequency && Phase == RHS.Phase;
+    }
+  };
+
+  using sample_type = std::complex<double>;
+  using buffer_type = std::vector<sample_type>;
+
+  static const std::size_t MaxSamples = 1U << 22;
+
+  static const std::size_t MaxCacheBytes = 64U << 20;
+
+private:
+  struct ParametersHash {
+    std::size_t operator()(const Parameters &P) const {
+      std::hash<double> H;
+      std::size_t R = static_cast<std::size_t>(P.S);
+      for (double V : {P.Amp.real(), P.Amp.imag(), P.Duration, P.Sigma,
+                       P.Width, P.Beta, P.Frequency, P.Phase})
+        R ^= H(V) + 0x9e3779b9 + (R << 6) + (R >> 2);
+      return R;
+    }
+  };
+
+  using cache_map = std::unordered_map<Parameters, buffer_type, ParametersHash>;
+
+private:
+  static ASTOpenPulseWaveformSynthesizer WFS;
+  static bool SE;
+  cache_map Cache;
+  // Holds the last result that was too large for the memo.
+  buffer_type Uncached;
+  std::size_t Bytes;
+  std::size_t Hits;
+  std::size_t Misses;
+
+protected:
+  ASTOpenPulseWaveformSynthesizer()
+      : Cache(), Uncached(), Bytes(0), Hits(0), Misses(0) {}
+
+  static void GaussianEnvelope(double *Out, std::size_t N, double T0,
+                               double Sigma);
+
+  static void SechEnvelope(double *Out, std::size_t N, double T0,
+                           double Sigma);
+
+  static void SineEnvelope(double *Out, std::size_t N, double Frequency,
+                           double Phase);
+
+  static bool Generate(const Parameters &P, buffer_type &Out);
+
+  static bool DurationInSamples(const ASTDurationNode *D, double &Samples);
+
+  static bool SamplePeriod(double &SP);
+
+  static bool RealArgument(const ASTBase *X, double &V);
+
+  static bool ComplexArgument(const ASTBase *X, sample_type &V);
+
+public:
+  static ASTOpenPulseWaveformSynthesizer &Instance() { return WFS; }
+
+  ~ASTOpenPulseWaveformSynthesizer() = default;
+
+  static void SetSynthesizeExterns(bool V) { SE = V; }
+
+  static bool GetSynthesizeExterns() { return SE; }
+
+  static Shape ShapeFromName(const std::string &Name);
+
+  static const char *PrintShape(Shape S);
+
+  // Returns the samples for P. The reference stays valid until the next
+  // call to Synthesize or Clear. Returns nullptr if P is invalid.
+  const buffer_type *Synthesize(const Parameters &P);
+
+  // Fills P from a parametric waveform node.
+  bool GetParameters(const ASTOpenPulseWaveformNode *WF, Shape S,
+                     Parameters &P) const;
+
+  bool Synthesize(const ASTOpenPulseWaveformNode *WF, Shape S,
+                  buffer_type &Out);
+
+  // Fills P from a call to one of the constant, gaussian,
+  // gaussian_square, drag, sech or sine extern waveform functions.
+  // Returns false, without a diagnostic, if FC calls anything else or
+  // if one of its arguments is not a constant.
+  bool GetParameters(const ASTFunctionCallNode *FC, Parameters &P) const;
+
+  // Synthesizes the samples of the waveform returned by FC. Returns
+  // false if FC is not a call GetParameters accepts, and emits a
+  // warning if it is one, with invalid parameters or a duration over
+  // MaxSamples.
+  bool Synthesize(const ASTFunctionCallNode *FC, buffer_type &Out);
+
+  std::size_t GetCacheHits() const { return Hits; }
+
+  std::size_t GetCacheMisses() const { return Misses; }
+
+  std::size_t GetCacheSize() const { return Cache.size(); }
+
+  std::size_t GetCacheBytes() const { return Bytes; }
+
+  void Clear() {
+    cache_map().swap(Cache);
+    buffer_type().swap(Uncached);
+    Bytes = Hits = Misses = 0;
+  }
+};
+
+} // namespace OpenPulse
+} // namespace QASM
+
+#endif // __QASM_AST_OPENPULSE_WAVEFORM_SYNTHESIZER_H
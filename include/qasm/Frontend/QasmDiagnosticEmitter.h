@@ -55,6 +55,16 @@ public:
 
   static void SetHandler(QasmDiagnosticHandler handler) { Handler = handler; }
 
+  static QasmDiagnosticHandler GetHandler() { return Handler; }
+
+  // Sets the counters back to earlier values, when the diagnostics that
+  // were counted since have been discarded.
+  static void ResetCounters(unsigned E, unsigned W, unsigned I) {
+    ErrCounter = E;
+    WarnCounter = W;
+    ICECounter = I;
+  }
+
   bool HasErrors() const { return ErrCounter > 0; }
 
   bool HasWarnings() const { return WarnCounter > 0; }
@@ -63,6 +73,8 @@ public:
 
   unsigned GetNumWarnings() const { return WarnCounter; }
 
+  unsigned GetNumICEs() const { return ICECounter; }
+
   bool CanEmit() const { return ICECounter < 1 && ErrCounter < MaxErrors; }
 
   void EmitDiagnostic(ASTLocation Loc, const std::string &Msg,
@@ -20,21 +20,83 @@
 #define __QASM_AST_PARSER_H
 
 #include <qasm/AST/ASTRoot.h>
+#include <qasm/AST/ASTStatementBuilder.h>
 #include <qasm/QPP/QasmPP.h>
 
+#include <functional>
 #include <iostream>
 #include <string>
+#include <vector>
 
 namespace QASM {
 
 class ASTParser {
+private:
+  static bool FastPath;
+  static bool FastPass;
+
+private:
+  ASTRoot *ParseInput(std::istream *IS);
+  ASTRoot *ParseInput(const std::string &IS);
+  ASTRoot *ParseFast(const std::function<ASTRoot *()> &Parse);
+  ASTRoot *ParseWithFastPath(std::istream *IS);
+  ASTRoot *ParseWithFastPath(const std::string &IS);
+  ASTRoot *ParseWithBudget(const std::function<ASTRoot *()> &Parse);
+
 public:
   ASTParser() {}
   virtual ~ASTParser() = default;
 
-  void ParseCommandLineArguments(int argc, char *const argv[]);
+  // Returns false if an option has an invalid value.
+  bool ParseCommandLineArguments(int argc, char *const argv[]);
+
+  // When a limit of the ASTParseBudget is set, a parse that goes over it
+  // is abandoned: the AST and the symbol table are released, an error is
+  // emitted, and nullptr is returned. The ASTObjectTracker is enabled for
+  // the parse if it is not, and an AST that is returned is then handed
+  // over unmanaged.
   ASTRoot *ParseAST(std::istream *IS = nullptr);
   ASTRoot *ParseAST(const std::string &IS);
+
+  // Parses like ParseAST, but hands every top-level statement to CB as
+  // soon as its production is reduced, instead of collecting it in the
+  // statement list of the ASTRoot. The statements nested in it, and the
+  // declarations it contains, are handed out before it, in the order
+  // ParseAST would have listed them. The OPENQASM version statement comes
+  // first. The ASTRoot that is returned has an empty statement list.
+  // When the ASTObjectTracker is enabled, the nodes of a quantum operation
+  // are deleted as soon as CB returns: CB must not keep them. See
+  // ASTStatementBuilder::Flush().
+  ASTRoot *StreamAST(const ASTStatementBuilder::stream_callback &CB,
+                     std::istream *IS = nullptr);
+
+  // Parses S as a run of top-level statements of the program that was
+  // parsed last, which starts at line L and column C of its source. The
+  // symbol table, the declaration contexts and the statement list of
+  // that program are kept: the statements of S are returned in V, with
+  // their boundaries in BV, and are not added to the list. Nothing is
+  // preprocessed. Returns false if the parser fails; the diagnostics it
+  // emits must be checked by the caller.
+  bool ParseFragment(const std::string &S, unsigned L, unsigned C,
+                     ASTStatementBuilder::list_type &V,
+                     std::vector<ASTStatementBuilder::Boundary> &BV);
+
+  // With the fast path, ParseAST first parses without the lookahead
+  // correction (LAC) of the generated parser, and holds the diagnostics
+  // back. The warnings are emitted once that parse succeeds. If it
+  // reports an error instead, it is abandoned, the AST and the symbol
+  // table are released, and the input is parsed again with LAC, which
+  // emits the same diagnostics as a parse without the fast path.
+  //
+  // The fast path is taken only if the ASTObjectTracker is enabled, the
+  // input is a file or a seekable stream, and the statements are not
+  // streamed.
+  static void SetFastPath(bool V) { FastPath = V; }
+
+  static bool IsFastPath() { return FastPath; }
+
+  // True during the first parse of the fast path.
+  static bool InFastPass() { return FastPass; }
 };
 
 } // namespace QASM
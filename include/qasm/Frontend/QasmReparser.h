@@ -0,0 +1,157 @@
+/* -*- coding: utf-8 -*-
+ *
+ * Copyright 2023 IBM RESEARCH. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#ifndef __QASM_AST_REPARSER_H
+#define __QASM_AST_REPARSER_H
+
+#include <qasm/AST/ASTRoot.h>
+#include <qasm/Frontend/QasmDiagnosticEmitter.h>
+#include <qasm/Frontend/QasmParser.h>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace QASM {
+
+// Re-parsing of an edited source buffer.
+//
+// The reparser keeps the source of the last parse, and the byte ranges
+// of its top-level statements. An edit is mapped to the statements that
+// enclose it, and only the text between the statement boundaries around
+// the edit is re-lexed. Then, in order:
+//
+// - If the edit leaves the tokens of that text, the lines they are on
+//   and their columns unchanged -- an edit of whitespace or of a comment
+//   -- the AST, the symbol table and the diagnostics of the last parse
+//   are kept as they are (Reused).
+//
+// - If the edit is inside a single top-level statement that is a
+//   quantum operation other than a measurement, which is the last
+//   statement on its line, and the edited statement is still one such
+//   operation on the same lines, only that statement is parsed again,
+//   against the symbol table of the last parse. Its statements replace
+//   the old ones in the statement list of the AST (Spliced). Nothing
+//   parsed later can refer to such a statement, and parsing it does not
+//   add to the symbol table, so the rest of the AST is still valid. The
+//   nodes of the old statement are kept until the next full parse.
+//   The program must not include other files, and its last full parse
+//   must not have reported an error.
+//
+// - Otherwise, the whole buffer is parsed again from the start (Parsed).
+//   The symbol table, the declaration contexts and the builders of the
+//   parser are global, and are rebuilt from the start of the translation
+//   unit.
+//
+// Every full parse releases the AST, the symbol table, the tokens and
+// the builders of the previous one, through the ASTObjectTracker. The
+// tracker is enabled for the parses of the reparser and for its releases
+// only, and is left as the caller set it otherwise. Release() drops the
+// last parse explicitly, and the destructor calls it. Only one
+// ASTReparser, or ASTParser, may hold an AST at a time.
+class ASTReparser {
+public:
+  using DiagLevel = QasmDiagnosticEmitter::DiagLevel;
+
+  // How the AST of the last Parse() or Edit() was obtained.
+  enum ParseKind : unsigned { NotParsed = 0, Parsed, Reused, Spliced };
+
+  // The byte range [Begin, End) of a top-level statement, comments and
+  // whitespace around it excluded.
+  struct StatementSpan {
+    std::size_t Begin;
+    std::size_t End;
+  };
+
+private:
+  ASTParser Parser;
+  std::string Source;
+  std::vector<StatementSpan> Spans;
+  std::vector<unsigned> Dirty;
+  ASTRoot *Root;
+  ParseKind Kind;
+  unsigned NumParsed;
+  unsigned NumReused;
+  unsigned NumSpliced;
+  unsigned Lead;
+  bool Clean;
+  bool Sound;
+
+private:
+  void ReleaseParse();
+  void Reparse();
+  bool Splice(std::size_t I, const StatementSpan &SS, std::size_t E);
+  void SetDirty(std::size_t B, std::size_t E);
+
+public:
+  ASTReparser();
+
+  ASTReparser(const ASTReparser &RHS) = delete;
+  ASTReparser &operator=(const ASTReparser &RHS) = delete;
+
+  virtual ~ASTReparser();
+
+  // Releases the last parse, and parses S from scratch.
+  ASTRoot *Parse(const std::string &S);
+
+  // Replaces the Length bytes at Offset with Text, and returns the AST
+  // of the edited source. Returns nullptr, and leaves the source as it
+  // was, if the range is out of bounds.
+  ASTRoot *Edit(std::size_t Offset, std::size_t Length,
+                const std::string &Text);
+
+  // Splits S[B, E) into top-level statements, appended to V with their
+  // offsets in S, if V is not null. A pragma, an annotation and a #line
+  // or #file directive end at the end of their line, and are statements
+  // of their own. The tokens of the range are written to N, if N is not
+  // null. A run of comments and whitespace becomes the newlines it
+  // contains, followed by as many spaces as it has bytes after the last
+  // of them, so that the line and the column of every token are kept.
+  // Its other bytes are dropped, and so is a run that ends S. The text
+  // of a pragma or an annotation is kept as it is. Returns false if the
+  // range ends inside a comment, a string literal, a directive or a
+  // statement.
+  static bool Scan(const std::string &S, std::size_t B, std::size_t E,
+                   std::vector<StatementSpan> *V, std::string *N);
+
+  // Releases the AST, the symbol table, the tokens and the builders of
+  // the last parse, and forgets its source.
+  void Release();
+
+  ASTRoot *GetRoot() const { return Root; }
+
+  const std::string &GetSource() const { return Source; }
+
+  const std::vector<StatementSpan> &GetStatements() const { return Spans; }
+
+  // The indices in GetStatements() of the statements that enclose the
+  // last edit.
+  const std::vector<unsigned> &GetDirtyStatements() const { return Dirty; }
+
+  ParseKind GetLastParseKind() const { return Kind; }
+
+  unsigned GetNumParsed() const { return NumParsed; }
+
+  unsigned GetNumReused() const { return NumReused; }
+
+  unsigned GetNumSpliced() const { return NumSpliced; }
+};
+
+} // namespace QASM
+
+#endif // __QASM_AST_REPARSER_H
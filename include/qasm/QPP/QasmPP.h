@@ -65,8 +65,8 @@ public:
 
   bool IsIStream() const { return QPR.IsIStream(); }
 
-  void ParseCommandLineArguments(int argc, char *const argv[]) {
-    QPR.ParseCommandLineArguments(argc, argv);
+  bool ParseCommandLineArguments(int argc, char *const argv[]) {
+    return QPR.ParseCommandLineArguments(argc, argv);
   }
 
   void PrintIncludePaths() const {
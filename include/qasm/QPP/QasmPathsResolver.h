@@ -45,7 +45,8 @@ public:
     return *this;
   }
 
-  void ParseCommandLineArguments(int argc, char *const argv[]);
+  // Returns false if an option has an invalid value.
+  bool ParseCommandLineArguments(int argc, char *const argv[]);
 
   void AddIncludePath(const std::string &Path) { IncludePaths.push_back(Path); }
 
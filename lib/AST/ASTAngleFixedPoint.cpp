@@ -0,0 +1,207 @@
+/* -*- coding: utf-8 -*-
+ *
+ * Copyright 2023 IBM RESEARCH. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#include <qasm/AST/ASTAngleFixedPoint.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace QASM {
+
+static const long double TwoPi = 6.283185307179586476925286766559005768L;
+
+#if defined(__SIZEOF_INT128__)
+// Binary digits of 1 / (2 * pi). Word K holds fraction bits
+// [64 * K + 1, 64 * K + 64], most significant bit first. This covers
+// the reduction of every finite double.
+static const unsigned InvTwoPiWords = 20U;
+
+static const std::array<uint64_t, InvTwoPiWords> &InvTwoPi() {
+  static const std::array<uint64_t, InvTwoPiWords> T = [] {
+    std::array<uint64_t, InvTwoPiWords> R{};
+    mpfr_t I;
+    mpz_t Z;
+
+    mpfr_init2(I, InvTwoPiWords * 64 + 64);
+    mpz_init(Z);
+    mpfr_const_pi(I, MPFR_RNDN);
+    mpfr_mul_2ui(I, I, 1, MPFR_RNDN);
+    mpfr_ui_div(I, 1, I, MPFR_RNDN);
+    mpfr_mul_2ui(I, I, InvTwoPiWords * 64, MPFR_RNDN);
+    mpfr_get_z(Z, I, MPFR_RNDZ);
+
+    std::size_t C = 0;
+    mpz_export(R.data(), &C, 1, sizeof(uint64_t), 0, 0, Z);
+    assert(C == InvTwoPiWords && "Unexpected 1/2pi table size!");
+
+    mpz_clear(Z);
+    mpfr_clear(I);
+    return R;
+  }();
+
+  return T;
+}
+
+// Returns the 64 fraction bits of 1 / (2 * pi) starting at bit J, with
+// the bits before the binary point (J < 1) being zero.
+static uint64_t InvTwoPiBits(long J) {
+  const std::array<uint64_t, InvTwoPiWords> &T = InvTwoPi();
+
+  if (J < 1) {
+    long D = 1 - J;
+    return D >= 64 ? 0 : InvTwoPiBits(1) >> D;
+  }
+
+  std::size_t W = static_cast<std::size_t>(J - 1) / 64;
+  unsigned O = static_cast<unsigned>(J - 1) % 64;
+  assert(W + 1 < T.size() && "1/2pi table is too short!");
+
+  return O ? (T[W] << O) | (T[W + 1] >> (64 - O)) : T[W];
+}
+#endif
+
+bool ASTAngleFixedPoint::FromRadians(double X, unsigned Bits,
+                                     ASTAngleFixedPoint &R) {
+  assert(Bits && Bits <= MaxBits && "Invalid angle width!");
+
+  if (!std::isfinite(X))
+    return false;
+
+  if (X == 0.0) {
+    R = ASTAngleFixedPoint(0, Bits);
+    return true;
+  }
+
+#if defined(__SIZEOF_INT128__)
+  // |X| = M * 2^Q with M a 53-bit integer. The integral part of
+  // M * 2^Q / 2pi only depends on the bits of 1/2pi up to 2^-Q, so it
+  // is dropped by starting the window of 1/2pi right after them. The
+  // 192-bit window leaves an error below 2^-139 on the fraction.
+  int E;
+  double F = std::frexp(std::fabs(X), &E);
+  uint64_t M = static_cast<uint64_t>(std::ldexp(F, 53));
+  long J = static_cast<long>(E) - 53 + 1;
+
+  __extension__ typedef unsigned __int128 u128;
+  u128 P2 = static_cast<u128>(M) * InvTwoPiBits(J + 128);
+  u128 P1 = static_cast<u128>(M) * InvTwoPiBits(J + 64) + (P2 >> 64);
+  u128 P0 = static_cast<u128>(M) * InvTwoPiBits(J) + (P1 >> 64);
+  uint64_t F0 = static_cast<uint64_t>(P0);
+  uint64_t F1 = static_cast<uint64_t>(P1);
+  uint64_t F2 = static_cast<uint64_t>(P2);
+
+  // F0:F1:F2 is the fraction. Keep its top Bits bits and round to
+  // nearest, ties to even.
+  uint64_t K, Half, Rest;
+  if (Bits < 64U) {
+    K = F0 >> (64 - Bits);
+    Half = (F0 >> (63 - Bits)) & 1;
+    Rest = (F0 & ((uint64_t(1) << (63 - Bits)) - 1)) | F1 | F2;
+  } else {
+    K = F0;
+    Half = F1 >> 63;
+    Rest = (F1 << 1) | F2;
+  }
+
+  if (Half && (Rest || (K & 1)))
+    ++K;
+
+  R = ASTAngleFixedPoint(X < 0.0 ? uint64_t(0) - K : K, Bits);
+  return true;
+#else
+  mpfr_t MX;
+  mpfr_init2(MX, 53);
+  mpfr_set_d(MX, X, MPFR_RNDN);
+  bool B = FromMP(MX, Bits, R);
+  mpfr_clear(MX);
+  return B;
+#endif
+}
+
+bool ASTAngleFixedPoint::FromMP(const mpfr_t &X, unsigned Bits,
+                                ASTAngleFixedPoint &R) {
+  assert(Bits && Bits <= MaxBits && "Invalid angle width!");
+
+  if (!mpfr_number_p(X))
+    return false;
+
+  if (mpfr_zero_p(X)) {
+    R = ASTAngleFixedPoint(0, Bits);
+    return true;
+  }
+
+  // The fractional part of X / 2pi must be known to Bits bits past the
+  // integral part, plus guard bits.
+  mpfr_prec_t P = std::max<mpfr_prec_t>(mpfr_get_prec(X), mpfr_get_exp(X)) +
+                  Bits + 64;
+  mpfr_t T, TP;
+  mpfr_inits2(P, T, TP, (mpfr_ptr)0);
+
+  mpfr_const_pi(TP, MPFR_RNDN);
+  mpfr_mul_2ui(TP, TP, 1, MPFR_RNDN);
+  mpfr_div(T, X, TP, MPFR_RNDN);
+  mpfr_frac(T, T, MPFR_RNDN);
+  if (mpfr_sgn(T) < 0)
+    mpfr_add_ui(T, T, 1, MPFR_RNDN);
+
+  mpfr_mul_2ui(T, T, Bits, MPFR_RNDN);
+  mpfr_rint(T, T, MPFR_RNDN);
+  if (mpfr_cmp_ui_2exp(T, 1, Bits) >= 0)
+    mpfr_set_ui(T, 0, MPFR_RNDN);
+
+  // unsigned long may be 32 bits wide.
+  mpfr_div_2ui(TP, T, 32, MPFR_RNDN);
+  mpfr_floor(TP, TP);
+  uint64_t Hi = mpfr_get_ui(TP, MPFR_RNDZ);
+  mpfr_mul_2ui(TP, TP, 32, MPFR_RNDN);
+  mpfr_sub(T, T, TP, MPFR_RNDN);
+  uint64_t Lo = mpfr_get_ui(T, MPFR_RNDZ);
+
+  mpfr_clears(T, TP, (mpfr_ptr)0);
+  R = ASTAngleFixedPoint((Hi << 32) | Lo, Bits);
+  return true;
+}
+
+double ASTAngleFixedPoint::ToRadians() const {
+  assert(IsValid() && "Invalid angle!");
+  return static_cast<double>(
+      std::ldexp(static_cast<long double>(V), -static_cast<int>(N)) * TwoPi);
+}
+
+void ASTAngleFixedPoint::ToMP(mpfr_t &R) const {
+  assert(IsValid() && "Invalid angle!");
+
+  mpfr_t W, TP;
+  mpfr_init2(W, 64);
+  mpfr_init2(TP, mpfr_get_prec(R) + 64);
+
+  mpfr_set_ui(W, static_cast<unsigned long>(V >> 32), MPFR_RNDN);
+  mpfr_mul_2ui(W, W, 32, MPFR_RNDN);
+  mpfr_add_ui(W, W, static_cast<unsigned long>(V & 0xFFFFFFFFUL), MPFR_RNDN);
+
+  mpfr_const_pi(TP, MPFR_RNDN);
+  mpfr_mul_2ui(TP, TP, 1, MPFR_RNDN);
+  mpfr_mul(R, W, TP, MPFR_RNDN);
+  mpfr_div_2ui(R, R, N, MPFR_RNDN);
+
+  mpfr_clear(W);
+  mpfr_clear(TP);
+}
+
+} // namespace QASM
@@ -19,12 +19,14 @@
 #include <qasm/AST/ASTAngleContextControl.h>
 #include <qasm/AST/ASTAngleNodeBuilder.h>
 #include <qasm/AST/ASTBuilder.h>
+#include <qasm/AST/ASTConstantFolder.h>
 #include <qasm/AST/ASTMangler.h>
 #include <qasm/AST/ASTSymbolTable.h>
 #include <qasm/AST/ASTTypeEnums.h>
 #include <qasm/AST/ASTTypeSystemBuilder.h>
 
 #include <cassert>
+#include <cfloat>
 #include <map>
 #include <string>
 
@@ -99,4 +101,55 @@ void ASTAngleNode::EraseFromLocalSymbolTable() {
                                               ASTTypeAngle);
 }
 
+bool ASTAngleNode::GetFixedPoint(ASTAngleFixedPoint &FP) const {
+  if (Bits == 0 || Bits > ASTAngleFixedPoint::MaxBits)
+    return false;
+
+  // The reserved constants are exact: pi is half a turn and tau is a
+  // full turn.
+  if (AngleType == ASTAngleTypePi &&
+      (GetName() == u8"pi" || GetName() == u8"π")) {
+    FP = ASTAngleFixedPoint(uint64_t(1) << (Bits - 1), Bits);
+    return true;
+  } else if (AngleType == ASTAngleTypeTau &&
+             (GetName() == u8"tau" || GetName() == u8"τ")) {
+    FP = ASTAngleFixedPoint(0, Bits);
+    return true;
+  }
+
+  if (IsExpression())
+    return GetExpression() && ASTConstantFolder::Instance().EvaluateAngle(
+                                  GetExpression(), Bits, FP);
+
+  if (!MPL)
+    return ASTAngleFixedPoint::FromRadians(DV, Bits, FP);
+
+  return ASTAngleFixedPoint::FromMP(MPValue, Bits, FP);
+}
+
+void ASTAngleNode::SetFixedPoint(const ASTAngleFixedPoint &FP) {
+  assert(FP.IsValid() && "Invalid fixed-point angle!");
+
+  Bits = FP.GetBits();
+
+  // A double cannot hold every angle wider than its mantissa.
+  if (Bits > DBL_MANT_DIG) {
+    if (MPL)
+      mpfr_set_prec(MPValue, Bits);
+    else
+      mpfr_init2(MPValue, Bits);
+
+    MPL = true;
+    FP.ToMP(MPValue);
+    return;
+  }
+
+  if (MPL) {
+    mpfr_clear(MPValue);
+    MPL = false;
+  }
+
+  DV = FP.ToRadians();
+}
+
 } // namespace QASM
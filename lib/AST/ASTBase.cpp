@@ -17,7 +17,9 @@
  */
 
 #include <qasm/AST/ASTBase.h>
+#include <qasm/AST/ASTMemoryAccounting.h>
 #include <qasm/AST/ASTObjectTracker.h>
+#include <qasm/AST/ASTParseBudget.h>
 
 #include <cassert>
 #include <iostream>
@@ -38,4 +40,18 @@ ASTBase::ASTBase(const ASTBase &RHS)
   Registered = true;
 }
 
+void *ASTBase::operator new(std::size_t S) {
+  ASTParseBudget::Instance().RecordNode(S);
+  void *P = ::operator new(S);
+  ASTMemoryAccounting::Instance().RecordAllocation(P, S);
+  return P;
+}
+
+void ASTBase::operator delete(void *P) {
+  if (P) {
+    ASTMemoryAccounting::Instance().RecordDeallocation(P);
+    ::operator delete(P);
+  }
+}
+
 } // namespace QASM
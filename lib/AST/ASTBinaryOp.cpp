@@ -22,11 +22,48 @@
 #include <qasm/AST/ASTFunctionCallExpr.h>
 #include <qasm/AST/ASTImplicitConversionExpr.h>
 
+#include <cassert>
+#include <vector>
+
 namespace QASM {
 
 ASTBinaryOpAssignBuilder ASTBinaryOpAssignBuilder::BOB;
 
+// Types the binary and unary operations below E bottom-up, so that the
+// GetExpressionType() calls on the operands of E find their types
+// already computed instead of descending the whole tree.
+static void ResolveOperandTypes(const ASTExpressionNode *E) {
+  std::vector<const ASTExpressionNode *> PO;
+  ASTExpressionEvaluator::CollectOperations(
+      E,
+      [](const ASTExpressionNode *X) {
+        if (const ASTBinaryOpNode *BOP =
+                dynamic_cast<const ASTBinaryOpNode *>(X))
+          return BOP->HasExpressionType();
+        if (const ASTUnaryOpNode *UOP = dynamic_cast<const ASTUnaryOpNode *>(X))
+          return UOP->HasExpressionType();
+        return true;
+      },
+      PO, false);
+
+  assert(!PO.empty() && PO.back() == E && "Invalid operation order!");
+  PO.pop_back();
+
+  for (const ASTExpressionNode *X : PO) {
+    if (const ASTBinaryOpNode *BOP = dynamic_cast<const ASTBinaryOpNode *>(X))
+      (void)BOP->GetExpressionType();
+    else if (const ASTUnaryOpNode *UOP =
+                 dynamic_cast<const ASTUnaryOpNode *>(X))
+      (void)UOP->GetExpressionType();
+  }
+}
+
 ASTType ASTBinaryOpNode::GetExpressionType() const {
+  if (HasExpressionType())
+    return ETy;
+
+  ResolveOperandTypes(this);
+
   ASTType LTy = Left->GetASTType();
   ASTType RTy = Right->GetASTType();
 
@@ -148,13 +185,15 @@ ASTType ASTBinaryOpNode::GetExpressionType() const {
   unsigned LR = ASTExpressionEvaluator::Instance().GetRank(LTy);
   unsigned RR = ASTExpressionEvaluator::Instance().GetRank(RTy);
 
-  if (LR == RR)
-    return LTy;
-
-  return LR > RR ? LTy : RTy;
+  ETy = LR >= RR ? LTy : RTy;
+  ETG = ASTIdentifierNode::GetTypeGeneration();
+  return ETy;
 }
 
 ASTType ASTUnaryOpNode::GetExpressionType() const {
+  if (!HasExpressionType())
+    ResolveOperandTypes(this);
+
   switch (RTy) {
   case ASTTypeOpTy:
     if (const ASTOperatorNode *OPR =
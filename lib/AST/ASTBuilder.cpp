@@ -52,10 +52,6 @@ ASTBuilder ASTBuilder::Builder;
 uint64_t ASTBuilder::IdentCounter;
 
 ASTStringUtils ASTStringUtils::SU;
-std::regex ASTStringUtils::ZRD("[0]+.[0]+");
-std::regex ASTStringUtils::ZRZ("[0]+");
-std::regex ASTStringUtils::MPNAN("@?[Nn]a[Nn]@?");
-std::regex ASTStringUtils::MPINF("@?[Ii]nf@?");
 std::string ASTStringUtils::ES("");
 
 using DiagLevel = QASM::QasmDiagnosticEmitter::DiagLevel;
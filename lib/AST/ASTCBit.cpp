@@ -53,6 +53,7 @@ bool ASTCBitNode::ResolveCast() {
     BV = CBX->BV;
     NR = CBX->NR;
     SR = CBX->SR;
+    SRV = CBX->SRV;
     SZ = CBX->SZ;
     OTy = ASTTypeUndefined;
     NBC = false;
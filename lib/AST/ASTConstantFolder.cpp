@@ -0,0 +1,730 @@
+/* -*- coding: utf-8 -*-
+ *
+ * Copyright 2023 IBM RESEARCH. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#include <qasm/AST/ASTCastExpr.h>
+#include <qasm/AST/ASTConstantFolder.h>
+#include <qasm/AST/ASTExpressionEvaluator.h>
+#include <qasm/AST/ASTTypes.h>
+
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace QASM {
+
+ASTConstantFolder ASTConstantFolder::CF;
+
+static const double Pi = 3.141592653589793238462643383279502884;
+static const double Euler = 2.718281828459045235360287471352662498;
+
+static const int64_t Int64Max = std::numeric_limits<int64_t>::max();
+static const int64_t Int64Min = std::numeric_limits<int64_t>::min();
+
+static bool CheckedAdd(int64_t A, int64_t B, int64_t &R) {
+  if ((B > 0 && A > Int64Max - B) || (B < 0 && A < Int64Min - B))
+    return false;
+  R = A + B;
+  return true;
+}
+
+static bool CheckedSub(int64_t A, int64_t B, int64_t &R) {
+  if ((B < 0 && A > Int64Max + B) || (B > 0 && A < Int64Min + B))
+    return false;
+  R = A - B;
+  return true;
+}
+
+static bool CheckedMul(int64_t A, int64_t B, int64_t &R) {
+  if (A > 0 ? (B > 0 ? A > Int64Max / B : B < Int64Min / A)
+            : (B > 0 ? A < Int64Min / B : (A != 0 && B < Int64Max / A)))
+    return false;
+  R = A * B;
+  return true;
+}
+
+// Returns true if EN is a value that no statement can modify: a literal,
+// an anonymous value created by the parser, or a const declaration.
+static bool IsImmutable(const ASTExpressionNode *EN,
+                        const ASTIdentifierNode &Anonymous) {
+  if (EN->IsConst() || EN->IsConstantFolded())
+    return true;
+
+  const ASTIdentifierNode *Id = EN->GetIdentifier();
+  return Id && (Id == &Anonymous || Id->GetName() == Anonymous.GetName());
+}
+
+static bool IsReservedConstant(const std::string &S, double &D) {
+  if (S == u8"pi" || S == u8"π") {
+    D = Pi;
+    return true;
+  } else if (S == u8"tau" || S == u8"τ") {
+    D = 2.0 * Pi;
+    return true;
+  } else if (S == u8"euler" || S == u8"ε") {
+    D = Euler;
+    return true;
+  }
+
+  return false;
+}
+
+// A double result is only kept if it is finite. Integral operands are
+// promoted to double when either side is a double, and bool operands to
+// int.
+static bool MakeDouble(double D, ASTConstantValue &R) {
+  if (!std::isfinite(D))
+    return false;
+
+  R = ASTConstantValue(D);
+  return true;
+}
+
+static ASTConstantValue PromoteBool(const ASTConstantValue &V) {
+  return V.IsBool() ? ASTConstantValue(static_cast<int64_t>(V.GetBool())) : V;
+}
+
+static uint64_t Bits64(const ASTConstantValue &V) {
+  return V.IsUnsigned() ? V.GetUInt() : static_cast<uint64_t>(V.GetInt());
+}
+
+static int Compare(const ASTConstantValue &L, const ASTConstantValue &R) {
+  if (L.IsDouble() || R.IsDouble()) {
+    double A = L.AsDouble();
+    double B = R.AsDouble();
+    return A < B ? -1 : (A > B ? 1 : 0);
+  }
+
+  // Signed values compare below every unsigned value when negative.
+  if (L.IsUnsigned() != R.IsUnsigned()) {
+    if (!L.IsUnsigned() && L.GetInt() < 0)
+      return -1;
+    if (!R.IsUnsigned() && R.GetInt() < 0)
+      return 1;
+  }
+
+  if (L.IsUnsigned() || R.IsUnsigned()) {
+    uint64_t A = Bits64(L);
+    uint64_t B = Bits64(R);
+    return A < B ? -1 : (A > B ? 1 : 0);
+  }
+
+  return L.GetInt() < R.GetInt() ? -1 : (L.GetInt() > R.GetInt() ? 1 : 0);
+}
+
+bool ASTConstantFolder::EvaluateLeaf(const ASTExpressionNode *EN,
+                                     ASTConstantValue &R) {
+  double D;
+
+  switch (EN->GetASTType()) {
+  case ASTTypeBool: {
+    const ASTBoolNode *BN = dynamic_cast<const ASTBoolNode *>(EN);
+    if (!BN || BN->IsExpression() || !IsImmutable(BN, ASTIdentifierNode::Bool))
+      return false;
+
+    R = ASTConstantValue(BN->GetValue());
+    return true;
+  } break;
+  case ASTTypeInt: {
+    const ASTIntNode *IN = dynamic_cast<const ASTIntNode *>(EN);
+    if (!IN || !IsImmutable(IN, ASTIdentifierNode::Int))
+      return false;
+
+    if (IN->IsMP()) {
+      const ASTMPIntegerNode *MPI =
+          dynamic_cast<const ASTMPIntegerNode *>(IN->GetExpression());
+      if (!MPI || MPI->GetBits() > 64U)
+        return false;
+
+      R = MPI->IsSigned() ? ASTConstantValue(MPI->ToSignedLong())
+                          : ASTConstantValue(MPI->ToUnsignedLong());
+      return true;
+    }
+
+    if (IN->GetExpression())
+      return false;
+
+    R = IN->IsSigned()
+            ? ASTConstantValue(static_cast<int64_t>(IN->GetSignedValue()))
+            : ASTConstantValue(static_cast<uint64_t>(IN->GetUnsignedValue()));
+    return true;
+  } break;
+  case ASTTypeMPInteger: {
+    const ASTMPIntegerNode *MPI = dynamic_cast<const ASTMPIntegerNode *>(EN);
+    if (!MPI || MPI->GetBits() > 64U ||
+        !IsImmutable(MPI, ASTIdentifierNode::Int))
+      return false;
+
+    R = MPI->IsSigned() ? ASTConstantValue(MPI->ToSignedLong())
+                        : ASTConstantValue(MPI->ToUnsignedLong());
+    return true;
+  } break;
+  case ASTTypeFloat: {
+    const ASTFloatNode *FN = dynamic_cast<const ASTFloatNode *>(EN);
+    if (!FN || FN->GetExpression() ||
+        !IsImmutable(FN, ASTIdentifierNode::Float))
+      return false;
+
+    return MakeDouble(static_cast<double>(FN->GetValue()), R);
+  } break;
+  case ASTTypeDouble: {
+    const ASTDoubleNode *DN = dynamic_cast<const ASTDoubleNode *>(EN);
+    if (!DN || DN->IsMP() || !IsImmutable(DN, ASTIdentifierNode::Double))
+      return false;
+
+    if (DN->IsExpression())
+      return Evaluate(DN->GetExpression(), R);
+
+    return MakeDouble(DN->GetValue(), R);
+  } break;
+  case ASTTypeMPDecimal: {
+    const ASTMPDecimalNode *MPD = dynamic_cast<const ASTMPDecimalNode *>(EN);
+    if (!MPD)
+      return false;
+
+    if (IsReservedConstant(MPD->GetName(), D))
+      return MakeDouble(D, R);
+
+    if (!IsImmutable(MPD, ASTIdentifierNode::Double))
+      return false;
+
+    return MakeDouble(MPD->ToDouble(), R);
+  } break;
+  case ASTTypeAngle: {
+    const ASTAngleNode *AN = dynamic_cast<const ASTAngleNode *>(EN);
+    if (!AN)
+      return false;
+
+    if (IsReservedConstant(AN->GetName(), D))
+      return MakeDouble(D, R);
+
+    if (!AN->IsConst())
+      return false;
+
+    if (AN->IsExpression())
+      return AN->GetExpression() && Evaluate(AN->GetExpression(), R);
+
+    return MakeDouble(AN->AsDouble(), R);
+  } break;
+  case ASTTypeIdentifier:
+    if (IsReservedConstant(EN->GetIdentifier()->GetName(), D))
+      return MakeDouble(D, R);
+    break;
+  case ASTTypeOpndTy: {
+    const ASTOperandNode *OPN = dynamic_cast<const ASTOperandNode *>(EN);
+    if (!OPN)
+      return false;
+
+    if (OPN->IsExpression())
+      return Evaluate(OPN->GetExpression(), R);
+
+    if (OPN->IsIdentifier() &&
+        IsReservedConstant(OPN->GetTargetIdentifier()->GetName(), D))
+      return MakeDouble(D, R);
+  } break;
+  default:
+    break;
+  }
+
+  return false;
+}
+
+bool ASTConstantFolder::EvaluateBinaryOp(const ASTBinaryOpNode *BOP,
+                                         ASTConstantValue &R) {
+  ASTConstantValue L, V;
+  if (!BOP->GetLeft() || !BOP->GetRight() || !Evaluate(BOP->GetLeft(), L) ||
+      !Evaluate(BOP->GetRight(), V))
+    return false;
+
+  ASTOpType OT = BOP->GetOpType();
+
+  switch (OT) {
+  case ASTOpTypeLogicalAnd:
+    R = ASTConstantValue(L.AsBool() && V.AsBool());
+    return true;
+    break;
+  case ASTOpTypeLogicalOr:
+    R = ASTConstantValue(L.AsBool() || V.AsBool());
+    return true;
+    break;
+  case ASTOpTypeCompEq:
+    R = ASTConstantValue(Compare(L, V) == 0);
+    return true;
+    break;
+  case ASTOpTypeCompNeq:
+    R = ASTConstantValue(Compare(L, V) != 0);
+    return true;
+    break;
+  case ASTOpTypeLT:
+    R = ASTConstantValue(Compare(L, V) < 0);
+    return true;
+    break;
+  case ASTOpTypeGT:
+    R = ASTConstantValue(Compare(L, V) > 0);
+    return true;
+    break;
+  case ASTOpTypeLE:
+    R = ASTConstantValue(Compare(L, V) <= 0);
+    return true;
+    break;
+  case ASTOpTypeGE:
+    R = ASTConstantValue(Compare(L, V) >= 0);
+    return true;
+    break;
+  default:
+    break;
+  }
+
+  L = PromoteBool(L);
+  V = PromoteBool(V);
+
+  if (L.IsDouble() || V.IsDouble()) {
+    double A = L.AsDouble();
+    double B = V.AsDouble();
+
+    switch (OT) {
+    case ASTOpTypeAdd:
+      return MakeDouble(A + B, R);
+      break;
+    case ASTOpTypeSub:
+      return MakeDouble(A - B, R);
+      break;
+    case ASTOpTypeMul:
+      return MakeDouble(A * B, R);
+      break;
+    case ASTOpTypeDiv:
+      return B != 0.0 && MakeDouble(A / B, R);
+      break;
+    case ASTOpTypePow:
+      return MakeDouble(std::pow(A, B), R);
+      break;
+    default:
+      break;
+    }
+
+    return false;
+  }
+
+  // Integer exponents may be negative, which yields a double.
+  if (OT == ASTOpTypePow && !V.IsUnsigned() && V.GetInt() < 0)
+    return MakeDouble(std::pow(L.AsDouble(), V.AsDouble()), R);
+
+  if (L.IsUnsigned() || V.IsUnsigned()) {
+    uint64_t A = Bits64(L);
+    uint64_t B = Bits64(V);
+
+    switch (OT) {
+    case ASTOpTypeAdd:
+      R = ASTConstantValue(A + B);
+      return true;
+      break;
+    case ASTOpTypeSub:
+      R = ASTConstantValue(A - B);
+      return true;
+      break;
+    case ASTOpTypeMul:
+      R = ASTConstantValue(A * B);
+      return true;
+      break;
+    case ASTOpTypeDiv:
+      if (B == 0)
+        return false;
+      R = ASTConstantValue(A / B);
+      return true;
+      break;
+    case ASTOpTypeMod:
+      if (B == 0)
+        return false;
+      R = ASTConstantValue(A % B);
+      return true;
+      break;
+    case ASTOpTypePow: {
+      uint64_t P = 1;
+      for (; B; B >>= 1, A *= A)
+        if (B & 1)
+          P *= A;
+      R = ASTConstantValue(P);
+      return true;
+    } break;
+    default:
+      break;
+    }
+  } else {
+    int64_t A = L.GetInt();
+    int64_t B = V.GetInt();
+    int64_t I;
+
+    switch (OT) {
+    case ASTOpTypeAdd:
+      if (!CheckedAdd(A, B, I))
+        return false;
+      R = ASTConstantValue(I);
+      return true;
+      break;
+    case ASTOpTypeSub:
+      if (!CheckedSub(A, B, I))
+        return false;
+      R = ASTConstantValue(I);
+      return true;
+      break;
+    case ASTOpTypeMul:
+      if (!CheckedMul(A, B, I))
+        return false;
+      R = ASTConstantValue(I);
+      return true;
+      break;
+    case ASTOpTypeDiv:
+      if (B == 0 || (A == Int64Min && B == -1))
+        return false;
+      R = ASTConstantValue(A / B);
+      return true;
+      break;
+    case ASTOpTypeMod:
+      if (B == 0 || (A == Int64Min && B == -1))
+        return false;
+      R = ASTConstantValue(A % B);
+      return true;
+      break;
+    case ASTOpTypePow: {
+      int64_t P = 1;
+      for (; B; B >>= 1) {
+        if ((B & 1) && !CheckedMul(P, A, P))
+          return false;
+        if (B > 1 && !CheckedMul(A, A, A))
+          return false;
+      }
+      R = ASTConstantValue(P);
+      return true;
+    } break;
+    default:
+      break;
+    }
+  }
+
+  uint64_t A = Bits64(L);
+  uint64_t B = Bits64(V);
+  bool U = L.IsUnsigned() || V.IsUnsigned();
+
+  switch (OT) {
+  case ASTOpTypeBitAnd:
+    A &= B;
+    break;
+  case ASTOpTypeBitOr:
+    A |= B;
+    break;
+  case ASTOpTypeXor:
+    A ^= B;
+    break;
+  case ASTOpTypeLeftShift:
+    if (B >= 64U || (!V.IsUnsigned() && V.GetInt() < 0))
+      return false;
+    // Signed shifts must not change the sign, or lose bits.
+    if (!L.IsUnsigned() &&
+        (L.GetInt() < 0 || L.GetInt() > (Int64Max >> B)))
+      return false;
+    R = L.IsUnsigned() ? ASTConstantValue(A << B)
+                       : ASTConstantValue(static_cast<int64_t>(A << B));
+    return true;
+    break;
+  case ASTOpTypeRightShift:
+    if (B >= 64U || (!V.IsUnsigned() && V.GetInt() < 0))
+      return false;
+    R = L.IsUnsigned() ? ASTConstantValue(A >> B)
+                       : ASTConstantValue(L.GetInt() >> B);
+    return true;
+    break;
+  default:
+    return false;
+    break;
+  }
+
+  R = U ? ASTConstantValue(A) : ASTConstantValue(static_cast<int64_t>(A));
+  return true;
+}
+
+bool ASTConstantFolder::EvaluateUnaryOp(const ASTUnaryOpNode *UOP,
+                                        ASTConstantValue &R) {
+  ASTConstantValue V;
+  if (!UOP->GetExpression() || !Evaluate(UOP->GetExpression(), V))
+    return false;
+
+  double D = V.AsDouble();
+
+  switch (UOP->GetOpType()) {
+  case ASTOpTypeLogicalNot:
+    R = ASTConstantValue(!V.AsBool());
+    return true;
+    break;
+  case ASTOpTypePositive:
+    R = PromoteBool(V);
+    return true;
+    break;
+  case ASTOpTypeNegate:
+  case ASTOpTypeNegative:
+    V = PromoteBool(V);
+    if (V.IsDouble())
+      R = ASTConstantValue(-V.GetDouble());
+    else if (V.IsUnsigned())
+      R = ASTConstantValue(uint64_t(0) - V.GetUInt());
+    else if (V.GetInt() == Int64Min)
+      return false;
+    else
+      R = ASTConstantValue(-V.GetInt());
+    return true;
+    break;
+  case ASTOpTypeBitNot:
+    if (!V.IsIntegral())
+      return false;
+    R = V.IsUnsigned() ? ASTConstantValue(~V.GetUInt())
+                       : ASTConstantValue(~V.GetInt());
+    return true;
+    break;
+  case ASTOpTypePopcount:
+    if (!V.IsIntegral())
+      return false;
+    R = ASTConstantValue(
+        static_cast<int64_t>(__builtin_popcountll(Bits64(V))));
+    return true;
+    break;
+  case ASTOpTypeSin:
+    return MakeDouble(std::sin(D), R);
+    break;
+  case ASTOpTypeCos:
+    return MakeDouble(std::cos(D), R);
+    break;
+  case ASTOpTypeTan:
+    return MakeDouble(std::tan(D), R);
+    break;
+  case ASTOpTypeArcSin:
+    return MakeDouble(std::asin(D), R);
+    break;
+  case ASTOpTypeArcCos:
+    return MakeDouble(std::acos(D), R);
+    break;
+  case ASTOpTypeArcTan:
+    return MakeDouble(std::atan(D), R);
+    break;
+  case ASTOpTypeExp:
+    return MakeDouble(std::exp(D), R);
+    break;
+  case ASTOpTypeLn:
+    return D > 0.0 && MakeDouble(std::log(D), R);
+    break;
+  case ASTOpTypeSqrt:
+    return D >= 0.0 && MakeDouble(std::sqrt(D), R);
+    break;
+  default:
+    break;
+  }
+
+  return false;
+}
+
+bool ASTConstantFolder::EvaluateCast(const ASTCastExpressionNode *XOP,
+                                     ASTConstantValue &R) {
+  const ASTExpressionNode *EN = nullptr;
+
+  switch (XOP->GetCastFrom()) {
+  case ASTTypeBool:
+    EN = XOP->GetBool();
+    break;
+  case ASTTypeInt:
+    EN = XOP->GetInt();
+    break;
+  case ASTTypeFloat:
+    EN = XOP->GetFloat();
+    break;
+  case ASTTypeDouble:
+    EN = XOP->GetDouble();
+    break;
+  case ASTTypeMPInteger:
+    EN = XOP->GetMPInteger();
+    break;
+  case ASTTypeMPDecimal:
+    EN = XOP->GetMPDecimal();
+    break;
+  case ASTTypeAngle:
+    EN = XOP->GetAngle();
+    break;
+  case ASTTypeBinaryOp:
+    EN = XOP->GetBinaryOp();
+    break;
+  case ASTTypeUnaryOp:
+    EN = XOP->GetUnaryOp();
+    break;
+  case ASTTypeIdentifier: {
+    double D;
+    const ASTIdentifierNode *Id = XOP->GetTargetIdentifier();
+    if (!Id || !IsReservedConstant(Id->GetName(), D))
+      return false;
+    R = ASTConstantValue(D);
+  } break;
+  default:
+    return false;
+    break;
+  }
+
+  if (EN && !Evaluate(EN, R))
+    return false;
+
+  if (!R.IsValid())
+    return false;
+
+  switch (XOP->GetCastTo()) {
+  case ASTTypeBool:
+    R = ASTConstantValue(R.AsBool());
+    return true;
+    break;
+  case ASTTypeInt:
+  case ASTTypeMPInteger:
+    if (R.IsDouble()) {
+      // Truncates toward zero, as C does.
+      double T = std::trunc(R.GetDouble());
+      if (!(T >= -9223372036854775808.0 && T < 9223372036854775808.0))
+        return false;
+      R = ASTConstantValue(static_cast<int64_t>(T));
+    } else {
+      R = PromoteBool(R);
+    }
+    return true;
+    break;
+  case ASTTypeFloat:
+    return MakeDouble(static_cast<double>(static_cast<float>(R.AsDouble())),
+                      R);
+    break;
+  case ASTTypeDouble:
+  case ASTTypeMPDecimal:
+    return MakeDouble(R.AsDouble(), R);
+    break;
+  case ASTTypeAngle: {
+    // An angle[N] only holds multiples of 2 * pi / 2^N.
+    unsigned Bits = XOP->GetBits() ? XOP->GetBits() : ASTAngleNode::AngleBits;
+    ASTAngleFixedPoint FP;
+    if (Bits > ASTAngleFixedPoint::MaxBits ||
+        !ASTAngleFixedPoint::FromRadians(R.AsDouble(), Bits, FP))
+      return false;
+    R = ASTConstantValue(FP.ToRadians());
+    return true;
+  } break;
+  default:
+    break;
+  }
+
+  return false;
+}
+
+bool ASTConstantFolder::EvaluateNode(const ASTExpressionNode *EN,
+                                     ASTConstantValue &R) {
+  if (!EN || EN->IsError())
+    return false;
+
+  map_type::iterator I = Memo.find(EN);
+  if (I != Memo.end()) {
+    ++Hits;
+    if ((*I).second.OK)
+      R = (*I).second.V;
+    return (*I).second.OK;
+  }
+
+  ++Misses;
+
+  // Guards against cycles through self-referencing nodes: a node is
+  // not constant while it is being evaluated.
+  Memo.emplace(EN, Entry{ASTConstantValue(), false});
+
+  ASTConstantValue V;
+  bool OK = false;
+
+  switch (EN->GetASTType()) {
+  case ASTTypeBinaryOp:
+    if (const ASTBinaryOpNode *BOP = dynamic_cast<const ASTBinaryOpNode *>(EN))
+      OK = EvaluateBinaryOp(BOP, V);
+    break;
+  case ASTTypeUnaryOp:
+    if (const ASTUnaryOpNode *UOP = dynamic_cast<const ASTUnaryOpNode *>(EN))
+      OK = EvaluateUnaryOp(UOP, V);
+    break;
+  case ASTTypeCast:
+    if (const ASTCastExpressionNode *XOP =
+            dynamic_cast<const ASTCastExpressionNode *>(EN))
+      OK = EvaluateCast(XOP, V);
+    break;
+  default:
+    OK = EvaluateLeaf(EN, V);
+    break;
+  }
+
+  Entry &E = Memo[EN];
+  E.OK = OK;
+  if (!OK)
+    return false;
+
+  E.V = V;
+  R = V;
+
+  switch (EN->GetASTType()) {
+  case ASTTypeBinaryOp:
+  case ASTTypeUnaryOp:
+  case ASTTypeCast:
+    EN->SetConstantFolded();
+    break;
+  default:
+    break;
+  }
+
+  return true;
+}
+
+bool ASTConstantFolder::Evaluate(const ASTExpressionNode *EN,
+                                 ASTConstantValue &R) {
+  if (!EN || EN->IsError())
+    return false;
+
+  // Folds the operations below EN bottom-up first, so that the recursive
+  // evaluation of EN finds its operands memoized, and deep trees do not
+  // exhaust the call stack.
+  if (Memo.find(EN) == Memo.end()) {
+    std::vector<const ASTExpressionNode *> PO;
+    ASTExpressionEvaluator::CollectOperations(
+        EN, [this](const ASTExpressionNode *X) { return Memo.count(X) != 0; },
+        PO);
+
+    for (const ASTExpressionNode *X : PO) {
+      ASTConstantValue V;
+      if (X != EN && Memo.find(X) == Memo.end())
+        EvaluateNode(X, V);
+    }
+  }
+
+  return EvaluateNode(EN, R);
+}
+
+bool ASTConstantFolder::EvaluateAngle(const ASTExpressionNode *EN,
+                                      unsigned Bits, ASTAngleFixedPoint &R) {
+  assert(Bits && Bits <= ASTAngleFixedPoint::MaxBits &&
+         "Invalid angle width!");
+
+  ASTConstantValue V;
+  if (!Evaluate(EN, V))
+    return false;
+
+  return ASTAngleFixedPoint::FromRadians(V.AsDouble(), Bits, R);
+}
+
+} // namespace QASM
@@ -738,6 +738,7 @@ ASTDefcalNode *ASTDefcalNode::CloneCall(const ASTIdentifierNode *Id,
   assert(RDN->QTarget && "Clone ASTDefcalNode has an invalid QTarget!");
 
   RDN->SetDefcalCall(true);
+  RDN->Origin = this;
   RDN->Grammar = Grammar;
   RDN->QK = QK;
   *const_cast<ASTBoundQubitList *>(RDN->QTarget) = *QTarget;
@@ -1952,6 +1953,9 @@ void ASTDefcalNode::print() const {
             << std::endl;
   std::cout << "<IsDefcalCall>" << std::boolalpha << IsCall << "</IsDefcalCall>"
             << std::endl;
+  if (Origin)
+    std::cout << "<ResolvedDefcal>" << Origin->GetMangledName()
+              << "</ResolvedDefcal>" << std::endl;
   if (!Params.Empty()) {
     std::cout << "<DefcalParameters>" << std::endl;
     Params.print();
@@ -0,0 +1,319 @@
+/* -*- coding: utf-8 -*-
+ *
+ * Copyright 2023 IBM RESEARCH. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#include <qasm/AST/ASTAnyTypeList.h>
+#include <qasm/AST/ASTArgument.h>
+#include <qasm/AST/ASTDefcal.h>
+#include <qasm/AST/ASTDefcalDispatchIndex.h>
+#include <qasm/AST/ASTIdentifier.h>
+#include <qasm/AST/ASTSymbolTable.h>
+
+#include <algorithm>
+#include <any>
+#include <cassert>
+#include <cctype>
+
+namespace QASM {
+
+ASTDefcalDispatchIndex::group_map ASTDefcalDispatchIndex::DGM;
+std::size_t ASTDefcalDispatchIndex::DSZ = 0;
+ASTDefcalDispatchIndex ASTDefcalDispatchIndex::DDI;
+
+// Calls F with the tuples obtained from K by keeping the elements at a
+// subset of its non-wildcard positions, and setting the others to
+// Wildcard. Larger subsets come first, and subsets of the same size are
+// visited in lexicographic order, which prefers the leftmost positions.
+// Returns the first result that is not null.
+template <typename Func>
+static const ASTSymbolTableEntry *
+WalkSpecializations(const std::vector<uint32_t> &K, Func F) {
+  const uint32_t W = ASTDefcalDispatchIndex::Wildcard;
+
+  std::vector<unsigned> PV;
+  for (unsigned I = 0; I < K.size(); ++I)
+    if (K[I] != W)
+      PV.push_back(I);
+
+  const unsigned P = static_cast<unsigned>(PV.size());
+
+  if (P > ASTDefcalDispatchIndex::MaxSpecializedQubits) {
+    if (const ASTSymbolTableEntry *STE = F(K))
+      return STE;
+
+    return F(std::vector<uint32_t>(K.size(), W));
+  }
+
+  std::vector<uint32_t> S(K.size(), W);
+  std::vector<unsigned> CV;
+
+  for (unsigned N = P + 1; N-- > 0;) {
+    CV.resize(N);
+    for (unsigned I = 0; I < N; ++I)
+      CV[I] = I;
+
+    while (true) {
+      std::fill(S.begin(), S.end(), W);
+      for (unsigned C : CV)
+        S[PV[C]] = K[PV[C]];
+
+      if (const ASTSymbolTableEntry *STE = F(S))
+        return STE;
+
+      int I = static_cast<int>(N) - 1;
+      while (I >= 0 && CV[I] == P - N + static_cast<unsigned>(I))
+        --I;
+
+      if (I < 0)
+        break;
+
+      ++CV[I];
+      for (unsigned J = static_cast<unsigned>(I) + 1; J < N; ++J)
+        CV[J] = CV[J - 1] + 1;
+    }
+  }
+
+  return nullptr;
+}
+
+uint32_t ASTDefcalDispatchIndex::PhysicalQubitIndex(const std::string &S) {
+  if (S.length() < 2 || S[0] != '$')
+    return Wildcard;
+
+  uint64_t R = 0;
+  for (std::string::size_type I = 1; I < S.length(); ++I) {
+    if (!std::isdigit(static_cast<unsigned char>(S[I])))
+      return Wildcard;
+
+    R = R * 10U + static_cast<uint64_t>(S[I] - '0');
+    if (R >= Wildcard)
+      return Wildcard;
+  }
+
+  return static_cast<uint32_t>(R);
+}
+
+ASTDefcalDispatchIndex::qubit_key
+ASTDefcalDispatchIndex::MakeQubitKey(const ASTDefcalNode *DN) {
+  assert(DN && "Invalid ASTDefcalNode argument!");
+
+  qubit_key K;
+  const ASTBoundQubitList *BQL = DN->GetBoundQubits();
+  if (!BQL)
+    return K;
+
+  K.reserve(BQL->Size());
+  for (ASTBoundQubitList::const_iterator I = BQL->begin(); I != BQL->end();
+       ++I)
+    K.push_back(PhysicalQubitIndex((*I)->GetValue()));
+
+  return K;
+}
+
+ASTDefcalDispatchIndex::qubit_key
+ASTDefcalDispatchIndex::MakeQubitKey(const ASTAnyTypeList &QL) {
+  qubit_key K;
+  K.reserve(QL.Size());
+
+  for (ASTAnyTypeList::const_iterator I = QL.begin(); I != QL.end(); ++I) {
+    uint32_t Q = Wildcard;
+
+    if ((*I).second == ASTTypeIdentifier) {
+      if (ASTIdentifierNode *const *QId =
+              std::any_cast<ASTIdentifierNode *>(&(*I).first)) {
+        if (*QId)
+          Q = PhysicalQubitIndex((*QId)->GetName());
+      }
+    }
+
+    K.push_back(Q);
+  }
+
+  return K;
+}
+
+uint32_t ASTDefcalDispatchIndex::GetParamClass(ASTType Ty) {
+  switch (Ty) {
+  case ASTTypeAngle:
+    return ParamAngle;
+  case ASTTypeInt:
+  case ASTTypeUInt:
+  case ASTTypeMPInteger:
+  case ASTTypeMPUInteger:
+    return ParamInt;
+  case ASTTypeFloat:
+  case ASTTypeDouble:
+  case ASTTypeLongDouble:
+  case ASTTypeMPDecimal:
+    return ParamFloat;
+  case ASTTypeDuration:
+    return ParamDuration;
+  case ASTTypeBool:
+    return ParamBool;
+  default:
+    return Wildcard;
+  }
+}
+
+uint32_t ASTDefcalDispatchIndex::GetParamClass(const ASTExpressionNode *EN) {
+  return EN ? GetParamClass(EN->GetASTType()) : Wildcard;
+}
+
+uint32_t ASTDefcalDispatchIndex::GetParamClass(const ASTArgumentNode *AN) {
+  if (!AN)
+    return Wildcard;
+
+  // An identifier argument has the type of the symbol it names.
+  switch (AN->GetValueType()) {
+  case ASTTypeIdentifier:
+  case ASTTypeIdentifierRef:
+    if (const ASTIdentifierNode *Id = AN->GetIdentifier())
+      return GetParamClass(Id->GetSymbolType());
+    return Wildcard;
+  default:
+    return GetParamClass(AN->GetValueType());
+  }
+}
+
+bool ASTDefcalDispatchIndex::IsConvertible(uint32_t A, uint32_t P) {
+  if (A == P || A == Wildcard || P == Wildcard)
+    return true;
+
+  switch (P) {
+  case ParamAngle:
+    return A == ParamInt || A == ParamFloat;
+  case ParamFloat:
+    return A == ParamInt;
+  default:
+    return false;
+  }
+}
+
+ASTDefcalDispatchIndex::param_key
+ASTDefcalDispatchIndex::MakeParamKey(const ASTDefcalNode *DN) {
+  assert(DN && "Invalid ASTDefcalNode argument!");
+
+  const ASTExpressionNodeList &PL = DN->GetParameters();
+  param_key K;
+  K.reserve(PL.Size());
+
+  for (ASTExpressionNodeList::const_iterator I = PL.begin(); I != PL.end();
+       ++I)
+    K.push_back(GetParamClass(*I));
+
+  return K;
+}
+
+ASTDefcalDispatchIndex::param_key
+ASTDefcalDispatchIndex::MakeParamKey(const ASTArgumentNodeList &AL) {
+  param_key K;
+  K.reserve(AL.Size());
+
+  for (ASTArgumentNodeList::const_iterator I = AL.begin(); I != AL.end();
+       ++I)
+    K.push_back(GetParamClass(*I));
+
+  return K;
+}
+
+bool ASTDefcalDispatchIndex::Insert(const std::string &GN,
+                                    const ASTSymbolTableEntry *STE) {
+  assert(!GN.empty() && "Invalid defcal group name argument!");
+  assert(STE && "Invalid ASTSymbolTableEntry argument!");
+
+  if (!STE->HasValue() || STE->GetValueType() != ASTTypeDefcal)
+    return false;
+
+  const ASTDefcalNode *DN = STE->GetValue()->GetValue<ASTDefcalNode *>();
+  if (!DN)
+    return false;
+
+  DGM[GN][MakeQubitKey(DN)][MakeParamKey(DN)].push_back(STE);
+  ++DSZ;
+  return true;
+}
+
+const ASTSymbolTableEntry *
+ASTDefcalDispatchIndex::Find(const param_map &PM, const param_key &PK) const {
+  param_map::const_iterator PI = PM.find(PK);
+  if (PI == PM.end() || (*PI).second.empty())
+    return nullptr;
+
+  return (*PI).second.back();
+}
+
+const ASTSymbolTableEntry *
+ASTDefcalDispatchIndex::FindConvertible(const param_map &PM,
+                                        const param_key &PK) const {
+  const param_map::value_type *B = nullptr;
+  unsigned BS = 0U;
+
+  for (const param_map::value_type &E : PM) {
+    const param_key &K = E.first;
+    if (K.size() != PK.size() || E.second.empty())
+      continue;
+
+    unsigned S = 0U;
+    bool C = true;
+    for (unsigned I = 0; C && I < K.size(); ++I) {
+      C = IsConvertible(PK[I], K[I]);
+      S += PK[I] == K[I];
+    }
+
+    // Ties go to the smaller key, so that the choice does not depend
+    // on the iteration order of the hash table.
+    if (C && (!B || S > BS || (S == BS && K < B->first))) {
+      B = &E;
+      BS = S;
+    }
+  }
+
+  return B ? B->second.back() : nullptr;
+}
+
+const ASTSymbolTableEntry *
+ASTDefcalDispatchIndex::Resolve(const std::string &GN, const qubit_key &QK,
+                                const param_key &PK) const {
+  group_map::const_iterator GI = DGM.find(GN);
+  if (GI == DGM.end())
+    return nullptr;
+
+  const qubit_map &QM = (*GI).second;
+
+  return WalkSpecializations(
+      QK, [this, &QM, &PK](const qubit_key &K) -> const ASTSymbolTableEntry * {
+        qubit_map::const_iterator QI = QM.find(K);
+        if (QI == QM.end())
+          return nullptr;
+
+        const param_map &PM = (*QI).second;
+        if (const ASTSymbolTableEntry *STE = WalkSpecializations(
+                PK, [this, &PM](const param_key &P) { return Find(PM, P); }))
+          return STE;
+
+        return FindConvertible(PM, PK);
+      });
+}
+
+const ASTSymbolTableEntry *
+ASTDefcalDispatchIndex::Resolve(const std::string &GN,
+                                const ASTArgumentNodeList &AL,
+                                const ASTAnyTypeList &QL) const {
+  return Resolve(GN, MakeQubitKey(QL), MakeParamKey(AL));
+}
+
+} // namespace QASM
@@ -0,0 +1,158 @@
+/* -*- coding: utf-8 -*-
+ *
+ * Copyright 2023 IBM RESEARCH. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#include <qasm/AST/ASTDurationTicks.h>
+
+#include <cctype>
+#include <numeric>
+
+namespace QASM {
+
+ASTDurationTimeBase ASTDurationTimeBase::TB;
+
+static const uint64_t NanosecondsPerSecond = 1000000000ULL;
+
+static bool MulU64(uint64_t A, uint64_t B, uint64_t &R) {
+  if (B && A > std::numeric_limits<uint64_t>::max() / B)
+    return false;
+  R = A * B;
+  return true;
+}
+
+bool ASTDurationTimeBase::SetDT(uint64_t Num, uint64_t Den) {
+  if (!Num || !Den)
+    return false;
+
+  uint64_t G = std::gcd(Num, Den);
+  Num /= G;
+  Den /= G;
+
+  // Every unit must be a whole number of ticks that fits in an int64_t.
+  uint64_t S;
+  if (!MulU64(Den, NanosecondsPerSecond, S) ||
+      S > static_cast<uint64_t>(std::numeric_limits<int64_t>::max()) ||
+      Num > static_cast<uint64_t>(std::numeric_limits<int64_t>::max()))
+    return false;
+
+  P = Num;
+  Q = Den;
+  ++Gen;
+  return true;
+}
+
+bool ASTDurationTimeBase::SetDT(const std::string &S) {
+  const char *C = S.c_str();
+  uint64_t Num = 0;
+  uint64_t Den = 1;
+
+  if (!std::isdigit(static_cast<unsigned char>(*C)))
+    return false;
+
+  for (; std::isdigit(static_cast<unsigned char>(*C)); ++C) {
+    if (!MulU64(Num, 10, Num) ||
+        Num > std::numeric_limits<uint64_t>::max() - (*C - '0'))
+      return false;
+    Num += *C - '0';
+  }
+
+  if (*C == '.') {
+    for (++C; std::isdigit(static_cast<unsigned char>(*C)); ++C) {
+      if (!MulU64(Num, 10, Num) || !MulU64(Den, 10, Den) ||
+          Num > std::numeric_limits<uint64_t>::max() - (*C - '0'))
+        return false;
+      Num += *C - '0';
+    }
+  } else if (*C == '/') {
+    ++C;
+    if (!std::isdigit(static_cast<unsigned char>(*C)))
+      return false;
+
+    Den = 0;
+    for (; std::isdigit(static_cast<unsigned char>(*C)); ++C) {
+      if (!MulU64(Den, 10, Den) ||
+          Den > std::numeric_limits<uint64_t>::max() - (*C - '0'))
+        return false;
+      Den += *C - '0';
+    }
+  }
+
+  std::string U = C;
+  uint64_t K;
+
+  if (U.empty() || U == "ns")
+    K = 1ULL;
+  else if (U == "us" || U == u8"μs")
+    K = 1000ULL;
+  else if (U == "ms")
+    K = 1000000ULL;
+  else if (U == "s")
+    K = NanosecondsPerSecond;
+  else
+    return false;
+
+  if (Num && Den) {
+    uint64_t G = std::gcd(Num, Den);
+    Num /= G;
+    Den /= G;
+  }
+
+  return MulU64(Num, K, Num) && SetDT(Num, Den);
+}
+
+uint64_t ASTDurationTimeBase::TicksPerUnit(LengthUnit U) const {
+  switch (U) {
+  case Nanoseconds:
+    return Q;
+    break;
+  case Microseconds:
+    return Q * 1000ULL;
+    break;
+  case Milliseconds:
+    return Q * 1000000ULL;
+    break;
+  case Seconds:
+    return Q * NanosecondsPerSecond;
+    break;
+  case DT:
+    return P;
+    break;
+  default:
+    break;
+  }
+
+  return 0;
+}
+
+bool ASTDurationTimeBase::ToTicks(uint64_t D, LengthUnit U, int64_t &T) const {
+  uint64_t K = TicksPerUnit(U);
+  uint64_t R;
+
+  if (D == 0 && (K || U == DT)) {
+    T = 0;
+    return true;
+  }
+
+  if (!K || !MulU64(D, K, R) ||
+      R > static_cast<uint64_t>(std::numeric_limits<int64_t>::max()))
+    return false;
+
+  T = static_cast<int64_t>(R);
+  return true;
+}
+
+} // namespace QASM
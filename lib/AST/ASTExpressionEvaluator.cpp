@@ -25,6 +25,8 @@
 
 #include <cassert>
 #include <iostream>
+#include <unordered_set>
+#include <utility>
 
 namespace QASM {
 
@@ -35,6 +37,8 @@ std::map<unsigned, ASTType> ASTExpressionEvaluator::TM;
 using DiagLevel = QASM::QasmDiagnosticEmitter::DiagLevel;
 
 void ASTExpressionEvaluator::Init() {
+  ClearCache();
+
   if (RM.empty()) {
     RM = {
         {ASTTypeChar, 0U},
@@ -84,9 +88,151 @@ void ASTExpressionEvaluator::Init() {
   }
 }
 
+const ASTExpressionNode *
+ASTExpressionEvaluator::GetOperation(const ASTExpressionNode *E) {
+  while (E) {
+    switch (E->GetASTType()) {
+    case ASTTypeBinaryOp:
+    case ASTTypeUnaryOp:
+      return E;
+      break;
+    case ASTTypeOpTy:
+      if (const ASTOperatorNode *OPN = dynamic_cast<const ASTOperatorNode *>(E))
+        E = OPN->GetTargetExpression();
+      else
+        return nullptr;
+      break;
+    case ASTTypeOpndTy:
+      if (const ASTOperandNode *OPD = dynamic_cast<const ASTOperandNode *>(E))
+        E = OPD->GetExpression();
+      else
+        return nullptr;
+      break;
+    default:
+      return nullptr;
+      break;
+    }
+  }
+
+  return nullptr;
+}
+
+void ASTExpressionEvaluator::CollectOperations(
+    const ASTExpressionNode *E,
+    const std::function<bool(const ASTExpressionNode *)> &Known,
+    std::vector<const ASTExpressionNode *> &PO, bool LookThrough) {
+  E = GetOperation(E);
+  if (!E)
+    return;
+
+  std::vector<std::pair<const ASTExpressionNode *, bool>> S;
+  std::unordered_set<const ASTExpressionNode *> Seen;
+  S.emplace_back(E, false);
+  Seen.insert(E);
+
+  while (!S.empty()) {
+    const ASTExpressionNode *X = S.back().first;
+
+    if (S.back().second) {
+      S.pop_back();
+      PO.push_back(X);
+      continue;
+    }
+
+    S.back().second = true;
+
+    // Unary operations only type their direct operand.
+    const ASTExpressionNode *OPS[2] = {nullptr, nullptr};
+    bool LT = LookThrough;
+    if (const ASTBinaryOpNode *BOp = dynamic_cast<const ASTBinaryOpNode *>(X)) {
+      OPS[0] = BOp->GetRight();
+      OPS[1] = BOp->GetLeft();
+    } else if (const ASTUnaryOpNode *UOp =
+                   dynamic_cast<const ASTUnaryOpNode *>(X)) {
+      OPS[0] = UOp->GetExpression();
+      LT = false;
+    }
+
+    // The left operand is pushed last, so that it is visited first.
+    for (const ASTExpressionNode *OP : OPS) {
+      OP = LT ? GetOperation(OP) : OP;
+      if (!OP || (OP->GetASTType() != ASTTypeBinaryOp &&
+                  OP->GetASTType() != ASTTypeUnaryOp))
+        continue;
+
+      if (!Known(OP) && Seen.insert(OP).second)
+        S.emplace_back(OP, false);
+    }
+  }
+}
+
+ASTExpressionEvaluator::cache_type &
+ASTExpressionEvaluator::GetTypeCache() const {
+  return TC[ASTAngleContextControl::Instance().InOpenContext() ? 1 : 0];
+}
+
+void ASTExpressionEvaluator::ResolveOperations(
+    const ASTExpressionNode *E) const {
+  cache_type &C = GetTypeCache();
+  std::vector<const ASTExpressionNode *> PO;
+
+  CollectOperations(
+      E, [&C](const ASTExpressionNode *X) { return C.count(X) != 0; }, PO);
+
+  // Every operation is typed after its operands, so that the lookups of
+  // ComputeType on the operands are cache hits. Failures are only kept
+  // for the duration of the pass: they are diagnosed again if the
+  // operation is queried again.
+  for (const ASTExpressionNode *X : PO) {
+    ASTType Ty = ASTTypeUndefined;
+
+    if (const ASTBinaryOpNode *BOp = dynamic_cast<const ASTBinaryOpNode *>(X))
+      Ty = ComputeType(BOp);
+    else if (const ASTUnaryOpNode *UOp =
+                 dynamic_cast<const ASTUnaryOpNode *>(X))
+      Ty = ComputeType(UOp);
+
+    C.emplace(X, Ty);
+  }
+
+  for (const ASTExpressionNode *X : PO) {
+    cache_type::const_iterator I = C.find(X);
+    if (I != C.end() && (*I).second == ASTTypeUndefined)
+      C.erase(I);
+  }
+}
+
 ASTType ASTExpressionEvaluator::EvaluatesTo(const ASTBinaryOpNode *BOp) const {
   assert(BOp && "Invalid ASTBinaryOpNode argument!");
 
+  cache_type &C = GetTypeCache();
+  cache_type::const_iterator I = C.find(BOp);
+  if (I != C.end())
+    return (*I).second;
+
+  ResolveOperations(BOp);
+
+  I = C.find(BOp);
+  return I == C.end() ? ASTTypeUndefined : (*I).second;
+}
+
+ASTType ASTExpressionEvaluator::EvaluatesTo(const ASTUnaryOpNode *UOp) const {
+  assert(UOp && "Invalid ASTUnaryOpNode argument!");
+
+  cache_type &C = GetTypeCache();
+  cache_type::const_iterator I = C.find(UOp);
+  if (I != C.end())
+    return (*I).second;
+
+  ResolveOperations(UOp);
+
+  I = C.find(UOp);
+  return I == C.end() ? ASTTypeUndefined : (*I).second;
+}
+
+ASTType ASTExpressionEvaluator::ComputeType(const ASTBinaryOpNode *BOp) const {
+  assert(BOp && "Invalid ASTBinaryOpNode argument!");
+
   ASTType LTy = BOp->GetLeft()->GetASTType();
   ASTType RTy = BOp->GetRight()->GetASTType();
 
@@ -330,7 +476,7 @@ ASTType ASTExpressionEvaluator::EvaluatesTo(const ASTBinaryOpNode *BOp) const {
   return GetType(std::max(LR, RR));
 }
 
-ASTType ASTExpressionEvaluator::EvaluatesTo(const ASTUnaryOpNode *UOp) const {
+ASTType ASTExpressionEvaluator::ComputeType(const ASTUnaryOpNode *UOp) const {
   assert(UOp && "Invalid ASTUnaryOpNode argument!");
 
   ASTType ETy = UOp->GetExpression()->GetASTType();
@@ -28,6 +28,7 @@
 #include <qasm/AST/ASTGates.h>
 #include <qasm/AST/ASTIdentifierBuilder.h>
 #include <qasm/AST/ASTImplicitConversionExpr.h>
+#include <qasm/AST/ASTInstrumentation.h>
 #include <qasm/AST/ASTMangler.h>
 #include <qasm/AST/ASTSymbolTable.h>
 #include <qasm/AST/ASTTypes.h>
@@ -2356,8 +2357,8 @@ void ASTGateNode::MaterializeGateQubitParam(ASTIdentifierNode *Id) {
 
   if (Id->GetSymbolType() == ASTTypeGateQubitParam) {
     unsigned Bits = 1U;
-    if (ASTStringUtils::Instance().IsIndexed(Id->GetName()))
-      Bits = ASTStringUtils::Instance().GetIdentifierIndex(Id->GetName());
+    if (Id->HasIndexedName())
+      Bits = Id->GetNameIndex();
     assert(!ASTIdentifierNode::InvalidBits(Bits) &&
            "Invalid number of bits for ASTGateQubitParam!");
 
@@ -2401,6 +2402,8 @@ ASTIdentifierNode *ASTGateNode::GateCallIdentifier(const std::string &Name,
 ASTGateNode *ASTGateNode::CloneCall(const ASTIdentifierNode *Id,
                                     const ASTArgumentNodeList &AL,
                                     const ASTAnyTypeList &QL) {
+  QASM_INSTR_SCOPE(GateClone);
+
   assert(Id && "Invalid ASTIdentifierNode argument!");
 
   ASTIdentifierNode *GId =
@@ -2425,6 +2428,8 @@ ASTGateNode *ASTGateNode::CloneCall(const ASTIdentifierNode *Id,
 ASTUGateNode *ASTUGateNode::CloneCall(const ASTIdentifierNode *Id,
                                       const ASTArgumentNodeList &AL,
                                       const ASTAnyTypeList &QL) {
+  QASM_INSTR_SCOPE(GateClone);
+
   assert(Id && "Invalid ASTIdentifierNode argument!");
 
   ASTIdentifierNode *GId =
@@ -2449,6 +2454,8 @@ ASTUGateNode *ASTUGateNode::CloneCall(const ASTIdentifierNode *Id,
 ASTCXGateNode *ASTCXGateNode::CloneCall(const ASTIdentifierNode *Id,
                                         const ASTArgumentNodeList &AL,
                                         const ASTAnyTypeList &QL) {
+  QASM_INSTR_SCOPE(GateClone);
+
   assert(Id && "Invalid ASTIdentifierNode argument!");
 
   ASTIdentifierNode *GId =
@@ -2473,6 +2480,8 @@ ASTCXGateNode *ASTCXGateNode::CloneCall(const ASTIdentifierNode *Id,
 ASTCXGateNode *ASTCXGateNode::CloneCall(const ASTIdentifierNode *Id,
                                         const ASTParameterList &PL,
                                         const ASTIdentifierList &IL) {
+  QASM_INSTR_SCOPE(GateClone);
+
   assert(Id && "Invalid ASTIdentifierNode argument!");
 
   ASTIdentifierNode *GId =
@@ -2497,6 +2506,8 @@ ASTCXGateNode *ASTCXGateNode::CloneCall(const ASTIdentifierNode *Id,
 ASTCCXGateNode *ASTCCXGateNode::CloneCall(const ASTIdentifierNode *Id,
                                           const ASTArgumentNodeList &AL,
                                           const ASTAnyTypeList &QL) {
+  QASM_INSTR_SCOPE(GateClone);
+
   assert(Id && "Invalid ASTIdentifierNode argument!");
 
   ASTIdentifierNode *GId =
@@ -2521,6 +2532,8 @@ ASTCCXGateNode *ASTCCXGateNode::CloneCall(const ASTIdentifierNode *Id,
 ASTCCXGateNode *ASTCCXGateNode::CloneCall(const ASTIdentifierNode *Id,
                                           const ASTParameterList &PL,
                                           const ASTIdentifierList &IL) {
+  QASM_INSTR_SCOPE(GateClone);
+
   assert(Id && "Invalid ASTIdentifierNode argument!");
 
   ASTIdentifierNode *GId =
@@ -2546,6 +2559,8 @@ ASTHadamardGateNode *
 ASTHadamardGateNode::CloneCall(const ASTIdentifierNode *Id,
                                const ASTArgumentNodeList &AL,
                                const ASTAnyTypeList &QL) {
+  QASM_INSTR_SCOPE(GateClone);
+
   assert(Id && "Invalid ASTIdentifierNode argument!");
 
   ASTIdentifierNode *GId =
@@ -2570,6 +2585,8 @@ ASTHadamardGateNode::CloneCall(const ASTIdentifierNode *Id,
 ASTCNotGateNode *ASTCNotGateNode::CloneCall(const ASTIdentifierNode *Id,
                                             const ASTArgumentNodeList &AL,
                                             const ASTAnyTypeList &QL) {
+  QASM_INSTR_SCOPE(GateClone);
+
   assert(Id && "Invalid ASTIdentifierNode argument!");
 
   ASTIdentifierNode *GId =
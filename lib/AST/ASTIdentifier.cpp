@@ -36,6 +36,7 @@ namespace QASM {
 using DiagLevel = QASM::QasmDiagnosticEmitter::DiagLevel;
 
 uint64_t ASTIdentifierNode::SI = 0UL;
+unsigned ASTIdentifierNode::TG = 0U;
 
 ASTIdentifierNode __attribute__((init_priority(201)))
 ASTIdentifierNode::Char("char", ASTTypeChar, 8U);
@@ -377,7 +378,9 @@ ASTIdentifierNode::ASTIdentifierNode(const std::string &Id,
     : ASTExpression(), Name(Id), MangledName(), PolymorphicName(Id),
       MangledLiteralName(), IndexIdentifier(), Hash(0UL), MHash(0UL),
       MLHash(0UL), References(), Bits(B),
-      NumericIndex(static_cast<unsigned>(~0x0)), Indexed(true), NoQubit(false),
+      NumericIndex(static_cast<unsigned>(~0x0)), BaseName(), ReservedBase(),
+      NameIndex(static_cast<unsigned>(~0x0)), RSX(ReservedSuffixNone),
+      NameIndexed(false), Indexed(true), NoQubit(false),
       GateLocal(false), ComplexPart(false), HasSTE(false), RV(nullptr),
       BOP(BOp), EXP(nullptr), STE(nullptr),
       CTX(ASTDeclarationContextTracker::Instance().GetCurrentContext()),
@@ -386,13 +389,7 @@ ASTIdentifierNode::ASTIdentifierNode(const std::string &Id,
       SymScope(ASTDeclarationContextTracker::Instance().GetCurrentScope()),
       RD(false), IV(false), PRD(nullptr) {
   CTX->RegisterSymbol(this, GetASTType());
-  std::string::size_type LB = Name.find_last_of('[');
-  std::string::size_type RB = Name.find_last_of(']');
-  if (LB != std::string::npos && RB != std::string::npos) {
-    SetIndexed(true);
-    SetIndexIdentifier(LB, RB);
-    SetNumericIndex(LB, RB);
-  }
+  ParseName();
 }
 
 ASTIdentifierNode::ASTIdentifierNode(const std::string &Id,
@@ -400,7 +397,9 @@ ASTIdentifierNode::ASTIdentifierNode(const std::string &Id,
     : ASTExpression(), Name(Id), MangledName(), PolymorphicName(Id),
       MangledLiteralName(), IndexIdentifier(), Hash(0UL), MHash(0UL),
       MLHash(0UL), References(), Bits(B),
-      NumericIndex(static_cast<unsigned>(~0x0)), Indexed(true), NoQubit(false),
+      NumericIndex(static_cast<unsigned>(~0x0)), BaseName(), ReservedBase(),
+      NameIndex(static_cast<unsigned>(~0x0)), RSX(ReservedSuffixNone),
+      NameIndexed(false), Indexed(true), NoQubit(false),
       GateLocal(false), ComplexPart(false), HasSTE(false), RV(nullptr),
       UOP(UOp), EXP(nullptr), STE(nullptr),
       CTX(ASTDeclarationContextTracker::Instance().GetCurrentContext()),
@@ -409,13 +408,7 @@ ASTIdentifierNode::ASTIdentifierNode(const std::string &Id,
       SymScope(ASTDeclarationContextTracker::Instance().GetCurrentScope()),
       RD(false), IV(false), PRD(nullptr) {
   CTX->RegisterSymbol(this, GetASTType());
-  std::string::size_type LB = Name.find_last_of('[');
-  std::string::size_type RB = Name.find_last_of(']');
-  if (LB != std::string::npos && RB != std::string::npos) {
-    SetIndexed(true);
-    SetIndexIdentifier(LB, RB);
-    SetNumericIndex(LB, RB);
-  }
+  ParseName();
 }
 
 const ASTIdentifierNode *ASTExpression::GetIdentifier() const {
@@ -447,6 +440,7 @@ ASTIdentifierRefNode::ASTIdentifierRefNode(const std::string &US,
       IVX(), Index(static_cast<unsigned>(~0x0)), RTy(ASTTypeUndefined),
       IITy(ASTEXTypeSSA), ULV(LV) {
   this->CTX->UnregisterSymbol(IDN);
+  this->CTX->UnregisterSymbol(this);
   this->CTX = IDN->GetDeclarationContext();
   this->CTX->RegisterSymbol(this, GetASTType());
   SetIndex(IS);
@@ -580,7 +574,7 @@ void ASTIdentifierNode::SetSymbolTableEntry(ASTSymbolTableEntry *ST) {
   HasSTE = true;
   ASTType ETy = ST->GetValueType();
 
-  if (ASTStringUtils::Instance().IsIndexed(Name)) {
+  if (NameIndexed) {
     if (ASTExpressionValidator::Instance().IsArrayType(ETy)) {
       SType = ASTExpressionEvaluator::Instance().GetArrayElementType(ETy);
     } else if (ASTExpressionValidator::Instance().IsNonArrayIndexableType(
@@ -600,6 +594,9 @@ void ASTIdentifierNode::SetSymbolTableEntry(ASTSymbolTableEntry *ST) {
 }
 
 void ASTIdentifierNode::SetSymbolType(ASTType STy) {
+  if (SType != STy)
+    ++TG;
+
   SType = STy;
   STE->SetValueType(STy);
 }
@@ -608,6 +605,9 @@ void ASTIdentifierNode::SetPolymorphicType(ASTType PTy) { PType = PTy; }
 
 void ASTIdentifierNode::RestoreType() {
   if (PType != ASTTypeUndefined) {
+    if (SType != PType)
+      ++TG;
+
     SType = PType;
     STE->SetValueType(PType);
   }
@@ -181,17 +181,17 @@ bool ASTImplicitConversionNode::IsValidConversion(ASTType FromTy,
 bool ASTImplicitConversionNode::IsValidConversion() const {
   switch (FromType) {
   case ASTTypeIdentifier: {
+    ASTReservedSuffix RSX = Id->GetReservedSuffixKind();
+
     if (Id->GetSymbolType() == ASTTypeOpenPulseFrame) {
-      if (ASTStringUtils::Instance().IsOpenPulseFramePhase(Id->GetName()))
+      if (RSX == ReservedSuffixPhase)
         return IsValidConversion(ASTTypeAngle, ToType);
-      else if (ASTStringUtils::Instance().IsOpenPulseFrameFrequency(
-                   Id->GetName()))
+      else if (RSX == ReservedSuffixFreq || RSX == ReservedSuffixFrequency)
         return IsValidConversion(ASTTypeMPDecimal, ToType);
       else
         return IsValidConversion(ASTTypeOpenPulseFrame, ToType);
     } else if (Id->GetSymbolType() == ASTTypeMPComplex) {
-      if (ASTStringUtils::Instance().IsComplexCReal(Id->GetName()) ||
-          ASTStringUtils::Instance().IsComplexCImag(Id->GetName()))
+      if (RSX == ReservedSuffixCReal || RSX == ReservedSuffixCImag)
         return IsValidConversion(ASTTypeMPDecimal, ToType);
       else
         return IsValidConversion(ASTTypeMPComplex, ToType);
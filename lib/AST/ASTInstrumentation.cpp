@@ -0,0 +1,152 @@
+/* -*- coding: utf-8 -*-
+ *
+ * Copyright 2023 IBM RESEARCH. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#include <qasm/AST/ASTInstrumentation.h>
+#include <qasm/AST/ASTObjectTracker.h>
+
+#include <iomanip>
+
+namespace QASM {
+
+ASTInstrumentation ASTInstrumentation::AI;
+
+const char *ASTInstrumentation::PhaseName(Phase P) {
+  switch (P) {
+  case Preprocess:
+    return "preprocess";
+    break;
+  case IncludeResolution:
+    return "include_resolution";
+    break;
+  case Scan:
+    return "scan";
+    break;
+  case Parse:
+    return "parse";
+    break;
+  case TypeSystemInit:
+    return "type_system_init";
+    break;
+  case Mangle:
+    return "mangle";
+    break;
+  case SymbolInsert:
+    return "symbol_insert";
+    break;
+  case SymbolLookup:
+    return "symbol_lookup";
+    break;
+  case GateClone:
+    return "gate_clone";
+    break;
+  case Release:
+    return "release";
+    break;
+  default:
+    break;
+  }
+
+  return "unknown";
+}
+
+const char *ASTInstrumentation::CounterName(Counter C) {
+  switch (C) {
+  case Tokens:
+    return "tokens";
+    break;
+  case Chars:
+    return "chars";
+    break;
+  case Lines:
+    return "lines";
+    break;
+  case Nodes:
+    return "nodes";
+    break;
+  default:
+    break;
+  }
+
+  return "unknown";
+}
+
+void ASTInstrumentation::CountNodes() {
+  NM.clear();
+  Counters[Nodes] = 0;
+
+  const ASTObjectTracker &OT = ASTObjectTracker::Instance();
+  if (!OT.IsEnabled())
+    return;
+
+  for (std::map<std::uintptr_t, ASTMapObject>::const_iterator I =
+           OT.OM.begin();
+       I != OT.OM.end(); ++I) {
+    if ((*I).second.O && !(*I).second.D) {
+      ++NM[(*I).second.O->GetASTType()];
+      ++Counters[Nodes];
+    }
+  }
+}
+
+void ASTInstrumentation::Clear() {
+  for (unsigned I = 0; I < NumPhases; ++I) {
+    Nanos[I] = 0;
+    Calls[I] = 0;
+    Depth[I] = 0;
+    Start[I] = clock_type::time_point();
+  }
+
+  for (unsigned I = 0; I < NumCounters; ++I)
+    Counters[I] = 0;
+
+  NM.clear();
+}
+
+void ASTInstrumentation::PrintJSON(std::ostream &OS) const {
+  std::ios_base::fmtflags F = OS.flags();
+  std::streamsize PR = OS.precision();
+
+  OS << "{\n  \"enabled\": " << (IsEnabled() ? "true" : "false")
+     << ",\n  \"phases\": {\n";
+
+  OS << std::fixed << std::setprecision(3);
+  for (unsigned I = 0; I < NumPhases; ++I) {
+    Phase P = static_cast<Phase>(I);
+    OS << "    \"" << PhaseName(P) << "\": {\"ms\": " << GetMilliseconds(P)
+       << ", \"calls\": " << Calls[I] << "}"
+       << (I + 1 < NumPhases ? ",\n" : "\n");
+  }
+
+  OS << "  },\n  \"counters\": {\n";
+  for (unsigned I = 0; I < NumCounters; ++I)
+    OS << "    \"" << CounterName(static_cast<Counter>(I))
+       << "\": " << Counters[I] << (I + 1 < NumCounters ? ",\n" : "\n");
+
+  OS << "  },\n  \"nodes\": {";
+  for (std::map<ASTType, uint64_t>::const_iterator I = NM.begin();
+       I != NM.end(); ++I)
+    OS << (I == NM.begin() ? "\n" : ",\n") << "    \""
+       << PrintTypeEnum((*I).first) << "\": " << (*I).second;
+
+  OS << (NM.empty() ? "}\n}" : "\n  }\n}") << std::endl;
+
+  OS.flags(F);
+  OS.precision(PR);
+}
+
+} // namespace QASM
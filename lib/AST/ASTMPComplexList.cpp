@@ -54,8 +54,10 @@ void ASTMPComplexList::ConstructFromExpressionList(
                         "an ASTBinaryOpNode!");
           ASTMPComplexNode *MPC =
               new ASTMPComplexNode(&ASTIdentifierNode::MPComplex, CEN, 128);
-          List.push_back(
-              new ASTMPComplexRep(const_cast<ASTBinaryOpNode *>(BOP), MPC));
+          ASTMPComplexRep *CR =
+              new ASTMPComplexRep(const_cast<ASTBinaryOpNode *>(BOP), MPC);
+          CR->SetOwnsComplex(true);
+          List.push_back(CR);
         }
       } break;
       case ASTTypeUnaryOp: {
@@ -67,8 +69,10 @@ void ASTMPComplexList::ConstructFromExpressionList(
                         "an ASTUnaryOpNode!");
           ASTMPComplexNode *MPC =
               new ASTMPComplexNode(&ASTIdentifierNode::MPComplex, CEN, 128);
-          List.push_back(
-              new ASTMPComplexRep(const_cast<ASTUnaryOpNode *>(UOP), MPC));
+          ASTMPComplexRep *CR =
+              new ASTMPComplexRep(const_cast<ASTUnaryOpNode *>(UOP), MPC);
+          CR->SetOwnsComplex(true);
+          List.push_back(CR);
         }
       } break;
       case ASTTypeIdentifier: {
@@ -138,8 +142,9 @@ void ASTMPComplexList::ConstructFromExpressionList(
                 dynamic_cast<const ASTComplexExpressionNode *>(EN)) {
           ASTMPComplexNode *MPC =
               new ASTMPComplexNode(&ASTIdentifierNode::MPComplex, CEN, 128);
-          List.push_back(
-              new ASTMPComplexRep(const_cast<ASTMPComplexNode *>(MPC)));
+          ASTMPComplexRep *CR = new ASTMPComplexRep(MPC);
+          CR->SetOwnsComplex(true);
+          List.push_back(CR);
         }
       } break;
       default: {
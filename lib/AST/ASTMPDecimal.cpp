@@ -332,8 +332,8 @@ ASTMPComplexNode *ASTMPDecimalNode::ToMPComplex() const {
       new ASTMPDecimalNode(ASTIdentifierNode::MPDec.Clone(), Bits, 1.0);
   assert(MPCI && "Could not create a valid ASTMPDecimalNode!");
 
-  ASTMPDecimalNode *MPCR =
-      new ASTMPDecimalNode(ASTIdentifierNode::MPDec.Clone(), Bits, MPValue);
+  ASTMPDecimalNode *MPCR = new ASTMPDecimalNode(
+      ASTIdentifierNode::MPDec.Clone(), Bits, GetMPValue());
   assert(MPCI && "Could not create a valid ASTMPDecimalNode!");
 
   ASTMPComplexNode *MPC = new ASTMPComplexNode(
@@ -0,0 +1,144 @@
+/* -*- coding: utf-8 -*-
+ *
+ * Copyright 2023 IBM RESEARCH. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#include <qasm/AST/ASTMPFormatter.h>
+#include <qasm/AST/ASTStringUtils.h>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace QASM {
+
+static std::size_t Copy(char *Buf, std::size_t Size, const char *S) {
+  std::size_t L = std::strlen(S);
+  if (L < Size)
+    std::memcpy(Buf, S, L + 1U);
+
+  return L;
+}
+
+// Significant digits kept for values with no integral digits.
+static std::size_t FractionDigits(unsigned Bits) {
+  if (Bits <= 32U)
+    return 8U;
+  else if (Bits <= 64U)
+    return 16U;
+  else if (Bits <= 128U)
+    return 32U;
+
+  return 34U;
+}
+
+std::size_t ASTMPFormatter::Format(char *Buf, std::size_t Size,
+                                   const mpfr_t &MPV, int Base,
+                                   unsigned Bits) {
+  if (mpfr_nan_p(MPV))
+    return Copy(Buf, Size, "NaN");
+  else if (mpfr_zero_p(MPV))
+    return Copy(Buf, Size, "0.0");
+  else if (mpfr_inf_p(MPV))
+    return Copy(Buf, Size, "Inf");
+
+  if (Base < 2 || Base > 62)
+    Base = 10;
+
+  // Upper bound of the number of digits mpfr_get_str produces for n = 0,
+  // plus the sign and the terminating NUL.
+  unsigned LB = 0U;
+  while ((2 << LB) <= Base)
+    ++LB;
+
+  std::size_t DS = static_cast<std::size_t>(mpfr_get_prec(MPV)) / LB + 4U;
+  char SB[128];
+  std::vector<char> HB;
+  char *D = SB;
+  if (DS > sizeof(SB)) {
+    HB.resize(DS);
+    D = HB.data();
+  }
+
+  mpfr_exp_t E = 0;
+  if (!mpfr_get_str(D, &E, Base, 0, MPV, MPFR_RNDN))
+    return Copy(Buf, Size, "NaN");
+
+  const bool Neg = D[0] == u8'-';
+  if (Neg)
+    ++D;
+
+  const std::size_t ND = std::strlen(D);
+  std::size_t IP = 0U; // Integral digits.
+  std::size_t LZ = 0U; // Leading fraction zeros.
+  std::size_t NF = ND; // Significand digits written.
+
+  if (E > 0) {
+    IP = static_cast<std::size_t>(E);
+  } else {
+    LZ = static_cast<std::size_t>(-E);
+    NF = std::min(ND, FractionDigits(Bits));
+  }
+
+  // sign, integral part, '.', fraction, room for the trimmed '0', NUL.
+  const std::size_t L = (Neg ? 1U : 0U) + (IP ? std::max(IP, ND) : 1U) + 1U +
+                        LZ + (IP ? 0U : NF);
+  if (L + 2U > Size)
+    return L + 1U;
+
+  char *P = Buf;
+  if (Neg)
+    *P++ = u8'-';
+
+  if (IP) {
+    if (IP >= ND) {
+      std::memcpy(P, D, ND);
+      std::memset(P + ND, u8'0', IP - ND);
+      P += IP;
+      *P++ = u8'.';
+    } else {
+      std::memcpy(P, D, IP);
+      P += IP;
+      *P++ = u8'.';
+      std::memcpy(P, D + IP, ND - IP);
+      P += ND - IP;
+    }
+  } else {
+    *P++ = u8'0';
+    *P++ = u8'.';
+    std::memset(P, u8'0', LZ);
+    P += LZ;
+    std::memcpy(P, D, NF);
+    P += NF;
+  }
+
+  return ASTStringUtils::Instance().TrimTrailingZeros(
+      Buf, static_cast<std::size_t>(P - Buf));
+}
+
+std::string ASTMPFormatter::ToString(const mpfr_t &MPV, int Base,
+                                     unsigned Bits) {
+  char SB[256];
+  std::size_t L = Format(SB, sizeof(SB), MPV, Base, Bits);
+  if (L < sizeof(SB))
+    return std::string(SB, L);
+
+  std::vector<char> HB(L + 2U);
+  L = Format(HB.data(), HB.size(), MPV, Base, Bits);
+  return std::string(HB.data(), L);
+}
+
+} // namespace QASM
@@ -22,6 +22,8 @@
 #include <qasm/Diagnostic/DIAGLineCounter.h>
 #include <qasm/Frontend/QasmDiagnosticEmitter.h>
 
+#include <cstdint>
+#include <cstdlib>
 #include <sstream>
 #include <string>
 
@@ -39,90 +41,130 @@ namespace QASM {
 
 using DiagLevel = QasmDiagnosticEmitter::DiagLevel;
 
+// Parses a numeric string the way mpz_set_str would, as long as the
+// magnitude fits in 64 bits. Strings with whitespace, bases above 36 or
+// values that do not fit are left to GMP.
+static bool ParseInlineMPZ(const char *S, int Base, uint64_t &Mag,
+                           bool &Neg) {
+  if (!S || Base < 0 || Base == 1 || Base > 36)
+    return false;
+
+  Neg = *S == u8'-';
+  if (Neg)
+    ++S;
+
+  if (Base == 0) {
+    Base = 10;
+    if (S[0] == u8'0') {
+      Base = 8;
+      if (S[1] == u8'x' || S[1] == u8'X') {
+        Base = 16;
+        S += 2;
+      } else if (S[1] == u8'b' || S[1] == u8'B') {
+        Base = 2;
+        S += 2;
+      }
+    }
+  }
+
+  if (*S == u8'\0')
+    return false;
+
+  const uint64_t B = static_cast<uint64_t>(Base);
+  uint64_t R = 0;
+
+  for (; *S; ++S) {
+    uint64_t D;
+    if (*S >= u8'0' && *S <= u8'9')
+      D = static_cast<uint64_t>(*S - u8'0');
+    else if (*S >= u8'a' && *S <= u8'z')
+      D = static_cast<uint64_t>(*S - u8'a') + 10U;
+    else if (*S >= u8'A' && *S <= u8'Z')
+      D = static_cast<uint64_t>(*S - u8'A') + 10U;
+    else
+      return false;
+
+    if (D >= B || R > (UINT64_MAX - D) / B)
+      return false;
+
+    R = R * B + D;
+  }
+
+  Mag = R;
+  Neg = Neg && R != 0;
+  return true;
+}
+
+bool ASTMPIntegerNode::SetFromString(const char *S, int Base) {
+  if (Inline) {
+    uint64_t M;
+    bool N;
+
+    if (CanInline(Bits) && ParseInlineMPZ(S, Base, M, N)) {
+      SetInline(M, N);
+      return true;
+    }
+
+    Materialize();
+  }
+
+  if (mpz_set_str(MPValue, S, Base) != 0) {
+    mpz_set_ui(MPValue, 0UL);
+    return false;
+  }
+
+  return true;
+}
+
 void ASTMPIntegerNode::InitFromString(const char *NS, ASTSignbit SB,
                                       unsigned NumBits, int Base) {
   assert(NS && "Invalid numeric string argument!");
   std::string S = ASTStringUtils::Instance().Sanitize(std::string(NS));
-  bool E = false;
-
-  mpz_init2(MPValue, NumBits);
+  std::string SUS = S;
+  int B = Base;
 
-  if (SB == ASTSignbit::Unsigned) {
-    std::string SUS;
+  SetInline(0UL, false);
+  if (!CanInline(NumBits)) {
+    mpz_init2(MPValue, NumBits);
     mpz_set_ui(MPValue, 0UL);
+    Inline = false;
+  }
 
+  if (SB == ASTSignbit::Unsigned) {
     if (S[0] == u8'0' && (S[1] == u8'b' || S[1] == u8'B')) {
       SUS = S.substr(2);
-      if (mpz_set_str(MPValue, SUS.c_str(), 2) != 0) {
-        mpz_set_ui(MPValue, 0UL);
-        E = true;
-      }
+      B = 2;
     } else if (S[0] == u8'0' && (S[1] == u8'o' || S[1] == u8'O')) {
       SUS = u8"0" + S.substr(2);
-      if (mpz_set_str(MPValue, SUS.c_str(), 8) != 0) {
-        mpz_set_ui(MPValue, 0UL);
-        E = true;
-      }
+      B = 8;
     } else if (S[0] == u8'0' && (S[1] == u8'x' || S[1] == u8'X')) {
-      if (mpz_set_str(MPValue, S.c_str(), 0) != 0) {
-        mpz_set_ui(MPValue, 0UL);
-        E = true;
-      }
-    } else if (mpz_set_str(MPValue, S.c_str(), Base) != 0) {
-      mpz_set_ui(MPValue, 0UL);
-      E = true;
+      B = 0;
     }
   } else {
     bool N = NS[0] == u8'-';
-    mpz_set_si(MPValue, 0L);
-    std::string SUS;
 
     if (S[0] == u8'-' || S[0] == u8'+') {
       if (S[1] == u8'0' && (S[2] == u8'b' || S[2] == u8'B')) {
         SUS = N ? u8"-" + S.substr(3) : S.substr(3);
-        if (mpz_set_str(MPValue, SUS.c_str(), 2) != 0) {
-          mpz_set_si(MPValue, 0UL);
-          E = true;
-        }
+        B = 2;
       } else if (S[1] == u8'0' && (S[2] == u8'o' || S[2] == u8'O')) {
         SUS = N ? u8"-0" + S.substr(3) : u8"0" + S.substr(3);
-        if (mpz_set_str(MPValue, SUS.c_str(), 8) != 0) {
-          mpz_set_si(MPValue, 0UL);
-          E = true;
-        }
+        B = 8;
       } else if (S[1] == u8'0' && (S[2] == u8'x' || S[2] == u8'X')) {
-        if (mpz_set_str(MPValue, S.c_str(), 0) != 0) {
-          mpz_set_si(MPValue, 0UL);
-          E = true;
-        }
-      } else if (mpz_set_str(MPValue, S.c_str(), Base) != 0) {
-        mpz_set_si(MPValue, 0UL);
-        E = true;
+        B = 0;
       }
     } else if (S[0] == u8'0' && (S[1] == u8'b' || S[1] == u8'B')) {
       SUS = S.substr(2);
-      if (mpz_set_str(MPValue, SUS.c_str(), 2) != 0) {
-        mpz_set_si(MPValue, 0UL);
-        E = true;
-      }
+      B = 2;
     } else if (S[0] == u8'0' && (S[1] == u8'o' || S[1] == u8'O')) {
       SUS = u8"0" + S.substr(2);
-      if (mpz_set_str(MPValue, SUS.c_str(), 8) != 0) {
-        mpz_set_si(MPValue, 0UL);
-        E = true;
-      }
+      B = 8;
     } else if (S[0] == u8'0' && (S[1] == u8'x' || S[1] == u8'X')) {
-      if (mpz_set_str(MPValue, S.c_str(), 0) != 0) {
-        mpz_set_si(MPValue, 0UL);
-        E = true;
-      }
-    } else if (mpz_set_str(MPValue, S.c_str(), Base) != 0) {
-      mpz_set_si(MPValue, 0UL);
-      E = true;
+      B = 0;
     }
   }
 
-  if (E) {
+  if (!SetFromString(SUS.c_str(), B)) {
     Bits = 0;
     std::stringstream M;
     M << "Invalid string representation of multiple precision numeric value.";
@@ -234,6 +276,26 @@ std::string ASTMPIntegerNode::GetValue(int Base) const {
     return "0";
   }
 
+  if (Inline && Base >= -36 && Base <= 36) {
+    const char *DS = Base < 0 ? "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+                              : "0123456789abcdefghijklmnopqrstuvwxyz";
+    const uint64_t B =
+        Base > -2 && Base < 2 ? 10U : static_cast<uint64_t>(std::abs(Base));
+    char Buf[66];
+    char *P = Buf + sizeof(Buf);
+    uint64_t V = IMag;
+
+    do {
+      *--P = DS[V % B];
+      V /= B;
+    } while (V);
+
+    if (INeg)
+      *--P = u8'-';
+
+    return std::string(P, Buf + sizeof(Buf) - P);
+  }
+
   char *S = mpz_get_str(NULL, Base, MPValue);
   std::string R;
   if (S) {
@@ -279,7 +341,13 @@ void ASTMPIntegerNode::SetImplicitConversion(
 ASTMPDecimalNode *ASTMPIntegerNode::AsMPDecimal() const {
   mpfr_t MPV;
   mpfr_init2(MPV, ASTMPDecimalNode::DefaultBits);
-  mpfr_set_z(MPV, MPValue, MPFR_RNDN);
+  if (Inline) {
+    mpfr_set_ui(MPV, IMag, MPFR_RNDN);
+    if (INeg)
+      mpfr_neg(MPV, MPV, MPFR_RNDN);
+  } else {
+    mpfr_set_z(MPV, MPValue, MPFR_RNDN);
+  }
 
   ASTMPDecimalNode *MPD = new ASTMPDecimalNode(
       ASTIdentifierNode::MPDec.Clone(), ASTMPDecimalNode::DefaultBits, MPV);
@@ -0,0 +1,204 @@
+/* -*- coding: utf-8 -*-
+ *
+ * Copyright 2023 IBM RESEARCH. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#include <qasm/AST/ASTMPMemoryPool.h>
+
+#include <gmp.h>
+#include <mpfr.h>
+
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+
+namespace QASM {
+
+ASTMPMemoryPool ASTMPMemoryPool::MMP;
+
+// Every chunk starts with a header recording its size class, its epoch
+// and its number of blocks in use. Blocks are carved after it.
+static const std::size_t ChunkHeaderSize = 64U;
+
+unsigned ASTMPMemoryPool::ClassOf(std::size_t Size) {
+  unsigned C = 0;
+  std::size_t S = MinBlockSize;
+
+  while (S < Size) {
+    S <<= 1;
+    ++C;
+  }
+
+  return C;
+}
+
+bool ASTMPMemoryPool::NewChunk(unsigned C) {
+  static_assert(sizeof(ChunkHeader) <= ChunkHeaderSize,
+                "The chunk header does not fit in its reserved space!");
+
+  void *P = std::aligned_alloc(ChunkSize, ChunkSize);
+  if (!P)
+    return false;
+
+  ChunkHeader *H = static_cast<ChunkHeader *>(P);
+  H->Class = C;
+  H->Epoch = Epoch;
+  H->Live = 0U;
+  Chunks->insert(reinterpret_cast<uintptr_t>(P));
+
+  SC[C].Cur = static_cast<char *>(P) + ChunkHeaderSize;
+  SC[C].End = static_cast<char *>(P) + ChunkSize;
+  return true;
+}
+
+void ASTMPMemoryPool::FreeChunk(ChunkHeader *H) {
+  Chunks->erase(reinterpret_cast<uintptr_t>(H));
+  std::free(H);
+}
+
+void *ASTMPMemoryPool::Allocate(std::size_t Size) {
+  ASTMPMemoryPool &MP = MMP;
+
+  if (Size > MaxBlockSize) {
+    void *P = std::malloc(Size);
+    assert(P && "Out of memory allocating GMP limbs!");
+    return P;
+  }
+
+  unsigned C = ClassOf(Size);
+  SizeClass &S = MP.SC[C];
+  void *P;
+
+  if (S.FreeList) {
+    P = S.FreeList;
+    S.FreeList = S.FreeList->Next;
+    ++MP.Recycled;
+  } else {
+    if (S.Cur + ClassSize(C) > S.End && !MP.NewChunk(C))
+      return std::malloc(Size);
+
+    P = S.Cur;
+    S.Cur += ClassSize(C);
+  }
+
+  ++HeaderOf(P)->Live;
+  ++MP.Live;
+  ++MP.Allocs;
+  return P;
+}
+
+void *ASTMPMemoryPool::Reallocate(void *P, std::size_t OldSize,
+                                  std::size_t NewSize) {
+  ASTMPMemoryPool &MP = MMP;
+
+  if (!P)
+    return Allocate(NewSize);
+
+  if (!MP.Owns(P))
+    return std::realloc(P, NewSize);
+
+  std::size_t CS = ClassSize(HeaderOf(P)->Class);
+  if (NewSize <= CS)
+    return P;
+
+  void *R = Allocate(NewSize);
+  std::memcpy(R, P, OldSize < CS ? OldSize : CS);
+  Free(P, OldSize);
+  return R;
+}
+
+void ASTMPMemoryPool::Free(void *P, std::size_t Size) {
+  (void)Size;
+  ASTMPMemoryPool &MP = MMP;
+
+  if (!P)
+    return;
+
+  if (!MP.Owns(P)) {
+    std::free(P);
+    return;
+  }
+
+  ChunkHeader *H = HeaderOf(P);
+  assert(MP.Live && H->Live && "Unbalanced GMP limb deallocation!");
+  --MP.Live;
+  --H->Live;
+
+  // The blocks of a retired chunk are not reused.
+  if (H->Epoch != MP.Epoch) {
+    if (H->Live == 0U)
+      MP.FreeChunk(H);
+    return;
+  }
+
+  FreeBlock *FB = static_cast<FreeBlock *>(P);
+  SizeClass &S = MP.SC[H->Class];
+  FB->Next = S.FreeList;
+  S.FreeList = FB;
+}
+
+void ASTMPMemoryPool::Enable() {
+  if (Installed)
+    return;
+
+  if (!Chunks)
+    Chunks = new std::unordered_set<uintptr_t>();
+
+  // MPFR keeps a cache of GMP integers allocated with the current
+  // memory functions. It must be drained before they are replaced.
+  mpfr_mp_memory_cleanup();
+  mp_set_memory_functions(Allocate, Reallocate, Free);
+  Installed = true;
+}
+
+void ASTMPMemoryPool::Release() {
+  if (!Installed)
+    return;
+
+  // Cached MPFR constants live in pooled blocks too.
+  mpfr_free_cache();
+
+  // The free lists and the bump pointers point into the chunks of the
+  // epoch that ends.
+  for (unsigned I = 0; I < NumClasses; ++I)
+    SC[I] = SizeClass();
+
+  ++Epoch;
+
+  for (std::unordered_set<uintptr_t>::iterator I = Chunks->begin();
+       I != Chunks->end();) {
+    ChunkHeader *H = reinterpret_cast<ChunkHeader *>(*I);
+    if (H->Live == 0U) {
+      I = Chunks->erase(I);
+      std::free(H);
+    } else {
+      ++I;
+    }
+  }
+}
+
+std::size_t ASTMPMemoryPool::GetNumEmptyChunks() const {
+  std::size_t N = 0U;
+
+  if (Chunks) {
+    for (uintptr_t C : *Chunks)
+      N += reinterpret_cast<const ChunkHeader *>(C)->Live == 0U;
+  }
+
+  return N;
+}
+
+} // namespace QASM
@@ -0,0 +1,286 @@
+/* -*- coding: utf-8 -*-
+ *
+ * Copyright 2023 IBM RESEARCH. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#include <qasm/AST/ASTIdentifier.h>
+#include <qasm/AST/ASTMemoryAccounting.h>
+#include <qasm/AST/ASTObjectTracker.h>
+#include <qasm/AST/ASTSymbolTable.h>
+#include <qasm/AST/ASTTypes.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include <gmp.h>
+#include <mpc.h>
+#include <mpfr.h>
+
+namespace QASM {
+
+ASTMemoryAccounting ASTMemoryAccounting::MA;
+
+// Approximate size of the node of a red-black tree, without its value:
+// the color, and the parent, left and right links.
+static const std::size_t MapNodeOverhead = 4U * sizeof(void *);
+
+static uint64_t MPZBytes(const mpz_t &MPZ) {
+  return static_cast<uint64_t>(MPZ->_mp_alloc) * sizeof(mp_limb_t);
+}
+
+static uint64_t MPFRBytes(const mpfr_t &MPFR) {
+  return static_cast<uint64_t>(mpfr_custom_get_size(mpfr_get_prec(MPFR)));
+}
+
+static uint64_t MPCBytes(const mpc_t &MPC) {
+  return MPFRBytes(mpc_realref(MPC)) + MPFRBytes(mpc_imagref(MPC));
+}
+
+template <typename __Map>
+static void AccountMap(const __Map &M, ASTMemoryAccounting::Record &MR,
+                       std::set<const ASTSymbolTableEntry *> &ES) {
+  for (typename __Map::const_iterator I = M.begin(); I != M.end(); ++I) {
+    MR.Add(MapNodeOverhead + sizeof(typename __Map::value_type));
+    ES.insert((*I).second);
+  }
+}
+
+template <typename __Map>
+static void AccountStringMap(const __Map &M, ASTMemoryAccounting::Record &MR,
+                             std::set<const ASTSymbolTableEntry *> &ES) {
+  AccountMap(M, MR, ES);
+  for (typename __Map::const_iterator I = M.begin(); I != M.end(); ++I)
+    MR.Add(ASTMemoryAccounting::HeapSize((*I).first), 0UL);
+}
+
+const char *ASTMemoryAccounting::CategoryName(Category C) {
+  switch (C) {
+  case SymbolTableMaps:
+    return "symbol table maps";
+    break;
+  case SymbolTableEntries:
+    return "symbol table entries";
+    break;
+  case MPLimbs:
+    return "MP limbs";
+    break;
+  case Tokens:
+    return "tokens";
+    break;
+  case TokenStrings:
+    return "token strings";
+    break;
+  case MangledNames:
+    return "mangled names";
+    break;
+  default:
+    break;
+  }
+
+  return "unknown";
+}
+
+std::size_t ASTMemoryAccounting::HeapSize(const std::string &S) {
+  const char *D = S.data();
+  const char *B = reinterpret_cast<const char *>(&S);
+  if (D >= B && D < B + sizeof(S))
+    return 0UL;
+
+  return S.capacity() + 1UL;
+}
+
+void ASTMemoryAccounting::CollectNodes() {
+  const ASTObjectTracker &OT = ASTObjectTracker::Instance();
+
+  for (std::map<std::uintptr_t, ASTMapObject>::const_iterator I =
+           OT.OM.begin();
+       I != OT.OM.end(); ++I) {
+    const ASTBase *OB = (*I).second.O;
+    if (!OB || (*I).second.D)
+      continue;
+
+    ASTType Ty = OB->GetASTType();
+    uint64_t B = GetAllocationSize(dynamic_cast<const void *>(OB));
+    TM[Ty].Add(B);
+    Nodes.Add(B);
+
+    switch (Ty) {
+    case ASTTypeIdentifier:
+    case ASTTypeIdentifierRef:
+      if (const ASTIdentifierNode *Id =
+              dynamic_cast<const ASTIdentifierNode *>(OB)) {
+        Aux[MangledNames].Add(HeapSize(Id->GetMangledName()) +
+                                  HeapSize(Id->GetMangledLiteralName()),
+                              2UL);
+      }
+      break;
+    case ASTTypeMPInteger:
+      if (const ASTMPIntegerNode *MPI =
+              dynamic_cast<const ASTMPIntegerNode *>(OB)) {
+        if (!MPI->IsInline())
+          Aux[MPLimbs].Add(MPZBytes(MPI->GetMPValue()));
+      }
+      break;
+    case ASTTypeMPDecimal:
+      if (const ASTMPDecimalNode *MPD =
+              dynamic_cast<const ASTMPDecimalNode *>(OB)) {
+        if (!MPD->IsInline())
+          Aux[MPLimbs].Add(MPFRBytes(MPD->GetMPValue()));
+      }
+      break;
+    case ASTTypeMPComplex:
+      if (const ASTMPComplexNode *MPC =
+              dynamic_cast<const ASTMPComplexNode *>(OB))
+        Aux[MPLimbs].Add(MPCBytes(MPC->GetMPValue()));
+      break;
+    case ASTTypeAngle:
+      if (const ASTAngleNode *AN = dynamic_cast<const ASTAngleNode *>(OB)) {
+        if (!AN->IsInline())
+          Aux[MPLimbs].Add(MPFRBytes(AN->GetMPValue()));
+      }
+      break;
+    default:
+      break;
+    }
+  }
+}
+
+void ASTMemoryAccounting::CollectSymbolTable() {
+  std::set<const ASTSymbolTableEntry *> ES;
+  Record &MR = Aux[SymbolTableMaps];
+
+  AccountStringMap(ASTSymbolTable::STM, MR, ES);
+  AccountStringMap(ASTSymbolTable::ASTM, MR, ES);
+  AccountStringMap(ASTSymbolTable::QSTM, MR, ES);
+  AccountStringMap(ASTSymbolTable::GSTM, MR, ES);
+  AccountStringMap(ASTSymbolTable::SGSTM, MR, ES);
+  AccountMap(ASTSymbolTable::HGSTM, MR, ES);
+  AccountStringMap(ASTSymbolTable::GPSTM, MR, ES);
+  AccountStringMap(ASTSymbolTable::DSTM, MR, ES);
+  AccountStringMap(ASTSymbolTable::SDSTM, MR, ES);
+  AccountMap(ASTSymbolTable::HDSTM, MR, ES);
+  AccountStringMap(ASTSymbolTable::FSTM, MR, ES);
+  AccountStringMap(ASTSymbolTable::SFSTM, MR, ES);
+  AccountMap(ASTSymbolTable::HFSTM, MR, ES);
+  AccountStringMap(ASTSymbolTable::CSTM, MR, ES);
+  AccountStringMap(ASTSymbolTable::GLSTM, MR, ES);
+  AccountStringMap(ASTSymbolTable::LSTM, MR, ES);
+  AccountStringMap(ASTSymbolTable::USTM, MR, ES);
+
+  // An entry can be reachable from more than one map.
+  ES.erase(nullptr);
+  Aux[SymbolTableEntries].Add(ES.size() * sizeof(ASTSymbolTableEntry),
+                              ES.size());
+}
+
+void ASTMemoryAccounting::CollectTokens() {
+  for (std::map<uint32_t, ASTToken *>::const_iterator I =
+           ASTTokenFactory::TFM.begin();
+       I != ASTTokenFactory::TFM.end(); ++I) {
+    Aux[Tokens].Add(
+        MapNodeOverhead +
+        sizeof(std::map<uint32_t, ASTToken *>::value_type) +
+        sizeof(ASTToken));
+
+    if ((*I).second)
+      Aux[TokenStrings].Add(HeapSize((*I).second->GetString()));
+  }
+}
+
+void ASTMemoryAccounting::Collect() {
+  Clear();
+
+  if (!Enabled)
+    return;
+
+  if (ASTObjectTracker::Instance().IsEnabled())
+    CollectNodes();
+
+  CollectSymbolTable();
+  CollectTokens();
+}
+
+void ASTMemoryAccounting::Clear() {
+  TM.clear();
+  Nodes = Record();
+
+  for (unsigned I = 0; I < NumCategories; ++I)
+    Aux[I] = Record();
+}
+
+uint64_t ASTMemoryAccounting::GetTotalBytes() const {
+  uint64_t B = Nodes.Bytes;
+
+  for (unsigned I = 0; I < NumCategories; ++I)
+    B += Aux[I].Bytes;
+
+  return B;
+}
+
+void ASTMemoryAccounting::Print(std::ostream &OS) const {
+  typedef std::pair<std::string, Record> Row;
+
+  std::vector<Row> RV;
+  for (std::map<ASTType, Record>::const_iterator I = TM.begin();
+       I != TM.end(); ++I)
+    RV.push_back(Row(PrintTypeEnum((*I).first), (*I).second));
+
+  for (unsigned I = 0; I < NumCategories; ++I) {
+    if (Aux[I].Count)
+      RV.push_back(
+          Row(std::string("[") + CategoryName(static_cast<Category>(I)) + "]",
+              Aux[I]));
+  }
+
+  std::stable_sort(RV.begin(), RV.end(), [](const Row &L, const Row &R) {
+    return L.second.Bytes > R.second.Bytes;
+  });
+
+  const uint64_t Total = GetTotalBytes();
+  const unsigned BarWidth = 30U;
+
+  std::ios_base::fmtflags F = OS.flags();
+  std::streamsize PR = OS.precision();
+
+  OS << "Memory accounting: " << Total << " bytes, " << Nodes.Count
+     << " nodes (" << Nodes.Bytes << " bytes).\n";
+  OS << "Peak AST node memory: " << PeakBytes << " bytes.\n";
+  OS << std::left << std::setw(40) << "Type" << std::right << std::setw(10)
+     << "Count" << std::setw(14) << "Bytes" << std::setw(8) << "%"
+     << "\n";
+
+  OS << std::fixed << std::setprecision(1);
+  for (std::vector<Row>::const_iterator I = RV.begin(); I != RV.end(); ++I) {
+    double P = Total ? 100.0 * static_cast<double>((*I).second.Bytes) /
+                           static_cast<double>(Total)
+                     : 0.0;
+    unsigned W = static_cast<unsigned>(P * BarWidth / 100.0 + 0.5);
+
+    OS << std::left << std::setw(40) << (*I).first << std::right
+       << std::setw(10) << (*I).second.Count << std::setw(14)
+       << (*I).second.Bytes << std::setw(8) << P << " "
+       << std::string(W, '#') << "\n";
+  }
+
+  OS << std::flush;
+  OS.flags(F);
+  OS.precision(PR);
+}
+
+} // namespace QASM
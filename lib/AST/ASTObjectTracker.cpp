@@ -19,12 +19,16 @@
 #include <qasm/AST/ASTAngleNodeBuilder.h>
 #include <qasm/AST/ASTAnyTypeBuilder.h>
 #include <qasm/AST/ASTArgumentNodeBuilder.h>
+#include <qasm/AST/ASTConstantFolder.h>
 #include <qasm/AST/ASTCtrlAssocBuilder.h>
+#include <qasm/AST/ASTDeclarationContext.h>
 #include <qasm/AST/ASTDeclarationBuilder.h>
 #include <qasm/AST/ASTDefcalBuilder.h>
+#include <qasm/AST/ASTDefcalDispatchIndex.h>
 #include <qasm/AST/ASTDefcalParameterBuilder.h>
 #include <qasm/AST/ASTDefcalStatementBuilder.h>
 #include <qasm/AST/ASTExpressionBuilder.h>
+#include <qasm/AST/ASTExpressionEvaluator.h>
 #include <qasm/AST/ASTForRangeInitBuilder.h>
 #include <qasm/AST/ASTForStatementBuilder.h>
 #include <qasm/AST/ASTFunctionParameterBuilder.h>
@@ -34,10 +38,13 @@
 #include <qasm/AST/ASTHeapSizeController.h>
 #include <qasm/AST/ASTIdentifierBuilder.h>
 #include <qasm/AST/ASTIfStatementTracker.h>
+#include <qasm/AST/ASTInstrumentation.h>
 #include <qasm/AST/ASTIntegerListBuilder.h>
 #include <qasm/AST/ASTIntegerSequenceBuilder.h>
 #include <qasm/AST/ASTInverseAssocBuilder.h>
 #include <qasm/AST/ASTKernelStatementBuilder.h>
+#include <qasm/AST/ASTLiteralPool.h>
+#include <qasm/AST/ASTMPMemoryPool.h>
 #include <qasm/AST/ASTObjectTracker.h>
 #include <qasm/AST/ASTParameterBuilder.h>
 #include <qasm/AST/ASTQubitNodeBuilder.h>
@@ -46,6 +53,7 @@
 #include <qasm/AST/ASTTypeEnums.h>
 #include <qasm/AST/ASTTypes.h>
 #include <qasm/AST/ASTWhileStatementBuilder.h>
+#include <qasm/AST/OpenPulse/ASTOpenPulseWaveformSynthesizer.h>
 
 #include <qasm/Frontend/QasmDiagnosticEmitter.h>
 #include <qasm/Frontend/QasmScanner.h>
@@ -145,43 +153,74 @@ void ASTObjectTracker::InitMemoryMap() {
   }
 }
 
+// The objects that the ASTObjectTracker owns: the statements that are
+// not directives, the declarations, the expressions and the parameters.
+// Defcals are not owned.
+static bool IsOwned(const ASTBase *OB) {
+  if (dynamic_cast<const ASTDefcalNode *>(OB))
+    return false;
+
+  if (const ASTStatementNode *SN = dynamic_cast<const ASTStatementNode *>(OB))
+    return !SN->IsDirective() ||
+           (SN->IsDeclaration() &&
+            dynamic_cast<const ASTDeclarationNode *>(SN));
+
+  return dynamic_cast<const ASTExpressionNode *>(OB) ||
+         dynamic_cast<const ASTParameter *>(OB);
+}
+
+static const ASTDeclarationContext *GetDeclarationContext(const ASTBase *OB) {
+  if (const ASTExpressionNode *EN = dynamic_cast<const ASTExpressionNode *>(OB))
+    return EN->GetDeclarationContext();
+  if (const ASTStatementNode *SN = dynamic_cast<const ASTStatementNode *>(OB))
+    return SN->GetDeclarationContext();
+  if (const ASTIdentifierNode *Id = dynamic_cast<const ASTIdentifierNode *>(OB))
+    return Id->GetDeclarationContext();
+
+  return nullptr;
+}
+
+void ASTObjectTracker::ReleaseMarked() {
+  std::vector<const ASTBase *> RV;
+  RV.swap(MV);
+
+  for (std::vector<const ASTBase *>::reverse_iterator I = RV.rbegin();
+       I != RV.rend(); ++I) {
+    std::map<std::uintptr_t, ASTMapObject>::iterator OI =
+        OM.find(reinterpret_cast<std::uintptr_t>(*I));
+    if (OI == OM.end() || (*OI).second.D || (*OI).second.O != *I)
+      continue;
+
+    const ASTBase *OB = (*OI).second.O;
+    if (IsOnHeap(OB) && OB->IsRegistered() &&
+        (IsOwned(OB) || dynamic_cast<const ASTIdentifierNode *>(OB))) {
+      if (const ASTDeclarationContext *DCX = GetDeclarationContext(OB))
+        DCX->UnregisterSymbol(OB);
+
+      OM.erase(OI);
+      delete OB;
+    }
+  }
+}
+
 void ASTObjectTracker::Release() {
+  QASM_INSTR_SCOPE(Release);
+
   if (EnableFree) {
+    // A parse that was abandoned may have left declaration contexts open.
+    // They are popped before they are deleted.
+    ASTDeclarationContextTracker::Instance().PopToGlobalContext();
+
     InitMemoryMap();
     for (std::map<std::size_t, ASTMapObject>::reverse_iterator I = OM.rbegin();
          I != OM.rend(); ++I) {
       const ASTBase *OB = (*I).second.O;
 
       if (OB && !(*I).second.D && IsOnHeap(OB) && OB->IsRegistered()) {
-        if (const ASTDefcalNode *DCN =
-                dynamic_cast<const ASTDefcalNode *>(OB)) {
-          (void)DCN; // silence compiler warning
+        if (dynamic_cast<const ASTDefcalNode *>(OB)) {
           (*I).second.O = nullptr;
           (*I).second.D = true;
-        } else if (const ASTStatementNode *SN =
-                       dynamic_cast<const ASTStatementNode *>(OB)) {
-          if (SN && !SN->IsDirective()) {
-            delete (*I).second.O;
-            (*I).second.O = nullptr;
-            (*I).second.D = true;
-          } else if (SN && SN->IsDeclaration()) {
-            if (const ASTDeclarationNode *DN =
-                    dynamic_cast<const ASTDeclarationNode *>(SN)) {
-              (void)DN; // silence compiler warning
-              delete (*I).second.O;
-              (*I).second.O = nullptr;
-              (*I).second.D = true;
-            }
-          }
-        } else if (const ASTExpressionNode *EN =
-                       dynamic_cast<const ASTExpressionNode *>(OB)) {
-          (void)EN; // silence compiler warning
-          delete (*I).second.O;
-          (*I).second.O = nullptr;
-          (*I).second.D = true;
-        } else if (const ASTParameter *PN =
-                       dynamic_cast<const ASTParameter *>(OB)) {
-          (void)PN; // silence compiler warning
+        } else if (IsOwned(OB)) {
           delete (*I).second.O;
           (*I).second.O = nullptr;
           (*I).second.D = true;
@@ -195,12 +234,15 @@ void ASTObjectTracker::Release() {
     ASTArgumentNodeBuilder::Instance().Clear();
     ASTBinaryOpAssignBuilder::Instance().Clear();
     ASTBoxStatementBuilder::Instance().Clear();
+    ASTConstantFolder::Instance().Clear();
     ASTCtrlAssocListBuilder::Instance().Clear();
     ASTDeclarationBuilder::Instance().Clear();
     ASTDefcalBuilder::Instance().Clear();
+    ASTDefcalDispatchIndex::Instance().Clear();
     ASTDefcalParameterBuilder::Instance().Clear();
     ASTDefcalStatementBuilder::Instance().Clear();
     ASTExpressionBuilder::Instance().Clear();
+    ASTExpressionEvaluator::Instance().ClearCache();
     ASTForRangeInitListBuilder::Instance().Clear();
     ASTForStatementBuilder::Instance().Clear();
     ASTFunctionParameterBuilder::Instance().Clear();
@@ -214,15 +256,18 @@ void ASTObjectTracker::Release() {
     ASTIntegerSequenceBuilder::Instance().Clear();
     ASTInverseAssocListBuilder::Instance().Clear();
     ASTKernelStatementBuilder::Instance().Clear();
+    ASTLiteralPool::Instance().Clear();
     ASTNamedTypeDeclarationBuilder::Instance().Clear();
     ASTParameterBuilder::Instance().Clear();
     ASTQubitNodeBuilder::Instance().Clear();
     ASTWhileStatementBuilder::Instance().Clear();
+    OpenPulse::ASTOpenPulseWaveformSynthesizer::Instance().Clear();
     ASTStatementBuilder::Instance().Clear();
     ASTSymbolTable::Instance().Release();
     ASTScanner::Release();
     ASTObjectTracker::Instance().Clear();
     ASTTokenFactory::Clear();
+    ASTMPMemoryPool::Instance().Release();
   }
 }
 
@@ -232,6 +277,8 @@ void ASTObjectTracker::ParseSegment(const std::string &S, ASTSegmentMap &SM) {}
 
 void ASTObjectTracker::InitMemoryMap() {}
 
+void ASTObjectTracker::ReleaseMarked() { MV.clear(); }
+
 void ASTObjectTracker::Release() {}
 
 #endif // defined(__linux__) || defined(__APPLE__)
@@ -18,19 +18,110 @@
 
 #include <qasm/AST/ASTFunctionCallExpr.h>
 #include <qasm/AST/ASTMangler.h>
+#include <qasm/AST/ASTObjectTracker.h>
 #include <qasm/AST/ASTResult.h>
 #include <qasm/AST/OpenPulse/ASTOpenPulseWaveform.h>
 #include <qasm/Diagnostic/DIAGLineCounter.h>
 #include <qasm/Frontend/QasmDiagnosticEmitter.h>
 
 #include <cassert>
+#include <iomanip>
 #include <iostream>
+#include <sstream>
 
 namespace QASM {
 namespace OpenPulse {
 
 using DiagLevel = QASM::QasmDiagnosticEmitter::DiagLevel;
 
+bool ASTOpenPulseWaveformNode::PS = false;
+
+// Takes a node built for a sample out of its declaration context and the
+// object tracker, and deletes it.
+static void ReleaseSampleNode(ASTExpressionNode *EN) {
+  if (!EN)
+    return;
+
+  if (const ASTDeclarationContext *DCX = EN->GetDeclarationContext())
+    DCX->UnregisterSymbol(EN);
+
+  ASTObjectTracker::Instance().Unregister(EN);
+  delete EN;
+}
+
+bool ASTOpenPulseWaveformNode::PackSamples() {
+  if (!PS || CXV.Empty())
+    return false;
+
+  std::vector<std::complex<double>> S;
+  S.reserve(CXV.Size());
+
+  for (ASTMPComplexList::const_iterator I = CXV.begin(); I != CXV.end();
+       ++I) {
+    const ASTMPComplexRep *CR = *I;
+    const ASTMPComplexNode *MPC = CR ? CR->GetComplex() : nullptr;
+
+    if (!MPC || MPC->IsError() || MPC->NeedsEval() || MPC->IsNan() ||
+        MPC->GetFunctionCall())
+      return false;
+
+    if ((CR->GetIdentifier() || CR->GetIdentifierRef()) &&
+        MPC->GetBits() > WaveformBits)
+      return false;
+
+    mpfr_srcptr RE = mpc_realref(MPC->GetMPValue());
+    mpfr_srcptr IM = mpc_imagref(MPC->GetMPValue());
+    double R = mpfr_get_d(RE, MPFR_RNDN);
+    double J = mpfr_get_d(IM, MPFR_RNDN);
+
+    // A literal that needs more precision than a double keeps it.
+    if (mpfr_cmp_d(RE, R) != 0 || mpfr_cmp_d(IM, J) != 0)
+      return false;
+
+    S.emplace_back(R, J);
+  }
+
+  // The complex values built for binary op, unary op and complex
+  // expression samples belong to the sample list, and so do the complex
+  // expressions built for binary and unary op samples. Everything else
+  // is shared.
+  for (ASTMPComplexList::iterator I = CXV.begin(); I != CXV.end(); ++I) {
+    ASTMPComplexRep *CR = *I;
+
+    if (CR->OwnsComplex()) {
+      ASTMPComplexNode *MPC = CR->GetComplex();
+
+      if (CR->GetBinaryOp() || CR->GetUnaryOp())
+        ReleaseSampleNode(
+            const_cast<ASTExpressionNode *>(MPC->GetExpression()));
+
+      ReleaseSampleNode(MPC);
+    }
+
+    ASTObjectTracker::Instance().Unregister(CR);
+    delete CR;
+  }
+
+  CXV.Clear();
+  SMP.swap(S);
+  return true;
+}
+
+std::complex<double> ASTOpenPulseWaveformNode::GetSample(unsigned Index) const {
+  assert(Index < GetNumSamples() && "Index is out-of-range!");
+
+  if (!SMP.empty())
+    return SMP[Index];
+
+  const ASTMPComplexNode *MPC = CXV.GetComplex(Index);
+  if (!MPC)
+    return std::complex<double>();
+
+  return std::complex<double>(
+      mpfr_get_d(mpc_realref(MPC->GetMPValue()), MPFR_RNDN),
+      mpfr_get_d(mpc_imagref(MPC->GetMPValue()), MPFR_RNDN));
+}
+
 void ASTOpenPulseWaveformNode::print() const {
   std::cout << "<OpenPulseWaveform>" << std::endl;
   ASTExpressionNode::GetIdentifier()->print();
@@ -76,7 +167,19 @@ void ASTOpenPulseWaveformNode::print() const {
     std::cout << "</Phase>" << std::endl;
   }
 
-  CXV.print();
+  if (SMP.empty()) {
+    CXV.print();
+  } else {
+    std::cout << "<SampleBuffer>" << std::endl;
+    std::cout << "<Size>" << std::dec << SMP.size() << "</Size>" << std::endl;
+    for (const std::complex<double> &C : SMP) {
+      std::stringstream SS;
+      SS << std::setprecision(17) << "<Sample><Real>" << C.real()
+         << "</Real><Imag>" << C.imag() << "</Imag></Sample>";
+      std::cout << SS.str() << std::endl;
+    }
+    std::cout << "</SampleBuffer>" << std::endl;
+  }
 
   if (FC) {
     std::cout << "<FunctionCall>" << std::endl;
@@ -104,7 +207,14 @@ void ASTOpenPulseWaveformNode::Mangle() {
 
   switch (TE) {
   case 0U:
-    M.StringValue(ASTStringUtils::Instance().SanitizeMangled(CXV.Mangle()));
+    if (SMP.empty()) {
+      M.StringValue(ASTStringUtils::Instance().SanitizeMangled(CXV.Mangle()));
+    } else {
+      for (const std::complex<double> &C : SMP) {
+        M.NumericLiteral(C.real());
+        M.NumericLiteral(C.imag());
+      }
+    }
     break;
   case 1U:
     const_cast<ASTMPComplexNode *>(AMP)->Mangle();
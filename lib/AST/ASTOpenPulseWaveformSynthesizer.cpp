@@ -0,0 +1,467 @@
+/* -*- coding: utf-8 -*-
+ *
+ * Copyright 2023 IBM RESEARCH. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#include <qasm/AST/ASTConstantFolder.h>
+#include <qasm/AST/ASTDuration.h>
+#include <qasm/AST/ASTFunctionCallExpr.h>
+#include <qasm/AST/ASTKernel.h>
+#include <qasm/AST/OpenPulse/ASTOpenPulseWaveform.h>
+#include <qasm/AST/OpenPulse/ASTOpenPulseWaveformSynthesizer.h>
+#include <qasm/Diagnostic/DIAGLineCounter.h>
+#include <qasm/Frontend/QasmDiagnosticEmitter.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <sstream>
+
+namespace QASM {
+namespace OpenPulse {
+
+using DiagLevel = QASM::QasmDiagnosticEmitter::DiagLevel;
+
+ASTOpenPulseWaveformSynthesizer ASTOpenPulseWaveformSynthesizer::WFS;
+bool ASTOpenPulseWaveformSynthesizer::SE = false;
+
+static const double TwoPi = 6.283185307179586476925286766559;
+
+// Emits a diagnostic at X, and returns false, if a waveform of Duration
+// samples is too long to synthesize.
+static bool WithinSampleLimit(double Duration, const ASTBase *X,
+                              DiagLevel DL) {
+  if (Duration <= static_cast<double>(
+                      ASTOpenPulseWaveformSynthesizer::MaxSamples))
+    return true;
+
+  std::stringstream M;
+  M << "Waveform duration of " << Duration << " samples exceeds the "
+    << "synthesis limit of " << ASTOpenPulseWaveformSynthesizer::MaxSamples
+    << " samples.";
+  QasmDiagnosticEmitter::Instance().EmitDiagnostic(
+      DIAGLineCounter::Instance().GetLocation(X), M.str(), DL);
+  return false;
+}
+
+ASTOpenPulseWaveformSynthesizer::Shape
+ASTOpenPulseWaveformSynthesizer::ShapeFromName(const std::string &Name) {
+  if (Name == u8"constant")
+    return ShapeConstant;
+  else if (Name == u8"gaussian")
+    return ShapeGaussian;
+  else if (Name == u8"gaussian_square")
+    return ShapeGaussianSquare;
+  else if (Name == u8"drag")
+    return ShapeDrag;
+  else if (Name == u8"sech")
+    return ShapeSech;
+  else if (Name == u8"sine")
+    return ShapeSine;
+
+  return ShapeUnknown;
+}
+
+const char *ASTOpenPulseWaveformSynthesizer::PrintShape(Shape S) {
+  switch (S) {
+  case ShapeConstant:
+    return "constant";
+  case ShapeGaussian:
+    return "gaussian";
+  case ShapeGaussianSquare:
+    return "gaussian_square";
+  case ShapeDrag:
+    return "drag";
+  case ShapeSech:
+    return "sech";
+  case ShapeSine:
+    return "sine";
+  default:
+    break;
+  }
+
+  return "unknown";
+}
+
+// Out[K] = exp(-(T0 + K)^2 / (2 * Sigma^2)).
+void ASTOpenPulseWaveformSynthesizer::GaussianEnvelope(double *Out,
+                                                       std::size_t N,
+                                                       double T0,
+                                                       double Sigma) {
+  const double A = 1.0 / (2.0 * Sigma * Sigma);
+
+  for (std::size_t K = 0; K < N; ++K) {
+    const double X = T0 + static_cast<double>(K);
+    Out[K] = std::exp(-X * X * A);
+  }
+}
+
+// Out[K] = sech((T0 + K) / Sigma).
+void ASTOpenPulseWaveformSynthesizer::SechEnvelope(double *Out, std::size_t N,
+                                                   double T0, double Sigma) {
+  const double IS = 1.0 / Sigma;
+
+  for (std::size_t K = 0; K < N; ++K)
+    Out[K] = 1.0 / std::cosh((T0 + static_cast<double>(K)) * IS);
+}
+
+// Out[K] = sin(2 * pi * Frequency * K + Phase).
+void ASTOpenPulseWaveformSynthesizer::SineEnvelope(double *Out, std::size_t N,
+                                                   double Frequency,
+                                                   double Phase) {
+  const double W = TwoPi * Frequency;
+
+  for (std::size_t K = 0; K < N; ++K)
+    Out[K] = std::sin(W * static_cast<double>(K) + Phase);
+}
+
+bool ASTOpenPulseWaveformSynthesizer::Generate(const Parameters &P,
+                                               buffer_type &Out) {
+  if (!std::isfinite(P.Duration) || P.Duration < 0.0 ||
+      P.Duration > static_cast<double>(MaxSamples) ||
+      !std::isfinite(P.Amp.real()) || !std::isfinite(P.Amp.imag()))
+    return false;
+
+  const std::size_t N = static_cast<std::size_t>(std::llround(P.Duration));
+  const bool NeedsSigma = P.S == ShapeGaussian || P.S == ShapeGaussianSquare ||
+                          P.S == ShapeDrag || P.S == ShapeSech;
+
+  if (NeedsSigma && !(P.Sigma > 0.0 && std::isfinite(P.Sigma)))
+    return false;
+
+  std::vector<double> Env(N);
+  double *EP = Env.data();
+  const double C = P.Duration / 2.0;
+
+  switch (P.S) {
+  case ShapeConstant:
+    std::fill(Env.begin(), Env.end(), 1.0);
+    break;
+  case ShapeGaussian:
+  case ShapeDrag:
+    GaussianEnvelope(EP, N, -C, P.Sigma);
+    break;
+  case ShapeGaussianSquare: {
+    if (!(P.Width >= 0.0 && P.Width <= P.Duration))
+      return false;
+
+    const double T1 = (P.Duration - P.Width) / 2.0;
+    const double T2 = T1 + P.Width;
+    const std::size_t K1 =
+        std::min(N, static_cast<std::size_t>(std::ceil(T1)));
+    const std::size_t K2 =
+        std::max(K1, std::min(N, static_cast<std::size_t>(std::floor(T2)) + 1));
+
+    GaussianEnvelope(EP, K1, -T1, P.Sigma);
+    std::fill(EP + K1, EP + K2, 1.0);
+    GaussianEnvelope(EP + K2, N - K2, static_cast<double>(K2) - T2, P.Sigma);
+  } break;
+  case ShapeSech:
+    SechEnvelope(EP, N, -C, P.Sigma);
+    break;
+  case ShapeSine:
+    if (!std::isfinite(P.Frequency) || !std::isfinite(P.Phase))
+      return false;
+    SineEnvelope(EP, N, P.Frequency, P.Phase);
+    break;
+  default:
+    return false;
+  }
+
+  Out.resize(N);
+  const double AR = P.Amp.real();
+  const double AI = P.Amp.imag();
+
+  if (P.S == ShapeDrag) {
+    // DRAG adds the scaled derivative of the gaussian as the quadrature
+    // component: amp * g(t) * (1 - i * beta * (t - d/2) / sigma^2).
+    const double BS = P.Beta / (P.Sigma * P.Sigma);
+    for (std::size_t K = 0; K < N; ++K) {
+      const double DI = -BS * (static_cast<double>(K) - C);
+      Out[K] = sample_type(EP[K] * (AR - AI * DI), EP[K] * (AI + AR * DI));
+    }
+  } else {
+    for (std::size_t K = 0; K < N; ++K)
+      Out[K] = sample_type(AR * EP[K], AI * EP[K]);
+  }
+
+  return true;
+}
+
+const ASTOpenPulseWaveformSynthesizer::buffer_type *
+ASTOpenPulseWaveformSynthesizer::Synthesize(const Parameters &P) {
+  cache_map::const_iterator I = Cache.find(P);
+  if (I != Cache.end()) {
+    ++Hits;
+    return &(*I).second;
+  }
+
+  buffer_type B;
+  if (!Generate(P, B))
+    return nullptr;
+
+  ++Misses;
+  const std::size_t SZ = B.size() * sizeof(sample_type);
+
+  if (SZ > MaxCacheBytes) {
+    Uncached.swap(B);
+    return &Uncached;
+  }
+
+  if (Bytes + SZ > MaxCacheBytes) {
+    Cache.clear();
+    Bytes = 0;
+  }
+
+  Bytes += SZ;
+  return &(*Cache.emplace(P, std::move(B)).first).second;
+}
+
+bool ASTOpenPulseWaveformSynthesizer::DurationInSamples(
+    const ASTDurationNode *D, double &Samples) {
+  if (!D || D->GetDuration() == static_cast<uint64_t>(~0x0))
+    return false;
+
+  if (D->GetLengthUnit() == QASM::DT) {
+    Samples = static_cast<double>(D->GetDuration());
+    return true;
+  }
+
+  // One dt is P ticks.
+  const ASTDurationTimeBase &TB = ASTDurationTimeBase::Instance();
+  int64_t T;
+
+  if (!TB.HasDT() || !D->GetTicks(T))
+    return false;
+
+  Samples = static_cast<double>(T) /
+            static_cast<double>(TB.GetDTNumerator());
+  return true;
+}
+
+bool ASTOpenPulseWaveformSynthesizer::SamplePeriod(double &SP) {
+  const ASTDurationTimeBase &TB = ASTDurationTimeBase::Instance();
+  if (!TB.HasDT())
+    return false;
+
+  SP = static_cast<double>(TB.GetDTNumerator()) /
+       static_cast<double>(TB.GetDTDenominator()) * 1.0e-9;
+  return true;
+}
+
+bool ASTOpenPulseWaveformSynthesizer::RealArgument(const ASTBase *X,
+                                                   double &V) {
+  const ASTExpressionNode *EN = dynamic_cast<const ASTExpressionNode *>(X);
+  ASTConstantValue CV;
+
+  if (!EN || !ASTConstantFolder::Instance().Evaluate(EN, CV))
+    return false;
+
+  V = CV.AsDouble();
+  return std::isfinite(V);
+}
+
+bool ASTOpenPulseWaveformSynthesizer::ComplexArgument(const ASTBase *X,
+                                                      sample_type &V) {
+  if (const ASTMPComplexNode *MPC = dynamic_cast<const ASTMPComplexNode *>(X)) {
+    if (MPC->IsError() || MPC->NeedsEval() || MPC->IsNan() ||
+        MPC->GetFunctionCall())
+      return false;
+
+    const mpc_t &MV = MPC->GetMPValue();
+    V = sample_type(mpfr_get_d(mpc_realref(MV), MPFR_RNDN),
+                    mpfr_get_d(mpc_imagref(MV), MPFR_RNDN));
+    return true;
+  }
+
+  double R;
+  if (!RealArgument(X, R))
+    return false;
+
+  V = sample_type(R, 0.0);
+  return true;
+}
+
+bool ASTOpenPulseWaveformSynthesizer::GetParameters(
+    const ASTOpenPulseWaveformNode *WF, Shape S, Parameters &P) const {
+  assert(WF && "Invalid ASTOpenPulseWaveformNode argument!");
+
+  std::stringstream M;
+  P = Parameters();
+  P.S = S;
+  double SP = 0.0;
+
+  if (S == ShapeUnknown) {
+    M << "Unknown waveform shape.";
+  } else if (!WF->GetAmplitude() || WF->GetAmplitude()->IsNan()) {
+    M << "Waveform has no constant amplitude.";
+  } else if (!DurationInSamples(WF->GetDuration(), P.Duration)) {
+    M << "Waveform duration cannot be converted to samples.";
+  } else if ((S == ShapeGaussian || S == ShapeGaussianSquare ||
+              S == ShapeDrag || S == ShapeSech) &&
+             !DurationInSamples(WF->GetSigma(), P.Sigma)) {
+    M << "Waveform sigma cannot be converted to samples.";
+  } else if (S == ShapeGaussianSquare &&
+             !DurationInSamples(WF->GetSquareWidth(), P.Width)) {
+    M << "Waveform square width cannot be converted to samples.";
+  } else if (S == ShapeDrag && !WF->GetBeta()) {
+    M << "DRAG waveform has no beta.";
+  } else if (S == ShapeSine && (!WF->GetFrequency() || !WF->GetPhase())) {
+    M << "Sine waveform has no frequency or phase.";
+  } else if (S == ShapeSine && !SamplePeriod(SP)) {
+    M << "Sine waveform synthesis requires a dt.";
+  }
+
+  if (!M.str().empty()) {
+    QasmDiagnosticEmitter::Instance().EmitDiagnostic(
+        DIAGLineCounter::Instance().GetLocation(WF), M.str(),
+        DiagLevel::Error);
+    return false;
+  }
+
+  const mpc_t &AMP = WF->GetAmplitude()->GetMPValue();
+  P.Amp = sample_type(mpfr_get_d(mpc_realref(AMP), MPFR_RNDN),
+                      mpfr_get_d(mpc_imagref(AMP), MPFR_RNDN));
+
+  if (S == ShapeDrag)
+    P.Beta = WF->GetBeta()->ToDouble();
+
+  if (S == ShapeSine) {
+    P.Frequency = WF->GetFrequency()->ToDouble() * SP;
+    P.Phase = WF->GetPhase()->AsDouble();
+  }
+
+  return true;
+}
+
+bool ASTOpenPulseWaveformSynthesizer::Synthesize(
+    const ASTOpenPulseWaveformNode *WF, Shape S, buffer_type &Out) {
+  Parameters P;
+  if (!GetParameters(WF, S, P) ||
+      !WithinSampleLimit(P.Duration, WF, DiagLevel::Error))
+    return false;
+
+  const buffer_type *B = Synthesize(P);
+  if (!B) {
+    std::stringstream M;
+    M << "Invalid parameters for " << PrintShape(S) << " waveform.";
+    QasmDiagnosticEmitter::Instance().EmitDiagnostic(
+        DIAGLineCounter::Instance().GetLocation(WF), M.str(),
+        DiagLevel::Error);
+    return false;
+  }
+
+  Out = *B;
+  return true;
+}
+
+bool ASTOpenPulseWaveformSynthesizer::GetParameters(
+    const ASTFunctionCallNode *FC, Parameters &P) const {
+  assert(FC && "Invalid ASTFunctionCallNode argument!");
+
+  const ASTKernelNode *KN = FC->GetKernelDefinition();
+  if (!KN || !KN->IsExtern())
+    return false;
+
+  P = Parameters();
+  P.S = ShapeFromName(KN->GetName());
+
+  // The arguments of the OpenPulse waveform functions, after amp and d.
+  std::size_t NA = 0;
+  switch (P.S) {
+  case ShapeConstant:
+    NA = 2;
+    break;
+  case ShapeGaussian:
+  case ShapeSech:
+    NA = 3;
+    break;
+  case ShapeGaussianSquare:
+  case ShapeDrag:
+  case ShapeSine:
+    NA = 4;
+    break;
+  default:
+    return false;
+  }
+
+  const ASTExpressionList &EL = FC->GetExpressionList();
+  if (EL.Size() != NA || !FC->GetQuantumIdentifierList().Empty())
+    return false;
+
+  std::vector<const ASTBase *> A(EL.begin(), EL.end());
+
+  if (!ComplexArgument(A[0], P.Amp) ||
+      !DurationInSamples(dynamic_cast<const ASTDurationNode *>(A[1]),
+                         P.Duration))
+    return false;
+
+  switch (P.S) {
+  case ShapeGaussian:
+  case ShapeSech:
+    return DurationInSamples(dynamic_cast<const ASTDurationNode *>(A[2]),
+                             P.Sigma);
+    break;
+  case ShapeGaussianSquare:
+    return DurationInSamples(dynamic_cast<const ASTDurationNode *>(A[2]),
+                             P.Width) &&
+           DurationInSamples(dynamic_cast<const ASTDurationNode *>(A[3]),
+                             P.Sigma);
+    break;
+  case ShapeDrag:
+    return DurationInSamples(dynamic_cast<const ASTDurationNode *>(A[2]),
+                             P.Sigma) &&
+           RealArgument(A[3], P.Beta);
+    break;
+  case ShapeSine: {
+    double SP;
+    if (!SamplePeriod(SP) || !RealArgument(A[2], P.Frequency) ||
+        !RealArgument(A[3], P.Phase))
+      return false;
+
+    P.Frequency *= SP;
+  } break;
+  default:
+    break;
+  }
+
+  return true;
+}
+
+bool ASTOpenPulseWaveformSynthesizer::Synthesize(const ASTFunctionCallNode *FC,
+                                                 buffer_type &Out) {
+  Parameters P;
+  if (!SE || !GetParameters(FC, P) ||
+      !WithinSampleLimit(P.Duration, FC, DiagLevel::Warning))
+    return false;
+
+  const buffer_type *B = Synthesize(P);
+  if (!B) {
+    std::stringstream M;
+    M << "Invalid parameters for " << PrintShape(P.S) << " waveform, "
+      << "its samples were not synthesized.";
+    QasmDiagnosticEmitter::Instance().EmitDiagnostic(
+        DIAGLineCounter::Instance().GetLocation(FC), M.str(),
+        DiagLevel::Warning);
+    return false;
+  }
+
+  Out = *B;
+  return true;
+}
+
+} // namespace OpenPulse
+} // namespace QASM
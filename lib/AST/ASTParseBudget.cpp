@@ -0,0 +1,69 @@
+/* -*- coding: utf-8 -*-
+ *
+ * Copyright 2023 IBM RESEARCH. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#include <qasm/AST/ASTParseBudget.h>
+
+#include <sstream>
+
+namespace QASM {
+
+ASTParseBudget ASTParseBudget::PB;
+
+void ASTParseBudget::Start() {
+  NumNodes = 0UL;
+  NumSymbols = 0UL;
+  NumBytes = 0UL;
+  Ticks = 0U;
+  Overrun = false;
+  Deadline = Now() + Timeout;
+  Running = true;
+}
+
+void ASTParseBudget::CheckDeadline() {
+  if (Now() >= Deadline)
+    Exceed(ASTParseBudgetExceeded::Time);
+}
+
+void ASTParseBudget::Exceed(ASTParseBudgetExceeded::Limit L) {
+  // Allocations made while the parse unwinds are not recorded.
+  Running = false;
+
+  std::stringstream M;
+  M << "Parse budget exceeded: ";
+
+  switch (L) {
+  case ASTParseBudgetExceeded::Time:
+    M << "the parse took more than " << Timeout.count() << " ms.";
+    break;
+  case ASTParseBudgetExceeded::Nodes:
+    M << "the AST has more than " << MaxNodes << " nodes.";
+    break;
+  case ASTParseBudgetExceeded::Symbols:
+    M << "the symbol table has more than " << MaxSymbols << " entries.";
+    break;
+  case ASTParseBudgetExceeded::Bytes:
+    M << "the AST nodes take more than " << MaxBytes << " bytes.";
+    break;
+  default:
+    break;
+  }
+
+  throw ASTParseBudgetExceeded(L, M.str());
+}
+
+} // namespace QASM
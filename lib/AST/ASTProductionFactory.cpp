@@ -28,6 +28,7 @@
 #include <qasm/AST/ASTCBitNodeMap.h>
 #include <qasm/AST/ASTDeclarationBuilder.h>
 #include <qasm/AST/ASTDefcalBuilder.h>
+#include <qasm/AST/ASTDefcalDispatchIndex.h>
 #include <qasm/AST/ASTDirectiveStatementNode.h>
 #include <qasm/AST/ASTDoWhileStatementBuilder.h>
 #include <qasm/AST/ASTExpressionBuilder.h>
@@ -44,6 +45,7 @@
 #include <qasm/AST/ASTIfConditionalsGraphController.h>
 #include <qasm/AST/ASTIfStatementTracker.h>
 #include <qasm/AST/ASTKernelBuilder.h>
+#include <qasm/AST/ASTLiteralPool.h>
 #include <qasm/AST/ASTLoops.h>
 #include <qasm/AST/ASTMangler.h>
 #include <qasm/AST/ASTObjectTracker.h>
@@ -63,6 +65,7 @@
 #include <qasm/AST/ASTWhileStatementBuilder.h>
 #include <qasm/AST/OpenPulse/ASTOpenPulseCalibration.h>
 #include <qasm/AST/OpenPulse/ASTOpenPulseController.h>
+#include <qasm/AST/OpenPulse/ASTOpenPulseWaveformSynthesizer.h>
 #include <qasm/Frontend/QasmDiagnosticEmitter.h>
 #include <qasm/Frontend/QasmFeatureTester.h>
 
@@ -175,10 +178,9 @@ ASTProductionFactory::ProductionRule_1001(const ASTToken *TK,
   }
 
   unsigned Bits = Id->GetBits();
-  if (ASTStringUtils::Instance().IsIndexed(Id->GetName())) {
-    Bits = ASTStringUtils::Instance().GetIdentifierIndex(Id->GetName());
-    std::string BID =
-        ASTStringUtils::Instance().GetIdentifierBase(Id->GetName());
+  if (Id->HasIndexedName()) {
+    Bits = Id->GetNameIndex();
+    std::string BID = Id->GetBaseName();
     ASTSymbolTable::Instance().Erase(Id, Id->GetSymbolType());
     ASTSymbolTable::Instance().Erase(BID, Bits, Id->GetSymbolType());
     Id = ASTBuilder::Instance().CreateASTIdentifierNode(BID, Bits,
@@ -239,10 +241,9 @@ ASTProductionFactory::ProductionRule_1002(const ASTToken *TK,
   unsigned BM = ASTUtils::Instance().GetUnsignedValue(I);
   unsigned Bits = Id->GetBits();
 
-  if (ASTStringUtils::Instance().IsIndexed(Id->GetName())) {
-    Bits = ASTStringUtils::Instance().GetIdentifierIndex(Id->GetName());
-    std::string BID =
-        ASTStringUtils::Instance().GetIdentifierBase(Id->GetName());
+  if (Id->HasIndexedName()) {
+    Bits = Id->GetNameIndex();
+    std::string BID = Id->GetBaseName();
     ASTSymbolTable::Instance().Erase(Id, Id->GetSymbolType());
     ASTSymbolTable::Instance().Erase(BID, Bits, Id->GetSymbolType());
     Id = ASTBuilder::Instance().CreateASTIdentifierNode(BID, Bits,
@@ -1020,10 +1021,9 @@ ASTProductionFactory::ProductionRule_107(const ASTToken *TK,
   unsigned Bits = 1U;
   Id->SetBits(Bits);
 
-  if (ASTStringUtils::Instance().IsIndexed(Id->GetName())) {
-    Bits = ASTStringUtils::Instance().GetIdentifierIndex(Id->GetName());
-    std::string BID =
-        ASTStringUtils::Instance().GetIdentifierBase(Id->GetName());
+  if (Id->HasIndexedName()) {
+    Bits = Id->GetNameIndex();
+    std::string BID = Id->GetBaseName();
     ASTSymbolTable::Instance().Erase(Id, Id->GetSymbolType());
     ASTSymbolTable::Instance().Erase(BID, Bits, Id->GetSymbolType());
     Id = ASTBuilder::Instance().CreateASTIdentifierNode(BID, Bits,
@@ -1086,10 +1086,9 @@ ASTProductionFactory::ProductionRule_108(const ASTToken *TK,
       ASTDeclarationContextTracker::Instance().GetCurrentContext();
   assert(CTX && "Could not obtain a valid ASTDeclarationContext!");
 
-  if (ASTStringUtils::Instance().IsIndexed(Id->GetName())) {
-    Bits = ASTStringUtils::Instance().GetIdentifierIndex(Id->GetName());
-    std::string BID =
-        ASTStringUtils::Instance().GetIdentifierBase(Id->GetName());
+  if (Id->HasIndexedName()) {
+    Bits = Id->GetNameIndex();
+    std::string BID = Id->GetBaseName();
     ASTSymbolTable::Instance().Erase(Id, Id->GetSymbolType());
     ASTSymbolTable::Instance().Erase(BID, Bits, Id->GetSymbolType());
     Id = ASTBuilder::Instance().CreateASTIdentifierNode(BID, Bits,
@@ -1159,10 +1158,9 @@ ASTProductionFactory::ProductionRule_109(const ASTToken *TK,
   unsigned Bits = 1U;
   Id->SetBits(Bits);
 
-  if (ASTStringUtils::Instance().IsIndexed(Id->GetName())) {
-    Bits = ASTStringUtils::Instance().GetIdentifierIndex(Id->GetName());
-    std::string BID =
-        ASTStringUtils::Instance().GetIdentifierBase(Id->GetName());
+  if (Id->HasIndexedName()) {
+    Bits = Id->GetNameIndex();
+    std::string BID = Id->GetBaseName();
     ASTSymbolTable::Instance().Erase(Id, Id->GetSymbolType());
     ASTSymbolTable::Instance().Erase(BID, Bits, Id->GetSymbolType());
     Id = ASTBuilder::Instance().CreateASTIdentifierNode(BID, Bits,
@@ -1225,10 +1223,9 @@ ASTProductionFactory::ProductionRule_110(const ASTToken *TK,
   unsigned Bits = 1U;
   Id->SetBits(Bits);
 
-  if (ASTStringUtils::Instance().IsIndexed(Id->GetName())) {
-    Bits = ASTStringUtils::Instance().GetIdentifierIndex(Id->GetName());
-    std::string BID =
-        ASTStringUtils::Instance().GetIdentifierBase(Id->GetName());
+  if (Id->HasIndexedName()) {
+    Bits = Id->GetNameIndex();
+    std::string BID = Id->GetBaseName();
     ASTSymbolTable::Instance().Erase(Id, Id->GetSymbolType());
     ASTSymbolTable::Instance().Erase(BID, Bits, Id->GetSymbolType());
     Id = ASTBuilder::Instance().CreateASTIdentifierNode(BID, Bits,
@@ -1471,10 +1468,9 @@ ASTProductionFactory::ProductionRule_111(const ASTToken *TK,
   unsigned Bits = 1U;
   Id->SetBits(Bits);
 
-  if (ASTStringUtils::Instance().IsIndexed(Id->GetName())) {
-    Bits = ASTStringUtils::Instance().GetIdentifierIndex(Id->GetName());
-    std::string BID =
-        ASTStringUtils::Instance().GetIdentifierBase(Id->GetName());
+  if (Id->HasIndexedName()) {
+    Bits = Id->GetNameIndex();
+    std::string BID = Id->GetBaseName();
     ASTSymbolTable::Instance().Erase(Id, Id->GetSymbolType());
     ASTSymbolTable::Instance().Erase(BID, Bits, Id->GetSymbolType());
     Id = ASTBuilder::Instance().CreateASTIdentifierNode(BID, Bits,
@@ -1534,10 +1530,9 @@ ASTDeclarationNode *ASTProductionFactory::ProductionRule_112(
   unsigned Bits = 1U;
   Id->SetBits(Bits);
 
-  if (ASTStringUtils::Instance().IsIndexed(Id->GetName())) {
-    Bits = ASTStringUtils::Instance().GetIdentifierIndex(Id->GetName());
-    std::string BID =
-        ASTStringUtils::Instance().GetIdentifierBase(Id->GetName());
+  if (Id->HasIndexedName()) {
+    Bits = Id->GetNameIndex();
+    std::string BID = Id->GetBaseName();
     ASTSymbolTable::Instance().Erase(Id, Id->GetSymbolType());
     ASTSymbolTable::Instance().Erase(BID, Bits, Id->GetSymbolType());
     Id = ASTBuilder::Instance().CreateASTIdentifierNode(BID, Bits,
@@ -5442,6 +5437,10 @@ ASTProductionFactory::ProductionRule_800(const ASTToken *TK,
       ASTDeclarationContextTracker::Instance().GetCurrentContext();
   assert(CTX && "Could not obtain a valid ASTDeclarationContext!");
 
+  if (ASTIntNode *PI = ASTLiteralPool::Instance().Find<ASTIntNode>(
+          ASTTypeInt, ASTIntNode::IntBits, CTX, S))
+    return PI;
+
   ASTIdentifierNode *Id = nullptr;
 
   bool N = S[0] == u8'-';
@@ -5862,6 +5861,8 @@ ASTProductionFactory::ProductionRule_800(const ASTToken *TK,
     }
   }
 
+  ASTLiteralPool::Instance().Insert(ASTTypeInt, ASTIntNode::IntBits, CTX, S,
+                                    RI);
   return RI;
 }
 
@@ -5871,6 +5872,14 @@ ASTProductionFactory::ProductionRule_801(const ASTToken *TK,
   assert(TK && "Invalid ASTToken argument!");
   assert(!RS.empty() && "Invalid std::string argument!");
 
+  const ASTDeclarationContext *CTX =
+      ASTDeclarationContextTracker::Instance().GetCurrentContext();
+  assert(CTX && "Could not obtain a valid ASTDeclarationContext!");
+
+  if (ASTDoubleNode *PD = ASTLiteralPool::Instance().Find<ASTDoubleNode>(
+          ASTTypeDouble, ASTDoubleNode::DoubleBits, CTX, RS))
+    return PD;
+
   ASTDoubleNode *RD = nullptr;
   ASTSymbolTableEntry *STE = nullptr;
 
@@ -5884,10 +5893,6 @@ ASTProductionFactory::ProductionRule_801(const ASTToken *TK,
   Id->SetPolymorphicName(IS.str());
   ASTCVRQualifiers CVR(ASTTypeConst);
 
-  const ASTDeclarationContext *CTX =
-      ASTDeclarationContextTracker::Instance().GetCurrentContext();
-  assert(CTX && "Could not obtain a valid ASTDeclarationContext!");
-
   try {
     double D = std::stod(RS);
     RD = new ASTDoubleNode(Id, D, CVR);
@@ -6011,6 +6016,8 @@ ASTProductionFactory::ProductionRule_801(const ASTToken *TK,
   }
 
   Id->SetExpression(RD);
+  ASTLiteralPool::Instance().Insert(ASTTypeDouble, ASTDoubleNode::DoubleBits,
+                                    CTX, RS, RD);
   return RD;
 }
 
@@ -6410,7 +6417,10 @@ ASTProductionFactory::ProductionRule_813(const ASTToken *TK) const {
     return ASTBoolNode::ExpressionError(M.str());
   }
 
-  ASTBoolNode *BN;
+  ASTBoolNode *BN = ASTLiteralPool::Instance().Find<ASTBoolNode>(
+      ASTTypeBool, 1U, nullptr, TK->GetString());
+  if (BN)
+    return BN;
 
   if (TK->GetString() == "true")
     BN = new ASTBoolNode(true);
@@ -6420,6 +6430,8 @@ ASTProductionFactory::ProductionRule_813(const ASTToken *TK) const {
 
   BN->SetLocation(TK->GetLocation());
   BN->Mangle();
+  ASTLiteralPool::Instance().Insert(ASTTypeBool, 1U, nullptr, TK->GetString(),
+                                    BN);
   return BN;
 }
 
@@ -19008,6 +19020,8 @@ ASTProductionFactory::ProductionRule_1720(const ASTToken *TK,
   assert(WFN && "Could not create a valid OpenPulse ASTOpenPulseWaveformNode!");
 
   WFN->SetLocation(TK->GetLocation());
+  // The sample list was built for this waveform only.
+  WFN->PackSamples();
   WFN->SetDeclarationContext(CTX);
   WFN->Mangle();
   return WFN;
@@ -19060,6 +19074,17 @@ OpenPulse::ASTOpenPulseWaveformNode *ASTProductionFactory::ProductionRule_1721(
         Id, RWFN->GetSamples());
     assert(WFN &&
            "Could not create a valid OpenPulse ASTOpenPulseWaveformNode!");
+    WFN->SetSampleBuffer(RWFN->GetSampleBuffer());
+
+    // With -synthesize-waveforms, parametric waveforms from the OpenPulse
+    // extern waveform functions are synthesized when all of their
+    // arguments are constants.
+    if (WFN->GetSamples().Empty() && WFN->GetSampleBuffer().empty()) {
+      OpenPulse::ASTOpenPulseWaveformSynthesizer::buffer_type B;
+      if (OpenPulse::ASTOpenPulseWaveformSynthesizer::Instance().Synthesize(
+              EN, B))
+        WFN->SetSampleBuffer(B);
+    }
   } break;
   case ASTTypeMPComplex: {
     ASTMPComplexList CXL;
@@ -22027,8 +22052,7 @@ ASTProductionFactory::ProductionRule_1480(const ASTToken *TK,
     TTId = dynamic_cast<const ASTIdentifierRefNode *>(TId);
     assert(TTId && "Could not dynamic_cast to an ASTIdentifierRefNode!");
 
-    std::string QN =
-        ASTStringUtils::Instance().GetIdentifierBase(TTId->GetName());
+    std::string QN = TTId->GetBaseName();
     assert(!QN.empty() &&
            "Could not obtain a valid base ASTIdentifierNode Name!");
 
@@ -22705,8 +22729,7 @@ ASTProductionFactory::ProductionRule_1464(const ASTToken *TK,
         ASTStringUtils::Instance().GetBaseQubitName(TId->GetName());
     TSTE = ASTSymbolTable::Instance().FindQubit(QN);
   } else if (TIdR) {
-    std::string QN =
-        ASTStringUtils::Instance().GetIdentifierBase(TIdR->GetName());
+    std::string QN = TIdR->GetBaseName();
     TSTE = ASTSymbolTable::Instance().FindQubit(QN);
   } else {
     TSTE = ASTSymbolTable::Instance().FindQubit(TId->GetName());
@@ -29347,20 +29370,28 @@ static ASTGateQOpNode *CreateDefcalGroupCall(const ASTToken *TK,
                                              const ASTIdentifierNode *Id,
                                              const ASTArgumentNodeList &ANL,
                                              const ASTAnyTypeList &ATL) {
-  std::vector<const ASTSymbolTableEntry *> DGV =
-      ASTSymbolTable::Instance().GetDefcalGroup(Id->GetName());
-  if (DGV.empty()) {
-    std::stringstream M;
-    M << "Defcal Group " << Id->GetName()
-      << " contains no "
-         "callable Defcals.";
-    QasmDiagnosticEmitter::Instance().EmitDiagnostic(
-        DIAGLineCounter::Instance().GetLocation(Id), M.str(), DiagLevel::Error);
-    return nullptr;
+  // Defcal Overload Resolution: pick the most specific defcal for the
+  // physical qubits and the number of arguments at the call site.
+  const ASTSymbolTableEntry *DSTE =
+      ASTDefcalDispatchIndex::Instance().Resolve(Id->GetName(), ANL, ATL);
+
+  if (!DSTE) {
+    std::vector<const ASTSymbolTableEntry *> DGV =
+        ASTSymbolTable::Instance().GetDefcalGroup(Id->GetName());
+    if (DGV.empty()) {
+      std::stringstream M;
+      M << "Defcal Group " << Id->GetName()
+        << " contains no "
+           "callable Defcals.";
+      QasmDiagnosticEmitter::Instance().EmitDiagnostic(
+          DIAGLineCounter::Instance().GetLocation(Id), M.str(),
+          DiagLevel::Error);
+      return nullptr;
+    }
+
+    DSTE = DGV.back();
   }
 
-  // FIXME: This needs Defcal Overload Resolution.
-  const ASTSymbolTableEntry *DSTE = DGV.back();
   if (!DSTE) {
     std::stringstream M;
     M << "Invalid Defcal SymbolTable Entry obtained from Defcal Group.";
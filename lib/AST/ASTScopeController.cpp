@@ -762,7 +762,7 @@ void ASTScopeController::CheckDeclaration(const ASTIdentifierNode *Id) const {
     if (ASTDeclarationContextTracker::Instance().IsGlobalContext(ICX)) {
       CheckUndefined(Id);
 
-      if (ASTStringUtils::Instance().IsIndexed(Id->GetName())) {
+      if (Id->HasIndexedName()) {
         ASTType ITy = ASTTypeUndefined;
         const ASTSymbolTableEntry *STE = nullptr;
         const ASTIdentifierNode *IId = nullptr;
@@ -777,8 +777,7 @@ void ASTScopeController::CheckDeclaration(const ASTIdentifierNode *Id) const {
           return;
         } break;
         case ASTTypeBitset: {
-          std::string BIS =
-              ASTStringUtils::Instance().GetIdentifierBase(Id->GetName());
+          std::string BIS = Id->GetBaseName();
           STE = ASTSymbolTable::Instance().FindGlobalSymbol(BIS, ASTTypeBitset);
           if (STE) {
             IId = STE->GetIdentifier();
@@ -804,8 +803,7 @@ void ASTScopeController::CheckDeclaration(const ASTIdentifierNode *Id) const {
         case ASTTypeLambdaAngle:
         case ASTTypePhiAngle:
         case ASTTypeThetaAngle: {
-          std::string BIS =
-              ASTStringUtils::Instance().GetIdentifierBase(Id->GetName());
+          std::string BIS = Id->GetBaseName();
           STE = ASTSymbolTable::Instance().FindAngle(BIS);
           if (STE) {
             IId = STE->GetIdentifier();
@@ -908,9 +906,8 @@ void ASTScopeController::CheckDeclaration(const ASTIdentifierNode *Id) const {
           STE->GetIdentifier()->GetBits() == Id->GetBits() &&
           Id->GetBits() > 0U) {
         return;
-      } else if (ASTStringUtils::Instance().IsReservedSuffix(Id->GetName())) {
-        std::string BId =
-            ASTStringUtils::Instance().GetReservedBase(Id->GetName());
+      } else if (Id->HasReservedSuffix()) {
+        std::string BId = Id->GetReservedBase();
         STE = ASTSymbolTable::Instance().FindCalibrationSymbol(
             BId, Id->GetBits(), Id->GetSymbolType());
         if (STE && STE->GetValueType() == Id->GetSymbolType() &&
@@ -950,11 +947,10 @@ void ASTScopeController::CheckDeclaration(const ASTIdentifierNode *Id) const {
       return;
     }
 
-    if (ASTStringUtils::Instance().IsReservedSuffix(Id->GetName())) {
+    if (Id->HasReservedSuffix()) {
       CheckReservedSuffix(Id);
 
-      std::string BId =
-          ASTStringUtils::Instance().GetReservedBase(Id->GetName());
+      std::string BId = Id->GetReservedBase();
       const ASTSymbolTableEntry *STE =
           ASTSymbolTable::Instance().FindLocalSymbol(Id);
 
@@ -1060,10 +1056,10 @@ void ASTScopeController::CheckDeclaration(const ASTIdentifierNode *Id) const {
       ASTTypeSystemBuilder::Instance().IsImplicitAngle(Id->GetName()))
     return;
 
-  if (ASTStringUtils::Instance().IsReservedSuffix(Id->GetName())) {
+  if (Id->HasReservedSuffix()) {
     CheckReservedSuffix(Id);
 
-    std::string BId = ASTStringUtils::Instance().GetReservedBase(Id->GetName());
+    std::string BId = Id->GetReservedBase();
     const ASTSymbolTableEntry *STE =
         ASTSymbolTable::Instance().FindGlobalSymbol(Id);
 
@@ -1087,7 +1083,7 @@ void ASTScopeController::CheckDeclaration(const ASTIdentifierNode *Id) const {
     }
   }
 
-  if (ASTStringUtils::Instance().IsIndexed(Id->GetName())) {
+  if (Id->HasIndexedName()) {
     if (const ASTIdentifierRefNode *IdR =
             dynamic_cast<const ASTIdentifierRefNode *>(Id)) {
       CheckDeclaration(IdR->GetIdentifier());
@@ -16,9 +16,14 @@
  * =============================================================================
  */
 
+#include <qasm/AST/ASTConstantFolder.h>
 #include <qasm/AST/ASTDeclarationBuilder.h>
 #include <qasm/AST/ASTDeclarationContext.h>
+#include <qasm/AST/ASTExpressionEvaluator.h>
+#include <qasm/AST/ASTGateOpBuilder.h>
 #include <qasm/AST/ASTIfConditionals.h>
+#include <qasm/AST/ASTMeasure.h>
+#include <qasm/AST/ASTObjectTracker.h>
 #include <qasm/AST/ASTReturn.h>
 #include <qasm/AST/ASTScopeController.h>
 #include <qasm/AST/ASTStatementBuilder.h>
@@ -32,6 +37,114 @@ using DiagLevel = QASM::QasmDiagnosticEmitter::DiagLevel;
 ASTStatementList ASTStatementBuilder::SL;
 ASTStatementBuilder ASTStatementBuilder::B;
 std::map<uintptr_t, const ASTStatement *> ASTStatementBuilder::SM;
+ASTStatementBuilder::stream_callback ASTStatementBuilder::SCB;
+std::vector<ASTStatementBuilder::Boundary> ASTStatementBuilder::BV;
+uint64_t ASTStatementBuilder::NSE = 0UL;
+bool ASTStatementBuilder::FSN = false;
+
+void ASTStatementBuilder::MarkStream() {
+  NSE = ASTSymbolTableEntry::GetNumAllocated();
+  ASTObjectTracker::Instance().Mark();
+}
+
+bool ASTStatementBuilder::IsTransient(const ASTStatement *SN) {
+  return dynamic_cast<const ASTGateQOpNode *>(SN) &&
+         !dynamic_cast<const ASTMeasureNode *>(SN);
+}
+
+void ASTStatementBuilder::SetStreamCallback(const stream_callback &CB) {
+  SCB = CB;
+  FSN = ASTObjectTracker::Instance().IsEnabled();
+  MarkStream();
+}
+
+void ASTStatementBuilder::ClearStreamCallback() {
+  SCB = nullptr;
+  FSN = false;
+  ASTObjectTracker::Instance().Unmark();
+}
+
+void ASTStatementBuilder::Clear() {
+  SL.List.clear();
+  BV.clear();
+  NSE = ASTSymbolTableEntry::GetNumAllocated();
+}
+
+void ASTStatementBuilder::Flush() {
+  if (!SCB) {
+    std::size_t SB = BV.empty() ? 0UL : BV.back().End;
+    bool T = SB < SL.List.size() &&
+             ASTSymbolTableEntry::GetNumAllocated() == NSE;
+
+    for (std::size_t I = SB; T && I < SL.List.size(); ++I)
+      T = IsTransient(SL.List[I]);
+
+    BV.push_back({SB, SL.List.size(), T});
+    NSE = ASTSymbolTableEntry::GetNumAllocated();
+    return;
+  }
+
+  // A directive is not appended. Its nodes are kept.
+  if (SL.List.empty()) {
+    MarkStream();
+    return;
+  }
+
+  // The pending statements are moved out of the list before the
+  // callback runs, so that the list is empty while it runs.
+  std::vector<ASTStatement *> PV;
+  PV.swap(SL.List);
+
+  bool T = FSN && ASTSymbolTableEntry::GetNumAllocated() == NSE;
+
+  for (std::vector<ASTStatement *>::iterator I = PV.begin(); I != PV.end();
+       ++I) {
+    SM.erase(reinterpret_cast<uintptr_t>(*I));
+    SCB(*I);
+    T = T && IsTransient(*I);
+  }
+
+  if (T) {
+    ASTObjectTracker::Instance().ReleaseMarked();
+
+    // These hold the addresses of the nodes that were just deleted.
+    ASTConstantFolder::Instance().Clear();
+    ASTExpressionEvaluator::Instance().ClearCache();
+    ASTGateOpBuilder::Instance().Clear();
+  }
+
+  MarkStream();
+}
+
+void ASTStatementBuilder::Swap(list_type &V, std::vector<Boundary> &SBV) {
+  SL.List.swap(V);
+  BV.swap(SBV);
+}
+
+void ASTStatementBuilder::Replace(std::size_t K, const list_type &V,
+                                  bool Transient) {
+  assert(K < BV.size() && "Invalid top-level statement index!");
+
+  Boundary &RB = BV[K];
+  for (std::size_t I = RB.Begin; I < RB.End; ++I)
+    SM.erase(reinterpret_cast<uintptr_t>(SL.List[I]));
+
+  SL.List.erase(SL.List.begin() + RB.Begin, SL.List.begin() + RB.End);
+  SL.List.insert(SL.List.begin() + RB.Begin, V.begin(), V.end());
+
+  for (ASTStatement *SN : V)
+    SM.insert(std::make_pair(reinterpret_cast<uintptr_t>(SN), SN));
+
+  std::size_t D = RB.End - RB.Begin;
+  RB.End = RB.Begin + V.size();
+  RB.Transient = Transient;
+
+  for (std::vector<Boundary>::iterator I = BV.begin() + K + 1; I != BV.end();
+       ++I) {
+    (*I).Begin = (*I).Begin + V.size() - D;
+    (*I).End = (*I).End + V.size() - D;
+  }
+}
 
 void ASTStatementList::SetLocalScope() {
   for (ASTStatementList::iterator I = List.begin(); I != List.end(); ++I) {
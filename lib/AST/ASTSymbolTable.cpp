@@ -17,11 +17,14 @@
  */
 
 #include <qasm/AST/ASTBuilder.h>
+#include <qasm/AST/ASTParseBudget.h>
 #include <qasm/AST/ASTSymbolTable.h>
 
 #include <qasm/Diagnostic/DIAGLineCounter.h>
 #include <qasm/Frontend/QasmDiagnosticEmitter.h>
 
+#include <initializer_list>
+
 namespace QASM {
 
 using DiagLevel = QASM::QasmDiagnosticEmitter::DiagLevel;
@@ -50,8 +53,24 @@ std::map<std::string, ASTSymbolTableEntry *> ASTSymbolTable::GLSTM;
 std::map<std::string, ASTSymbolTableEntry *> ASTSymbolTable::LSTM;
 std::map<std::string, ASTSymbolTableEntry *> ASTSymbolTable::USTM;
 
+ASTSymbolTable::BuiltinEnvironment ASTSymbolTable::BE;
+
 ASTSymbolTable ASTSymbolTable::ST;
 
+static uint64_t NumAllocatedEntries = 0UL;
+
+void *ASTSymbolTableEntry::operator new(std::size_t S) {
+  ASTParseBudget::Instance().RecordSymbol();
+  ++NumAllocatedEntries;
+  return ::operator new(S);
+}
+
+uint64_t ASTSymbolTableEntry::GetNumAllocated() {
+  return NumAllocatedEntries;
+}
+
+void ASTSymbolTableEntry::operator delete(void *P) { ::operator delete(P); }
+
 ASTMapSymbolTableEntry *
 ASTSymbolTable::CreateDefcalGroup(const std::string &Id) {
   assert(!Id.empty() && "Invalid defcal group identifier argument!");
@@ -99,24 +118,72 @@ ASTSymbolTable::CreateDefcalGroup(const std::string &Id) {
   return dynamic_cast<ASTMapSymbolTableEntry *>((*DMI).second);
 }
 
+void ASTSymbolTable::SaveBuiltinEnvironment() {
+  BE.STM = STM;
+  BE.ASTM = ASTM;
+  BE.QSTM = QSTM;
+  BE.GSTM = GSTM;
+  BE.SGSTM = SGSTM;
+  BE.HGSTM = HGSTM;
+  BE.GPSTM = GPSTM;
+  BE.DSTM = DSTM;
+  BE.SDSTM = SDSTM;
+  BE.HDSTM = HDSTM;
+  BE.FSTM = FSTM;
+  BE.SFSTM = SFSTM;
+  BE.HFSTM = HFSTM;
+  BE.CSTM = CSTM;
+  BE.GLSTM = GLSTM;
+  BE.LSTM = LSTM;
+  BE.USTM = USTM;
+  BE.E.clear();
+
+  for (multimap_iterator MMI = STM.begin(); MMI != STM.end(); ++MMI)
+    BE.E.insert((*MMI).second);
+
+  for (const map_type *M :
+       {&ASTM, &QSTM, &GSTM, &SGSTM, &GPSTM, &SDSTM, &FSTM, &SFSTM, &CSTM,
+        &GLSTM, &LSTM, &USTM}) {
+    for (map_const_iterator MI = M->begin(); MI != M->end(); ++MI)
+      BE.E.insert((*MI).second);
+  }
+
+  for (const hash_map_type *M : {&HGSTM, &HDSTM, &HFSTM}) {
+    for (hash_map_const_iterator MI = M->begin(); MI != M->end(); ++MI)
+      BE.E.insert((*MI).second);
+  }
+
+  for (map_iterator MI = DSTM.begin(); MI != DSTM.end(); ++MI) {
+    BE.E.insert((*MI).second);
+
+    if (ASTMapSymbolTableEntry *MSTE =
+            dynamic_cast<ASTMapSymbolTableEntry *>((*MI).second)) {
+      std::map<uint64_t, ASTSymbolTableEntry *> &MM = MSTE->GetMap();
+      for (ASTMapSymbolTableEntry::map_iterator MMI = MM.begin();
+           MMI != MM.end(); ++MMI)
+        BE.E.insert((*MMI).second);
+    }
+  }
+}
+
 void ASTSymbolTable::Release() {
   for (map_iterator MI = ASTM.begin(); MI != ASTM.end(); ++MI) {
     if (!ASTStringUtils::Instance().IsIndexed((*MI).first) &&
-        !IsComplexPart((*MI).first)) {
+        !IsComplexPart((*MI).first) && !IsBuiltin((*MI).second)) {
       delete (*MI).second;
     }
   }
 
   for (map_iterator MI = QSTM.begin(); MI != QSTM.end(); ++MI) {
     if (!ASTStringUtils::Instance().IsIndexed((*MI).first) &&
-        !IsComplexPart((*MI).first)) {
+        !IsComplexPart((*MI).first) && !IsBuiltin((*MI).second)) {
       delete (*MI).second;
     }
   }
 
   for (map_iterator MI = GSTM.begin(); MI != GSTM.end(); ++MI) {
     if (!ASTStringUtils::Instance().IsIndexed((*MI).first) &&
-        !IsComplexPart((*MI).first)) {
+        !IsComplexPart((*MI).first) && !IsBuiltin((*MI).second)) {
       delete (*MI).second;
     }
   }
@@ -127,55 +194,96 @@ void ASTSymbolTable::Release() {
 
     for (ASTMapSymbolTableEntry::map_iterator MMI = MM.begin(); MMI != MM.end();
          ++MMI) {
-      if (!ASTStringUtils::Instance().IsIndexed((*MI).first))
+      if (!ASTStringUtils::Instance().IsIndexed((*MI).first) &&
+          !IsBuiltin((*MMI).second))
         delete (*MMI).second;
     }
 
-    if (!IsComplexPart((*MI).first))
+    if (!IsComplexPart((*MI).first) && !IsBuiltin((*MI).second))
       delete (*MI).second;
   }
 
   for (map_iterator MI = FSTM.begin(); MI != FSTM.end(); ++MI) {
     if (!ASTStringUtils::Instance().IsIndexed((*MI).first) &&
-        !IsComplexPart((*MI).first)) {
+        !IsComplexPart((*MI).first) && !IsBuiltin((*MI).second)) {
       delete (*MI).second;
     }
   }
 
   for (map_iterator MI = CSTM.begin(); MI != CSTM.end(); ++MI) {
     if (!ASTStringUtils::Instance().IsIndexed((*MI).first) &&
-        !IsComplexPart((*MI).first)) {
+        !IsComplexPart((*MI).first) && !IsBuiltin((*MI).second)) {
       delete (*MI).second;
     }
   }
 
   for (map_iterator MI = GLSTM.begin(); MI != GLSTM.end(); ++MI) {
     if (!ASTStringUtils::Instance().IsIndexed((*MI).first) &&
-        !IsComplexPart((*MI).first)) {
+        !IsComplexPart((*MI).first) && !IsBuiltin((*MI).second)) {
       delete (*MI).second;
     }
   }
 
   for (map_iterator MI = LSTM.begin(); MI != LSTM.end(); ++MI) {
     if (!ASTStringUtils::Instance().IsIndexed((*MI).first) &&
-        !IsComplexPart((*MI).first)) {
+        !IsComplexPart((*MI).first) && !IsBuiltin((*MI).second)) {
       delete (*MI).second;
     }
   }
 
   for (map_iterator MI = USTM.begin(); MI != USTM.end(); ++MI) {
     if (!ASTStringUtils::Instance().IsIndexed((*MI).first) &&
-        !IsComplexPart((*MI).first)) {
+        !IsComplexPart((*MI).first) && !IsBuiltin((*MI).second)) {
       delete (*MI).second;
     }
   }
 
   for (multimap_iterator MMI = STM.begin(); MMI != STM.end(); ++MMI) {
     if (!ASTStringUtils::Instance().IsIndexed((*MMI).first) &&
-        !IsComplexPart((*MMI).first)) {
+        !IsComplexPart((*MMI).first) && !IsBuiltin((*MMI).second)) {
       delete (*MMI).second;
     }
   }
+
+  Clear();
+
+  STM = BE.STM;
+  ASTM = BE.ASTM;
+  QSTM = BE.QSTM;
+  GSTM = BE.GSTM;
+  SGSTM = BE.SGSTM;
+  HGSTM = BE.HGSTM;
+  GPSTM = BE.GPSTM;
+  DSTM = BE.DSTM;
+  SDSTM = BE.SDSTM;
+  HDSTM = BE.HDSTM;
+  FSTM = BE.FSTM;
+  SFSTM = BE.SFSTM;
+  HFSTM = BE.HFSTM;
+  CSTM = BE.CSTM;
+  GLSTM = BE.GLSTM;
+  LSTM = BE.LSTM;
+  USTM = BE.USTM;
+}
+
+void ASTSymbolTable::Clear() {
+  STM.clear();
+  ASTM.clear();
+  QSTM.clear();
+  GSTM.clear();
+  SGSTM.clear();
+  HGSTM.clear();
+  GPSTM.clear();
+  DSTM.clear();
+  SDSTM.clear();
+  HDSTM.clear();
+  FSTM.clear();
+  SFSTM.clear();
+  HFSTM.clear();
+  CSTM.clear();
+  GLSTM.clear();
+  LSTM.clear();
+  USTM.clear();
 }
 
 } // namespace QASM
@@ -20,6 +20,7 @@
 #include <qasm/AST/ASTBarrier.h>
 #include <qasm/AST/ASTBox.h>
 #include <qasm/AST/ASTCBit.h>
+#include <qasm/AST/ASTConstantFolder.h>
 #include <qasm/AST/ASTDefcal.h>
 #include <qasm/AST/ASTDelay.h>
 #include <qasm/AST/ASTDuration.h>
@@ -41,6 +42,7 @@
 #include <qasm/AST/OpenPulse/ASTOpenPulsePlay.h>
 #include <qasm/AST/OpenPulse/ASTOpenPulsePort.h>
 #include <qasm/AST/OpenPulse/ASTOpenPulseWaveform.h>
+#include <qasm/AST/OpenPulse/ASTOpenPulseWaveformSynthesizer.h>
 
 #include <qasm/AST/ASTAngleNodeBuilder.h>
 #include <qasm/AST/ASTAnyTypeBuilder.h>
@@ -58,9 +60,13 @@
 #include <qasm/AST/ASTGateQubitTracker.h>
 #include <qasm/AST/ASTIdentifierBuilder.h>
 #include <qasm/AST/ASTInitializerListBuilder.h>
+#include <qasm/AST/ASTInstrumentation.h>
 #include <qasm/AST/ASTIntegerListBuilder.h>
+#include <qasm/AST/ASTLiteralPool.h>
+#include <qasm/AST/ASTObjectTracker.h>
 #include <qasm/AST/ASTOpenQASMVersionTracker.h>
 #include <qasm/AST/ASTParameterBuilder.h>
+#include <qasm/AST/ASTParseBudget.h>
 #include <qasm/AST/ASTQubitConcatBuilder.h>
 #include <qasm/AST/ASTStringList.h>
 #include <qasm/AST/ASTSwitchStatementBuilder.h>
@@ -88,13 +94,18 @@ std::set<std::string> ASTTypeSystemBuilder::RS;
 std::set<std::string> ASTTypeSystemBuilder::FR;
 
 ASTTypeSystemBuilder ASTTypeSystemBuilder::TSB;
+bool ASTTypeSystemBuilder::BEI = false;
 
 void ASTTypeSystemBuilder::Init() {
+  QASM_INSTR_SCOPE(TypeSystemInit);
+
   ASTStringListBuilder::Instance().Init();
   ASTExpressionNodeBuilder::Instance().Init();
   ASTInitializerListBuilder::Instance().Init();
   ASTDeclarationContextTracker::Instance().Init();
   ASTExpressionEvaluator::Instance().Init();
+  ASTConstantFolder::Instance().Init();
+  OpenPulse::ASTOpenPulseWaveformSynthesizer::Instance().Clear();
   ASTMangler::Init();
   ASTDemangler::Init();
   ASTIdentifierBuilder::Instance().Init();
@@ -112,7 +123,31 @@ void ASTTypeSystemBuilder::Init() {
   ASTGateOpBuilder::Instance().Init();
   ASTQubitConcatListBuilder::Instance().Init();
   ASTExpressionBuilder::Instance().Init();
+  ASTLiteralPool::Instance().Clear();
+
+  ASTDefcalGrammarBuilder::Instance().SetCurrent("openpulse");
 
+  // The builtin environment (reserved angles and constants, the U gate
+  // and the OpenPulse builtin functions) is created once per process.
+  // Its nodes are not tracked, and its Symbol Table entries are kept by
+  // ASTObjectTracker::Release(). The first parse of the process does not
+  // charge them to its ASTParseBudget either.
+  if (!BEI) {
+    ASTObjectTracker::Instance().Suspend();
+    ASTParseBudget::Instance().Suspend();
+    CreateBuiltinEnvironment();
+    ASTBuiltinFunctionsBuilder::Instance().Init();
+    ASTSymbolTable::Instance().SaveBuiltinEnvironment();
+    ASTParseBudget::Instance().Resume();
+    ASTObjectTracker::Instance().Resume();
+    BEI = true;
+  }
+
+  // The CX gate depends on the OpenQASM version of the parse.
+  ASTTypeSystemBuilder::Instance().CreateASTBuiltinCXGate();
+}
+
+void ASTTypeSystemBuilder::CreateBuiltinEnvironment() {
   unsigned Bits = ASTAngleNode::AngleBits;
 
   if (LM.empty()) {
@@ -563,10 +598,6 @@ void ASTTypeSystemBuilder::Init() {
   ASTTypeSystemBuilder::Instance().CreateASTReservedAngles();
   ASTTypeSystemBuilder::Instance().CreateASTReservedMPDecimalValues();
   ASTTypeSystemBuilder::Instance().CreateASTBuiltinUGate();
-  ASTTypeSystemBuilder::Instance().CreateASTBuiltinCXGate();
-
-  ASTDefcalGrammarBuilder::Instance().SetCurrent("openpulse");
-  ASTBuiltinFunctionsBuilder::Instance().Init();
 }
 
 void ASTTypeSystemBuilder::CreateASTBuiltinUGate() const {
@@ -650,7 +681,8 @@ void ASTTypeSystemBuilder::CreateASTBuiltinUGate() const {
 }
 
 void ASTTypeSystemBuilder::CreateASTBuiltinCXGate() const {
-  if (ASTOpenQASMVersionTracker::Instance().GetVersion() >= 3.0)
+  if (ASTOpenQASMVersionTracker::Instance().GetVersion() >= 3.0 ||
+      ASTSymbolTable::Instance().FindGate(u8"CX"))
     return;
 
   ASTParameterList GPL;
@@ -16,6 +16,7 @@
  * =============================================================================
  */
 
+#include <qasm/AST/ASTInstrumentation.h>
 #include <qasm/Frontend/QasmDiagnosticEmitter.h>
 #include <qasm/Frontend/QasmDriver.h>
 #include <qasm/Frontend/QasmScanner.h>
@@ -46,7 +47,10 @@ int ASTDriver::ExecParse(std::istream &In) {
   P.reset();
   P = std::make_unique<Parser>(*S, *this);
 
+  QASM_INSTR_ENTER(Parse);
   int R = P->parse();
+  QASM_INSTR_LEAVE(Parse);
+  QASM_INSTR_COUNT(Lines, S->lineno());
 
   if (R != 0 || QasmDiagnosticEmitter::Instance().HasErrors()) {
     std::stringstream M;
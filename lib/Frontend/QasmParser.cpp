@@ -20,8 +20,8 @@
 
 namespace QASM {
 
-void ASTParser::ParseCommandLineArguments(int argc, char *const argv[]) {
-  QasmPreprocessor::Instance().ParseCommandLineArguments(argc, argv);
+bool ASTParser::ParseCommandLineArguments(int argc, char *const argv[]) {
+  return QasmPreprocessor::Instance().ParseCommandLineArguments(argc, argv);
 }
 
 } // namespace QASM
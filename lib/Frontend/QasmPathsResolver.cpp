@@ -17,10 +17,24 @@
  */
 
 #include <qasm/AST/ASTBase.h>
+#include <qasm/AST/ASTDurationTicks.h>
+#include <qasm/AST/ASTInstrumentation.h>
+#include <qasm/AST/ASTLiteralPool.h>
+#include <qasm/AST/ASTMPMemoryPool.h>
+#include <qasm/AST/ASTMemoryAccounting.h>
 #include <qasm/AST/ASTObjectTracker.h>
+#include <qasm/AST/ASTParseBudget.h>
+#include <qasm/AST/OpenPulse/ASTOpenPulseWaveform.h>
+#include <qasm/AST/OpenPulse/ASTOpenPulseWaveformSynthesizer.h>
+#include <qasm/Frontend/QasmParser.h>
 #include <qasm/QPP/QasmPPFileCleaner.h>
 #include <qasm/QPP/QasmPathsResolver.h>
 
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
 #include <cstring>
 #include <filesystem>
 #include <iostream>
@@ -28,9 +42,32 @@
 
 namespace QASM {
 
-void QasmPathsResolver::ParseCommandLineArguments(int argc,
+// Parses the value of a -max-*= parse budget option, up to M. The object
+// tracker releases the memory of a parse that goes over the budget.
+static bool ParseBudgetLimit(const char *Opt, const char *V, uint64_t &N,
+                             uint64_t M = UINT64_MAX) {
+  char *E = nullptr;
+  errno = 0;
+  N = std::strtoull(V, &E, 10);
+  if (!std::isdigit(static_cast<unsigned char>(*V)) || *E) {
+    std::cerr << "Error: Invalid " << Opt << " value '" << V << "'."
+              << std::endl;
+    return false;
+  }
+
+  if (errno == ERANGE || N > M) {
+    std::cerr << "Error: " << Opt << " value '" << V << "' is out of range."
+              << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+bool QasmPathsResolver::ParseCommandLineArguments(int argc,
                                                   char *const argv[]) {
   bool push = false;
+  bool Valid = true;
 
   for (int I = 1; I < argc; ++I) {
     if ((argv[I][0] == '-') && (argv[I][1] == 'I')) {
@@ -48,13 +85,66 @@ void QasmPathsResolver::ParseCommandLineArguments(int argc,
         QasmPPFileCleaner::Instance().SetKeepTemps(true);
       else if (std::strcmp(argv[I], "-enable-free") == 0)
         ASTObjectTracker::Instance().Enable();
-      else
+      else if (std::strcmp(argv[I], "-mem-report") == 0) {
+        ASTObjectTracker::Instance().Enable();
+        ASTMemoryAccounting::Instance().Enable();
+      } else if (std::strcmp(argv[I], "-fast-path") == 0) {
+        ASTObjectTracker::Instance().Enable();
+        ASTParser::SetFastPath(true);
+      } else if (std::strcmp(argv[I], "-mp-pool") == 0)
+        ASTMPMemoryPool::Instance().Enable();
+      else if (std::strcmp(argv[I], "-literal-pool") == 0)
+        ASTLiteralPool::Instance().Enable();
+      else if (std::strcmp(argv[I], "-pack-waveforms") == 0)
+        OpenPulse::ASTOpenPulseWaveformNode::SetPackSamples(true);
+      else if (std::strcmp(argv[I], "-synthesize-waveforms") == 0)
+        OpenPulse::ASTOpenPulseWaveformSynthesizer::SetSynthesizeExterns(true);
+      else if (std::strncmp(argv[I], "-max-parse-ms=", 14) == 0) {
+        uint64_t N;
+        if (ParseBudgetLimit("-max-parse-ms", &argv[I][14], N,
+                             std::chrono::milliseconds::max().count()))
+          ASTParseBudget::Instance().SetTimeout(std::chrono::milliseconds(N));
+        else
+          Valid = false;
+      } else if (std::strncmp(argv[I], "-max-nodes=", 11) == 0) {
+        uint64_t N;
+        if (ParseBudgetLimit("-max-nodes", &argv[I][11], N))
+          ASTParseBudget::Instance().SetMaxNodes(N);
+        else
+          Valid = false;
+      } else if (std::strncmp(argv[I], "-max-symbols=", 13) == 0) {
+        uint64_t N;
+        if (ParseBudgetLimit("-max-symbols", &argv[I][13], N))
+          ASTParseBudget::Instance().SetMaxSymbols(N);
+        else
+          Valid = false;
+      } else if (std::strncmp(argv[I], "-max-bytes=", 11) == 0) {
+        uint64_t N;
+        if (ParseBudgetLimit("-max-bytes", &argv[I][11], N))
+          ASTParseBudget::Instance().SetMaxBytes(N);
+        else
+          Valid = false;
+      } else if (std::strncmp(argv[I], "-max-", 5) == 0) {
+        // A misspelled limit is not a translation unit.
+        std::cerr << "Error: Unknown option '" << argv[I] << "'." << std::endl;
+        Valid = false;
+      } else if (std::strncmp(argv[I], "-dt=", 4) == 0) {
+        if (!ASTDurationTimeBase::Instance().SetDT(&argv[I][4])) {
+          std::cerr << "Error: Invalid dt value '" << &argv[I][4] << "'."
+                    << std::endl;
+          Valid = false;
+        }
+      } else
         TU = argv[I] ? argv[I] : "";
     }
   }
+
+  return Valid;
 }
 
 std::string QasmPathsResolver::ResolvePath(const std::string &File) const {
+  QASM_INSTR_SCOPE(IncludeResolution);
+
   if (File.empty())
     return std::string();
 
@@ -0,0 +1,501 @@
+/* -*- coding: utf-8 -*-
+ *
+ * Copyright 2023 IBM RESEARCH. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ */
+
+#include <qasm/AST/ASTObjectTracker.h>
+#include <qasm/AST/ASTStatementBuilder.h>
+#include <qasm/Diagnostic/DIAGLineCounter.h>
+#include <qasm/Frontend/QasmDiagnosticEmitter.h>
+#include <qasm/Frontend/QasmReparser.h>
+
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+
+namespace QASM {
+
+static bool IsIdentifierChar(char C) {
+  return std::isalnum(static_cast<unsigned char>(C)) || C == '_';
+}
+
+namespace {
+
+// Enables the ASTObjectTracker for the lifetime of the object, if the
+// caller has not, and disables it again afterwards. The objects that
+// were registered meanwhile stay registered.
+class ASTReparserTracking {
+  bool Tracked;
+
+public:
+  ASTReparserTracking() : Tracked(ASTObjectTracker::Instance().IsEnabled()) {
+    if (!Tracked)
+      ASTObjectTracker::Instance().Enable();
+  }
+
+  ~ASTReparserTracking() {
+    if (!Tracked)
+      ASTObjectTracker::Instance().Disable();
+  }
+};
+
+// A diagnostic held back while a statement is spliced.
+struct ASTHeldDiagnostic {
+  std::string File;
+  ASTLocation Loc;
+  std::string Msg;
+  QasmDiagnosticEmitter::DiagLevel DL;
+};
+
+std::vector<ASTHeldDiagnostic> HeldDiagnostics;
+
+void HoldDiagnostic(const std::string &File, ASTLocation Loc,
+                    const std::string &Msg,
+                    QasmDiagnosticEmitter::DiagLevel DL) {
+  HeldDiagnostics.push_back({File, Loc, Msg, DL});
+}
+
+} // namespace
+
+ASTReparser::ASTReparser()
+    : Parser(), Source(), Spans(), Dirty(), Root(nullptr), Kind(NotParsed),
+      NumParsed(0U), NumReused(0U), NumSpliced(0U), Lead(0U), Clean(false),
+      Sound(false) {}
+
+ASTReparser::~ASTReparser() { Release(); }
+
+void ASTReparser::ReleaseParse() {
+  // A parse that failed leaves its nodes and symbols behind without a
+  // root, so the tracker is released after any parse.
+  if (Kind != NotParsed) {
+    ASTReparserTracking T;
+    ASTObjectTracker::Instance().Release();
+  }
+
+  delete Root;
+  Root = nullptr;
+  Spans.clear();
+  Dirty.clear();
+  Kind = NotParsed;
+  Clean = false;
+  Sound = false;
+}
+
+void ASTReparser::Release() {
+  ReleaseParse();
+  Source.clear();
+}
+
+// The end of the pragma or the annotation that starts at I. The scanner
+// reads the text of a directive verbatim up to the end of its line, and
+// a backslash carries it on to the next line.
+static std::size_t GetDirectiveEnd(const std::string &S, std::size_t I) {
+  bool Continued = false;
+
+  for (; I < S.size(); ++I) {
+    if (S[I] == '\\') {
+      Continued = true;
+    } else if (S[I] == '\n') {
+      if (!Continued)
+        break;
+
+      Continued = false;
+    }
+  }
+
+  return I;
+}
+
+// True if the token [I, J) opens a pragma or an annotation: the pragma
+// keyword, #pragma, or an @ followed by the name of an annotation.
+static bool IsDirective(const std::string &S, std::size_t I, std::size_t J) {
+  if (S[I] == '@')
+    return J < S.size() && std::isalnum(static_cast<unsigned char>(S[J]));
+
+  if (S[I] == '#') {
+    while (J < S.size() && (S[J] == ' ' || S[J] == '\t'))
+      ++J;
+
+    return S.compare(J, 6, "pragma") == 0 &&
+           (J + 6 >= S.size() || !IsIdentifierChar(S[J + 6]));
+  }
+
+  return S.compare(I, J - I, "pragma") == 0;
+}
+
+bool ASTReparser::Scan(const std::string &S, std::size_t B, std::size_t E,
+                       std::vector<StatementSpan> *V, std::string *N) {
+  std::size_t I = B;
+  std::size_t SB = B;
+  std::size_t PE = B;
+  std::size_t TE = B;
+  unsigned Depth = 0U;
+  bool InStatement = false;
+  bool Pending = false;
+  bool PendingBrace = false;
+  bool LineDirective = false;
+
+  while (I < E) {
+    // Whitespace and comments.
+    std::size_t G = I;
+    while (I < E) {
+      if (std::isspace(static_cast<unsigned char>(S[I]))) {
+        ++I;
+      } else if (S[I] == '/' && I + 1 < E && S[I + 1] == '/') {
+        while (I < E && S[I] != '\n')
+          ++I;
+      } else if (S[I] == '/' && I + 1 < E && S[I + 1] == '*') {
+        std::string::size_type C = S.find("*/", I + 2);
+        if (C == std::string::npos || C + 2 > E)
+          return false;
+
+        I = C + 2;
+      } else {
+        break;
+      }
+    }
+
+    if (I > G) {
+      std::size_t K = std::count(S.begin() + G, S.begin() + I, '\n');
+      if (N && I < S.size()) {
+        if (K) {
+          N->append(K, '\n');
+          G = S.rfind('\n', I - 1) + 1;
+        }
+
+        N->append(I - G, ' ');
+      }
+
+      // A #line or a #file directive ends at the end of its line, with or
+      // without a semicolon.
+      if (K && InStatement && LineDirective && !Pending) {
+        Pending = true;
+        PendingBrace = false;
+        PE = TE;
+      }
+    }
+
+    if (I >= E)
+      break;
+
+    // A statement ends after a semicolon, or a closing brace, at the top
+    // level, unless an else, or the semicolon of an initializer list,
+    // follows it.
+    if (Pending) {
+      bool Else = S.compare(I, 4, "else") == 0 &&
+                  (I + 4 >= E || !IsIdentifierChar(S[I + 4]));
+      if (!Else && !(PendingBrace && S[I] == ';')) {
+        if (V)
+          V->push_back({SB, PE});
+        InStatement = false;
+      }
+
+      Pending = false;
+    }
+
+    bool First = !InStatement;
+    if (First) {
+      InStatement = true;
+      LineDirective = false;
+      SB = I;
+    }
+
+    std::size_t J = I + 1;
+    if (S[I] == '"') {
+      while (J < E && S[J] != '"')
+        J += S[J] == '\\' ? 2 : 1;
+
+      if (J >= E)
+        return false;
+
+      ++J;
+    } else if (IsIdentifierChar(S[I])) {
+      while (J < E && IsIdentifierChar(S[J]))
+        ++J;
+    }
+
+    // A pragma or an annotation is read up to the end of its line, and is
+    // a statement of its own at the top level. It may contain brackets,
+    // semicolons and comment delimiters that are not tokens.
+    if ((S[I] == 'p' || S[I] == '#' || S[I] == '@') &&
+        IsDirective(S, I, J)) {
+      J = GetDirectiveEnd(S, I);
+      if (J > E)
+        return false;
+
+      if (N)
+        N->append(S, I, J - I);
+
+      if (First && Depth == 0U) {
+        if (V)
+          V->push_back({SB, J});
+        InStatement = false;
+      }
+
+      TE = J;
+      I = J;
+      continue;
+    }
+
+    if (First && S[I] == '#')
+      LineDirective = true;
+
+    switch (S[I]) {
+    case '{':
+    case '(':
+    case '[':
+      ++Depth;
+      break;
+    case '}':
+    case ')':
+    case ']':
+      if (Depth)
+        --Depth;
+      if (S[I] == '}' && Depth == 0U) {
+        Pending = true;
+        PendingBrace = true;
+        PE = J;
+      }
+      break;
+    case ';':
+      if (Depth == 0U) {
+        Pending = true;
+        PendingBrace = false;
+        PE = J;
+      }
+      break;
+    default:
+      break;
+    }
+
+    if (N)
+      N->append(S, I, J - I);
+
+    TE = J;
+    I = J;
+  }
+
+  if (!Pending && InStatement && LineDirective) {
+    Pending = true;
+    PE = TE;
+  }
+
+  if (Pending) {
+    if (V)
+      V->push_back({SB, PE});
+    InStatement = false;
+  }
+
+  return !InStatement && Depth == 0U;
+}
+// True if the statement that starts at I includes another file.
+static bool IsInclude(const std::string &S, std::size_t I) {
+  if (S[I] == '#')
+    ++I;
+
+  return S.compare(I, 7, "include") == 0 &&
+         (I + 7 >= S.size() || !IsIdentifierChar(S[I + 7]));
+}
+
+void ASTReparser::Reparse() {
+  ReleaseParse();
+
+  QasmDiagnosticEmitter &DE = QasmDiagnosticEmitter::Instance();
+  const unsigned E = DE.GetNumErrors();
+  const unsigned I = DE.GetNumICEs();
+
+  {
+    ASTReparserTracking T;
+    Root = Parser.ParseAST(Source);
+  }
+
+  Clean = Scan(Source, 0UL, Source.size(), &Spans, nullptr);
+  Kind = Parsed;
+  ++NumParsed;
+
+  // The top-level statements of the statement list must map one to one
+  // to the statements of the source, after the OPENQASM statement, which
+  // is prepended to the list.
+  ASTStatementBuilder &SB = ASTStatementBuilder::Instance();
+  const std::vector<ASTStatementBuilder::Boundary> &BV = SB.GetBoundaries();
+  Lead = static_cast<unsigned>(Spans.size() - BV.size());
+  Sound = Root && Clean && DE.GetNumErrors() == E && DE.GetNumICEs() == I &&
+          Spans.size() >= BV.size() && Lead <= 1U;
+
+  if (Sound && Lead)
+    Sound = Source.compare(Spans.front().Begin, 8, "OPENQASM") == 0;
+
+  if (Sound)
+    Sound = BV.empty() ? SB.Size() == Lead
+                       : BV.front().Begin == Lead && BV.back().End == SB.Size();
+
+  for (std::vector<StatementSpan>::const_iterator SI = Spans.begin();
+       Sound && SI != Spans.end(); ++SI)
+    Sound = !IsInclude(Source, (*SI).Begin);
+}
+
+bool ASTReparser::Splice(std::size_t I, const StatementSpan &SS,
+                         std::size_t E) {
+  const std::vector<ASTStatementBuilder::Boundary> &BV =
+      ASTStatementBuilder::Instance().GetBoundaries();
+  if (!Sound || I < Lead || I - Lead >= BV.size() || !BV[I - Lead].Transient)
+    return false;
+
+  // The statement after it must start on a later line, so that its
+  // columns are unchanged.
+  if (E < Source.size() &&
+      std::find(Source.begin() + SS.End, Source.begin() + E, '\n') ==
+          Source.begin() + E)
+    return false;
+
+  std::string::size_type NL =
+      SS.Begin ? Source.rfind('\n', SS.Begin - 1UL) : std::string::npos;
+  unsigned L = static_cast<unsigned>(
+      std::count(Source.begin(), Source.begin() + SS.Begin, '\n') + 1);
+  unsigned C = static_cast<unsigned>(
+      SS.Begin - (NL == std::string::npos ? 0UL : NL + 1UL) + 1UL);
+
+  QasmDiagnosticEmitter &DE = QasmDiagnosticEmitter::Instance();
+  QasmDiagnosticEmitter::QasmDiagnosticHandler H = DE.GetHandler();
+  const unsigned NE = DE.GetNumErrors();
+  const unsigned NW = DE.GetNumWarnings();
+  const unsigned NI = DE.GetNumICEs();
+  ASTStatementBuilder::list_type V;
+  std::vector<ASTStatementBuilder::Boundary> FB;
+  bool OK;
+
+  HeldDiagnostics.clear();
+  DE.SetHandler(HoldDiagnostic);
+
+  try {
+    ASTReparserTracking T;
+    OK = Parser.ParseFragment(Source.substr(SS.Begin, SS.End - SS.Begin), L,
+                              C, V, FB);
+  } catch (...) {
+    DE.SetHandler(H);
+    HeldDiagnostics.clear();
+    DE.ResetCounters(NE, NW, NI);
+    throw;
+  }
+
+  DE.SetHandler(H);
+
+  // The fragment must be a single transient statement that parsed
+  // without an error. The nodes of a fragment that is not are released
+  // by the full parse that follows.
+  OK = OK && DE.GetNumErrors() == NE && DE.GetNumICEs() == NI &&
+       FB.size() == 1UL && FB.front().Transient &&
+       FB.front().Begin == 0UL && FB.front().End == V.size();
+
+  if (!OK) {
+    HeldDiagnostics.clear();
+    DE.ResetCounters(NE, NW, NI);
+    return false;
+  }
+
+  ASTStatementBuilder::Instance().Replace(I - Lead, V, true);
+
+  for (const ASTHeldDiagnostic &HD : HeldDiagnostics)
+    H(HD.File, HD.Loc, HD.Msg, HD.DL);
+
+  HeldDiagnostics.clear();
+  return true;
+}
+
+void ASTReparser::SetDirty(std::size_t B, std::size_t E) {
+  Dirty.clear();
+
+  for (unsigned I = 0; I < Spans.size(); ++I) {
+    if (Spans[I].Begin > E)
+      break;
+    if (Spans[I].End >= B)
+      Dirty.push_back(I);
+  }
+}
+
+ASTRoot *ASTReparser::Parse(const std::string &S) {
+  Source = S;
+  Reparse();
+  Dirty.clear();
+  return Root;
+}
+
+ASTRoot *ASTReparser::Edit(std::size_t Offset, std::size_t Length,
+                          const std::string &Text) {
+  if (Offset > Source.size() || Length > Source.size() - Offset) {
+    std::stringstream M;
+    M << "Edit range [" << Offset << ", " << Offset + Length
+      << ") is out of the bounds of the source.";
+    QasmDiagnosticEmitter::Instance().EmitDiagnostic(
+        DIAGLineCounter::Instance().GetLocation(), M.str(), DiagLevel::Error);
+    return nullptr;
+  }
+
+  // The region is bounded by the end of the last statement before the
+  // edit, and the beginning of the first statement after it. Both lie
+  // outside of any comment or string literal, so the text outside of the
+  // region is lexed the same way before and after the edit.
+  std::vector<StatementSpan>::iterator F = std::lower_bound(
+      Spans.begin(), Spans.end(), Offset,
+      [](const StatementSpan &SS, std::size_t O) { return SS.End < O; });
+  std::vector<StatementSpan>::iterator L = std::upper_bound(
+      F, Spans.end(), Offset + Length,
+      [](std::size_t O, const StatementSpan &SS) { return O < SS.Begin; });
+
+  std::size_t B = F == Spans.begin() ? 0UL : (*(F - 1)).End;
+  std::size_t E = L == Spans.end() ? Source.size() : (*L).Begin;
+
+  std::string OR;
+  std::string NR;
+  std::vector<StatementSpan> RS;
+  std::size_t NE = E + Text.size() - Length;
+  std::size_t FI = F - Spans.begin();
+  std::size_t LI = L - Spans.begin();
+
+  bool Valid = Root && Clean && Scan(Source, B, E, nullptr, &OR);
+  std::size_t NL = std::count(Source.begin() + B, Source.begin() + E, '\n');
+  Source.replace(Offset, Length, Text);
+  Valid = Valid && Scan(Source, B, NE, &RS, &NR);
+
+  if (Valid && OR == NR) {
+    Kind = Reused;
+    ++NumReused;
+  } else if (Valid && LI == FI + 1UL && RS.size() == 1UL &&
+             NL == static_cast<std::size_t>(std::count(
+                       Source.begin() + B, Source.begin() + NE, '\n')) &&
+             Splice(FI, RS.front(), NE)) {
+    Kind = Spliced;
+    ++NumSpliced;
+  } else {
+    Reparse();
+    SetDirty(Offset, Offset + Text.size());
+    return Root;
+  }
+
+  // Replace the statements of the region, and shift the ones after it.
+  std::vector<StatementSpan>::iterator I =
+      Spans.erase(Spans.begin() + FI, Spans.begin() + LI);
+  for (; I != Spans.end(); ++I) {
+    (*I).Begin = (*I).Begin + Text.size() - Length;
+    (*I).End = (*I).End + Text.size() - Length;
+  }
+
+  Spans.insert(Spans.begin() + FI, RS.begin(), RS.end());
+  SetDirty(Offset, Offset + Text.size());
+  return Root;
+}
+
+} // namespace QASM
@@ -178,7 +178,9 @@ using DiagLevel = QASM::QasmDiagnosticEmitter::DiagLevel;
 #include <cfloat>
 #include <cassert>
 #include <cstring>
+#include <functional>
 #include <typeinfo>
+#include <vector>
 
 #include <qasm/AST/AST.h>
 #include <qasm/AST/ASTTypes.h>
@@ -196,6 +198,10 @@ using DiagLevel = QASM::QasmDiagnosticEmitter::DiagLevel;
 #include <qasm/AST/ASTParameterBuilder.h>
 #include <qasm/AST/ASTAnyTypeBuilder.h>
 #include <qasm/AST/ASTGateNodeBuilder.h>
+#include <qasm/AST/ASTInstrumentation.h>
+#include <qasm/AST/ASTMemoryAccounting.h>
+#include <qasm/AST/ASTObjectTracker.h>
+#include <qasm/AST/ASTParseBudget.h>
 #include <qasm/AST/ASTSymbolTable.h>
 
 #include <qasm/Frontend/QasmDriver.h>
@@ -208,7 +214,45 @@ using DiagLevel = QASM::QasmDiagnosticEmitter::DiagLevel;
 #undef yylex
 #endif
 
-#define yylex QASMScanner.yylex
+// Set at the first error of the first parse of the fast path. That
+// parse is abandoned when the scanner is asked for the next token, and
+// not from inside the action that reported the error.
+static bool FastPassFailed = false;
+
+// Thrown out of the first parse of the fast path, between two tokens.
+struct QasmFastPassError {};
+
+static void QasmCheckFastPass() {
+  if (FastPassFailed)
+    throw QasmFastPassError();
+}
+
+#if defined(OPENQASM_INSTRUMENTATION)
+static int QasmInstrumentedLex(QASM::Parser::semantic_type* const LVal,
+                               QASM::Parser::location_type* Loc,
+                               QASM::ASTScanner& S) {
+  QasmCheckFastPass();
+  QASM::ASTParseBudget::Instance().Tick();
+  QASM_INSTR_SCOPE(Scan);
+  int T = S.yylex(LVal, Loc, S);
+  QASM_INSTR_COUNT(Tokens, 1);
+  QASM_INSTR_COUNT(Chars, S.YYLeng());
+  return T;
+}
+
+#define yylex QasmInstrumentedLex
+#else
+// Reads the deadline of the ASTParseBudget once in a while.
+static int QasmBudgetedLex(QASM::Parser::semantic_type* const LVal,
+                           QASM::Parser::location_type* Loc,
+                           QASM::ASTScanner& S) {
+  QasmCheckFastPass();
+  QASM::ASTParseBudget::Instance().Tick();
+  return S.yylex(LVal, Loc, S);
+}
+
+#define yylex QasmBudgetedLex
+#endif
 
 #ifdef GET_TOKEN
 #undef GET_TOKEN
@@ -225,6 +269,56 @@ std::ifstream InFile;
 std::istream* InStream = nullptr;
 
 extern int yylineno;
+extern int yycolno;
+extern int prev_yycolno;
+extern unsigned newlinecount;
+extern bool skip_newline;
+
+// Puts the scanner and the parser globals back in their initial state,
+// so that a translation unit parsed after another one in the same
+// process starts on line 1, with the start token of OpenQASM, without
+// a version statement, and outside of any context a parse that was
+// abandoned on an error left open.
+static void QasmResetParseState() {
+  OQS = nullptr;
+  OpenQASMStated = false;
+  yylineno = 1;
+  yycolno = 1;
+  prev_yycolno = 1;
+  newlinecount = 0;
+  skip_newline = false;
+  QASM::ASTScanner::start_openqasm =
+    QASM::Parser::token::TOK_START_OPENQASM;
+  QASM::DIAGLineCounter::Instance().ResetLine();
+  QASM::DIAGLineCounter::Instance().ResetCol();
+  QASM::ASTPragmaContextBuilder::Instance().CloseContext();
+  QASM::ASTAnnotationContextBuilder::Instance().CloseContext();
+  QASM::ASTCalContextBuilder::Instance().CloseContext();
+  QASM::ASTDefcalContextBuilder::Instance().CloseContext();
+  QASM::ASTFunctionContextBuilder::Instance().CloseContext();
+  QASM::ASTGateContextBuilder::Instance().CloseContext();
+  QASM::ASTKernelContextBuilder::Instance().CloseContext();
+  QASM::ASTDeclarationContextTracker::Instance().PopToGlobalContext();
+}
+
+// When the statements are streamed, the OPENQASM version statement is
+// handed out before the first statement of the program, instead of
+// being prepended to the statement list once the program is reduced.
+static void QasmStreamOpenQASMStatement(const std::string* Q,
+                                        const std::string* V) {
+  if (!QASM::ASTStatementBuilder::Instance().IsStreaming() ||
+      (OQS && OpenQASMStated))
+    return;
+
+  assert(Q && "Invalid OpenQASM Token argument!");
+  assert(V && "Invalid OpenQASM Version argument!");
+
+  OQS = QASM::ASTBuilder::Instance().CreateASTOpenQASMStatementNode(*Q, *V);
+  assert(OQS && "Could not create a valid ASTOpenQASMStatementNode!");
+  QASM::ASTOpenQASMVersionTracker::Instance().SetVersion(std::stod(*V));
+  OpenQASMStated = true;
+  QASM::ASTStatementBuilder::Instance().Stream(OQS);
+}
 
 bool openstream(const char* Path) {
   if (!Path || !*Path)
@@ -313,7 +407,11 @@ int yyparse() {
     if (OQ != "OPENQASM" || OV.empty())
       QASM::ASTOpenQASMVersionTracker::Instance().SetVersion(3.0);
 
-    if (!QASM::QasmPreprocessor::Instance().Preprocess(*IFS)) {
+    QASM_INSTR_ENTER(Preprocess);
+    bool PP = QASM::QasmPreprocessor::Instance().Preprocess(*IFS);
+    QASM_INSTR_LEAVE(Preprocess);
+
+    if (!PP) {
       std::stringstream M;
       M << "OpenQASM Preprocessor failure!";
       QASM::QasmDiagnosticEmitter::Instance().EmitDiagnostic(
@@ -389,7 +487,11 @@ int yyparse() {
       IIS->seekg(0, std::ios::beg);
     }
 
-    if (!QASM::QasmPreprocessor::Instance().Preprocess(IIS)) {
+    QASM_INSTR_ENTER(Preprocess);
+    bool PP = QASM::QasmPreprocessor::Instance().Preprocess(IIS);
+    QASM_INSTR_LEAVE(Preprocess);
+
+    if (!PP) {
       std::stringstream M;
       M << "OpenQASM Preprocessor failure!";
       QASM::QasmDiagnosticEmitter::Instance().EmitDiagnostic(
@@ -864,7 +966,9 @@ OpenPulseProgram
   : OpenPulseStmtList {
     $$ = $1;
   }
-  | TOK_IBMQASM TOK_FP_CONSTANT ';' StmtListImpl {
+  | TOK_IBMQASM TOK_FP_CONSTANT ';' {
+    QasmStreamOpenQASMStatement($1, $2);
+  } StmtListImpl {
     assert($1 && "Invalid OpenQASM Token argument!");
     assert($2 && "Invalid OpenQASM Version argument!");
 
@@ -878,7 +982,9 @@ OpenPulseProgram
       OpenQASMStated = true;
     }
   }
-  | TOK_IBMQASM TOK_INTEGER_CONSTANT ';' StmtList {
+  | TOK_IBMQASM TOK_INTEGER_CONSTANT ';' {
+    QasmStreamOpenQASMStatement($1, $2);
+  } StmtList {
     $$ = ASTStatementBuilder::Instance().List();
 
     if (!OQS || !OpenQASMStated) {
@@ -897,7 +1003,9 @@ OpenQASMProgram
   : StmtList {
     $$ = $1;
   }
-  | TOK_IBMQASM TOK_FP_CONSTANT ';' StmtListImpl {
+  | TOK_IBMQASM TOK_FP_CONSTANT ';' {
+    QasmStreamOpenQASMStatement($1, $2);
+  } StmtListImpl {
     assert($1 && "Invalid OpenQASM Token argument!");
     assert($2 && "Invalid OpenQASM Version argument!");
 
@@ -911,7 +1019,9 @@ OpenQASMProgram
       OpenQASMStated = true;
     }
   }
-  | TOK_IBMQASM TOK_INTEGER_CONSTANT ';' StmtList {
+  | TOK_IBMQASM TOK_INTEGER_CONSTANT ';' {
+    QasmStreamOpenQASMStatement($1, $2);
+  } StmtList {
     $$ = ASTStatementBuilder::Instance().List();
 
     if (!OQS || !OpenQASMStated) {
@@ -940,11 +1050,13 @@ StmtListImpl
   | StmtListImpl Statement {
     if ($2 && !$2->IsDirective())
       ASTStatementBuilder::Instance().Append($2);
+    ASTStatementBuilder::Instance().Flush();
     $$ = ASTStatementBuilder::Instance().List();
   }
   | StmtListImpl OpenPulseStatement {
     if ($2 && !$2->IsDirective())
       ASTStatementBuilder::Instance().Append($2);
+    ASTStatementBuilder::Instance().Flush();
     $$ = ASTStatementBuilder::Instance().List();
   }
   ;
@@ -7304,7 +7416,185 @@ FileDirective
 
 %%
 
+bool QASM::ASTParser::FastPath = false;
+bool QASM::ASTParser::FastPass = false;
+
+namespace {
+
+// A diagnostic held back during the first parse of the fast path.
+struct QasmHeldDiagnostic {
+  std::string File;
+  QASM::ASTLocation Loc;
+  std::string Msg;
+  DiagLevel DL;
+};
+
+std::vector<QasmHeldDiagnostic> HeldDiagnostics;
+
+void QasmHoldDiagnostic(const std::string& File, QASM::ASTLocation Loc,
+                        const std::string& Msg, DiagLevel DL) {
+  if (DL == DiagLevel::Error || DL == DiagLevel::ICE) {
+    FastPassFailed = true;
+    return;
+  }
+
+  HeldDiagnostics.push_back({File, Loc, Msg, DL});
+}
+
+} // namespace
+
+// Releases the AST, the symbol table and the input of an abandoned parse.
+static void QasmReleaseParse() {
+  QASM::ASTObjectTracker::Instance().Release();
+  delete Root;
+  Root = nullptr;
+
+  if (InFile.is_open())
+    InFile.close();
+  InFile.clear();
+}
+
+QASM::ASTRoot*
+QASM::ASTParser::ParseFast(const std::function<QASM::ASTRoot*()>& Parse) {
+  QASM::QasmDiagnosticEmitter& DE = QASM::QasmDiagnosticEmitter::Instance();
+  QASM::QasmDiagnosticEmitter::QasmDiagnosticHandler H = DE.GetHandler();
+  const unsigned E = DE.GetNumErrors();
+  const unsigned W = DE.GetNumWarnings();
+  const unsigned I = DE.GetNumICEs();
+  QASM::ASTRoot* R = nullptr;
+  bool Failed = false;
+
+  HeldDiagnostics.clear();
+  DE.SetHandler(QasmHoldDiagnostic);
+  FastPassFailed = false;
+  FastPass = true;
+
+  try {
+    R = Parse();
+    Failed = FastPassFailed || !R || DE.GetNumErrors() != E ||
+             DE.GetNumICEs() != I;
+  } catch (const QasmFastPassError&) {
+    Failed = true;
+  } catch (...) {
+    FastPass = false;
+    FastPassFailed = false;
+    DE.SetHandler(H);
+    HeldDiagnostics.clear();
+    DE.ResetCounters(E, W, I);
+    throw;
+  }
+
+  FastPass = false;
+  FastPassFailed = false;
+  DE.SetHandler(H);
+
+  if (!Failed) {
+    for (const QasmHeldDiagnostic& HD : HeldDiagnostics)
+      H(HD.File, HD.Loc, HD.Msg, HD.DL);
+
+    HeldDiagnostics.clear();
+    return R;
+  }
+
+  HeldDiagnostics.clear();
+  DE.ResetCounters(E, W, I);
+  QasmReleaseParse();
+  return Parse();
+}
+
+QASM::ASTRoot* QASM::ASTParser::ParseWithBudget(
+    const std::function<QASM::ASTRoot*()>& Parse) {
+  QASM::ASTParseBudget& PB = QASM::ASTParseBudget::Instance();
+  if (!PB.IsEnabled())
+    return Parse();
+
+  // An abandoned parse is released through the ASTObjectTracker. If the
+  // caller has not enabled it, it is enabled for this parse only, and a
+  // parse that completes hands its AST over unmanaged, as it would have
+  // been without a budget.
+  QASM::ASTObjectTracker& OT = QASM::ASTObjectTracker::Instance();
+  const bool Tracked = OT.IsEnabled();
+  if (!Tracked)
+    OT.Enable();
+
+  PB.Start();
+
+  try {
+    QASM::ASTRoot* R = Parse();
+    PB.Check();
+    PB.Stop();
+
+    if (!Tracked) {
+      OT.Clear();
+      OT.Disable();
+    }
+
+    return R;
+  } catch (const QASM::ASTParseBudgetExceeded& E) {
+    PB.Stop();
+    QasmReleaseParse();
+
+    if (!Tracked)
+      OT.Disable();
+
+    QASM::QasmDiagnosticEmitter::Instance().EmitDiagnostic(
+      DIAGLineCounter::Instance().GetLocation(), E.what(), DiagLevel::Error);
+  } catch (...) {
+    PB.Stop();
+
+    if (!Tracked) {
+      OT.Clear();
+      OT.Disable();
+    }
+
+    throw;
+  }
+
+  return nullptr;
+}
+
 QASM::ASTRoot* QASM::ASTParser::ParseAST(std::istream* IS) {
+  return ParseWithBudget([this, IS] { return ParseWithFastPath(IS); });
+}
+
+QASM::ASTRoot* QASM::ASTParser::ParseAST(const std::string& IS) {
+  return ParseWithBudget([this, &IS] { return ParseWithFastPath(IS); });
+}
+
+QASM::ASTRoot* QASM::ASTParser::ParseWithFastPath(std::istream* IS) {
+  if (!FastPath || !QASM::ASTObjectTracker::Instance().IsEnabled() ||
+      QASM::ASTStatementBuilder::Instance().IsStreaming())
+    return ParseInput(IS);
+
+  if (QasmPreprocessor::Instance().IsTU())
+    return ParseFast([this, IS] { return ParseInput(IS); });
+
+  if (!IS)
+    return ParseInput(IS);
+
+  std::streampos P = IS->tellg();
+  if (P == std::streampos(-1))
+    return ParseInput(IS);
+
+  return ParseFast([this, IS, P] {
+    IS->clear();
+    IS->seekg(P);
+    return ParseInput(IS);
+  });
+}
+
+QASM::ASTRoot* QASM::ASTParser::ParseWithFastPath(const std::string& IS) {
+  if (!FastPath || !QASM::ASTObjectTracker::Instance().IsEnabled() ||
+      QASM::ASTStatementBuilder::Instance().IsStreaming())
+    return ParseInput(IS);
+
+  return ParseFast([this, &IS] { return ParseInput(IS); });
+}
+
+QASM::ASTRoot* QASM::ASTParser::ParseInput(std::istream* IS) {
+  QASM_INSTR_CLEAR();
+  QasmResetParseState();
+
   Root = new QASM::ASTRoot();
   if (!Root) {
     std::stringstream M;
@@ -7354,10 +7644,15 @@ QASM::ASTRoot* QASM::ASTParser::ParseAST(std::istream* IS) {
   }
 
   InFile.close();
+  QASM_INSTR_COUNT_NODES();
+  QASM::ASTMemoryAccounting::Instance().Collect();
   return Root;
 }
 
-QASM::ASTRoot* QASM::ASTParser::ParseAST(const std::string& IS) {
+QASM::ASTRoot* QASM::ASTParser::ParseInput(const std::string& IS) {
+  QASM_INSTR_CLEAR();
+  QasmResetParseState();
+
   Root = new QASM::ASTRoot();
   if (!Root) {
     std::stringstream M;
@@ -7385,9 +7680,53 @@ QASM::ASTRoot* QASM::ASTParser::ParseAST(const std::string& IS) {
   }
 
   ISS.clear();
+  QASM_INSTR_COUNT_NODES();
+  QASM::ASTMemoryAccounting::Instance().Collect();
   return Root;
 }
 
+QASM::ASTRoot*
+QASM::ASTParser::StreamAST(const ASTStatementBuilder::stream_callback& CB,
+                           std::istream* IS) {
+  QASM::ASTStatementBuilder::Instance().SetStreamCallback(CB);
+  QASM::ASTRoot* R = ParseAST(IS);
+
+  // Statements appended after the last top-level statement was reduced,
+  // such as syntax errors.
+  QASM::ASTStatementBuilder::Instance().Flush();
+  QASM::ASTStatementBuilder::Instance().ClearStreamCallback();
+  return R;
+}
+
+bool QASM::ASTParser::ParseFragment(
+    const std::string& S, unsigned L, unsigned C,
+    QASM::ASTStatementBuilder::list_type& V,
+    std::vector<QASM::ASTStatementBuilder::Boundary>& BV) {
+  QASM::ASTStatementBuilder& SB = QASM::ASTStatementBuilder::Instance();
+  V.clear();
+  BV.clear();
+  SB.Swap(V, BV);
+
+  // The scanner starts the first line at column 1, and the lines after
+  // it at column 0.
+  yylineno = static_cast<int>(L);
+  yycolno = static_cast<int>(L == 1U ? C : C - 1U);
+  prev_yycolno = yycolno;
+  newlinecount = 0;
+  skip_newline = false;
+  QASM::ASTScanner::start_openqasm =
+    QASM::Parser::token::TOK_START_OPENQASM;
+  QASM::DIAGLineCounter::Instance().SetLocation(L, yycolno);
+
+  // Double-parens are required here. Horrible C++ parsing rule.
+  std::istringstream ISS((S));
+  QASM::ASTDriver D;
+  int R = D.Parse(ISS);
+
+  SB.Swap(V, BV);
+  return R == 0;
+}
+
 void QASM::Parser::error(const QASM::location& Loc, const std::string& Msg) {
   (void) Loc;
   QASM::QasmDiagnosticEmitter::Instance().EmitDiagnostic(
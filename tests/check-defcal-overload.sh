@@ -0,0 +1,47 @@
+#!/bin/bash
+#
+# Checks which defcal declaration each defcal call resolved to.
+#
+# Usage: check-defcal-overload.sh <parser-output> <index> [<index> ...]
+#
+# The declarations are numbered from 0 in the order in which they first
+# appear in <parser-output>. The N-th <index> is the number of the
+# declaration the N-th defcal call must resolve to. The declarations must
+# have distinct mangled names.
+
+if [ $# -lt 2 ] ; then
+  echo "Usage: `basename $0` <parser-output> <index> [<index> ...]" 1>&2
+  exit 1
+fi
+
+OUTPUT="$1"
+shift
+
+# The mangled name of a declaration is printed just before its
+# <IsDefcalCall>false</IsDefcalCall>.
+DECLS=(`awk '
+  /^<MangledName>/ { M = $0; next }
+  /^<IsDefcalCall>false<\/IsDefcalCall>/ {
+    sub(/^<MangledName>/, "", M); sub(/<\/MangledName>$/, "", M)
+    if (!(M in S)) { S[M] = 1; print M }
+  }' "${OUTPUT}"`)
+
+CALLS=(`sed -n -e 's#^<ResolvedDefcal>\(.*\)</ResolvedDefcal>$#\1#p' \
+  "${OUTPUT}"`)
+
+if [ ${#CALLS[@]} -ne $# ] ; then
+  echo "Expected $# defcal calls, found ${#CALLS[@]}." 1>&2
+  exit 1
+fi
+
+N=0
+for E in "$@" ; do
+  if [ "${CALLS[$N]}" != "${DECLS[$E]}" ] ; then
+    echo "Defcal call ${N} resolved to ${CALLS[$N]}," \
+      "expected declaration ${E} (${DECLS[$E]})." 1>&2
+    exit 1
+  fi
+  N=$((N + 1))
+done
+
+exit 0
@@ -0,0 +1,63 @@
+#!/bin/bash
+#
+# Measures how the parse time scales with one dimension of the input.
+#
+# Usage: scaling-bench.sh <parameter> <value> [<value> ...]
+#
+# <parameter> is a QasmGen option: qubits, gates, depth, gate-defs, defcals,
+# array-size, expr-depth or nesting. For every <value>, a program is
+# generated with QasmGen, and parsed by QasmBench in a process of its own.
+# The results are printed as CSV on stdout.
+#
+# The other QasmGen options can be set in QASMGEN_ARGS, e.g.
+#   QASMGEN_ARGS="--qubits 1024" ./scaling-bench.sh gates 10000 100000
+#
+# Like the other scripts in this directory, this script is intended to be
+# run from the `build/bin` directory.
+
+if [ $# -lt 2 ] ; then
+  echo "Usage: `basename $0` <parameter> <value> [<value> ...]" 1>&2
+  exit 1
+fi
+
+export HERE="`pwd`"
+export SCRIPTDIR="$(cd "$(dirname "$0")" && pwd)"
+export TESTINCDIR="${SCRIPTDIR}/include"
+export QASMGEN="${HERE}/QasmGen"
+export QASMBENCH="${HERE}/QasmBench"
+export ITERATIONS="${ITERATIONS:-3}"
+
+PARAM="$1"
+shift
+
+WORKDIR="`mktemp -d`"
+trap "rm -rf ${WORKDIR}" EXIT
+
+field() {
+  echo "$2" | sed -e "s/.*\"$1\": \([0-9.]*\).*/\1/"
+}
+
+echo "${PARAM},lines,tokens,nodes,parse_ms_median,lines_per_sec,allocs,peak_rss_kb"
+
+for value in "$@" ; do
+  QASMFILE="${WORKDIR}/scaling-${PARAM}-${value}.qasm"
+  JSONFILE="${WORKDIR}/scaling-${PARAM}-${value}.json"
+
+  if ! ${QASMGEN} ${QASMGEN_ARGS} --${PARAM} ${value} -o ${QASMFILE} ; then
+    exit 1
+  fi
+
+  if ! ${QASMBENCH} -n ${ITERATIONS} -I${TESTINCDIR} -o ${JSONFILE} \
+       ${QASMFILE} > /dev/null ; then
+    echo "${value},error"
+    continue
+  fi
+
+  LINE="`grep '\"name\":' ${JSONFILE}`"
+  echo -n "${value}"
+  for key in lines tokens nodes parse_ms_median lines_per_sec allocs \
+             peak_rss_kb ; do
+    echo -n ",`field ${key} "${LINE}"`"
+  done
+  echo
+done
@@ -0,0 +1,26 @@
+OPENQASM 3.0;
+
+include "stdgates.inc";
+
+qubit[2] q;
+
+// Fixed-point words: a 0x7a, b 0xeba1 (wrapped from a negative
+// input), c 0x40000000 (a quarter turn), d 0x1e91adbf91314a,
+// e 0x1d34a60108f72509, f and pi 0x8000000000000000 (half a turn).
+// angle[128] has no fixed-point form.
+angle[8] a = 3.0;
+angle[16] b = -0.5;
+angle[32] c = 1.5707963267948966;
+angle[53] d = 100.25;
+angle[64] e = 7;
+angle[64] f = pi;
+angle[128] g = 0.125;
+
+rz(a) q[0];
+rz(b) q[1];
+rx(c) q[0];
+ry(d) q[1];
+rz(e) q[0];
+rz(f) q[1];
+rx(g) q[0];
+rz(pi) q[1];
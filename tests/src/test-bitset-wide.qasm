@@ -0,0 +1,17 @@
+OPENQASM 3.0;
+
+bit[2048] syndrome = "10100010000110001000010000110010001000011111110000111110010101100111110011001111101100100100111001110111110000000010110011100111110110000100100000100010111100111110001110001001011010100010011001110111100001010101100101011011100000010110000001000101011100111000100000100110000100100110111010101011100100100101010011000111101101011101110000011001011101101001010010001010111000001000110110110100001010111100100110000110001101010011011110010100110110000100101011000111010010000000101100011010001101000111011000011100101100111111001010110111000001101010111000111101111010111000111011011101001001110110100011011000111111110111000001011110000010101100111011101110001011111000111001110000001000000101100010110001111010001100011010110101111001001010010110100110010000100011100010010111110000101100111100101101110101010100100111101111000001111110100100111100100100110100100011100011001111111010000010101100010001011010000001011001001100010001110100011010100011111101111010110010100111000001010011000011010011010001010001011000000101111101111100011011011000111010000100100000011000110111011010110001011101001101111110110100011110000111100100000110101100110000010001110011100000010000000010101010101110100010001101111000010001011011100101010000000010000000001001000000001100001111101110111101010110001010010011010111010010001011011010101110101001101101110011001100011001010000100111100010110011011001100110000111101010111101010110010001010101111001010111100011110011011000001001111011011110101101111101011001010000110000110010010100100110011011010100011111111001000101100010101110111110111111110101011000110110000101000010000100101110101010100111001011001000100000001010100100111100000011101011110001011111111010011011101101111001001110110010110101101001111000000111100011011001011000010111010101001000011101001100101010000110001100010011011111011101000100000101010011101010100010101110001110110111000011010111000111001001101010110101000000001100001000101111001101001001011001011010110000000001100001010101000101110001000011001101011101111010101010001100001110";
+
+bit[130] b = "0011001001001011000101010011110011010111111001001101001111101000011011100011100101101001011011011111111110111101011001101010001111";
+
+// 996 and 75 bits are set. t00344 checks the popcounts, the printed
+// bits of b, and the rotated values.
+popcount(syndrome);
+
+popcount(b);
+
+rotl(syndrome, 517);
+
+rotr(b, 67);
+
+int r = rotl(b, 64);
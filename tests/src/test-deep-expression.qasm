@@ -0,0 +1,14 @@
+OPENQASM 3.0;
+
+include "stdgates.inc";
+
+qubit[2] q;
+
+float[64] x = 0.25;
+angle[64] theta = pi / 8;
+
+float[64] y = x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x + x;
+angle[64] phi = theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta + theta;
+
+rz(phi) q[0];
+rx(y) q[1];
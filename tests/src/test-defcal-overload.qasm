@@ -0,0 +1,46 @@
+OPENQASM 3.0;
+
+defcalgrammar "openpulse";
+
+qubit $0;
+qubit $1;
+qubit $2;
+qubit $3;
+
+// Same gate defined per physical qubit and per parameter pattern.
+defcal rx(theta) $0 { }
+defcal rx(theta) $1 { }
+defcal rx(theta) $2 { }
+defcal rx $0 { }
+defcal rx $1 { }
+
+defcal cr $0, $1 { }
+defcal cr $1, $2 { }
+defcal cr $2, $3 { }
+defcal cr $1, $0 { }
+
+// Same gate and qubit, overloaded on the parameter type.
+defcal ry(theta) $0 { }
+defcal ry(2) $0 { }
+defcal ry(0.5) $0 { }
+defcal ry(100ns) $0 { }
+
+angle[20] a = pi / 2;
+
+// Resolved by physical qubits and argument count.
+rx(a) $0;
+rx(a) $1;
+rx(a) $2;
+rx $0;
+rx $1;
+
+cr $0, $1;
+cr $1, $2;
+cr $2, $3;
+cr $1, $0;
+
+// Resolved by the types of the arguments.
+ry(a) $0;
+ry(3) $0;
+ry(0.25) $0;
+ry(20ns) $0;
@@ -0,0 +1,26 @@
+OPENQASM 3.0;
+
+include "stdgates.inc";
+
+qubit[4] q;
+
+duration d0 = 100dt;
+duration d1 = 222ns;
+duration d2 = 2us;
+duration d3 = 1ms;
+duration d4 = 0dt;
+duration d5 = 450dt;
+duration d6 = 100ns;
+duration d7 = 5us;
+duration d8 = 1s;
+
+delay[100dt] q[0];
+delay[222ns] q[1];
+delay[2us] q[2];
+delay[1ms] q[3];
+
+boxto 5us {
+  cx q[0], q[1];
+  delay[450dt] q[0];
+  delay[100ns] q[1];
+}
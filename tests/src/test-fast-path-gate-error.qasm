@@ -0,0 +1,12 @@
+OPENQASM 3.0;
+include "stdgates.inc";
+
+gate g(theta) a, b {
+  rx(theta) a;
+  cx a b;
+  h b;
+}
+
+qubit[2] q;
+
+g(pi / 2) q[0], q[1];
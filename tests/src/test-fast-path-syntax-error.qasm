@@ -0,0 +1,8 @@
+OPENQASM 3.0;
+include "stdgates.inc";
+
+qubit[2] q;
+
+h q[0];
+rx(pi / 2 q[1];
+cx q[0], q[1];
@@ -0,0 +1,35 @@
+OPENQASM 3.0;
+
+include "stdgates.inc";
+
+qubit[4] q;
+
+gate rot(theta) a {
+  rz(0.5) a;
+  rx(theta) a;
+  rz(0.5) a;
+}
+
+int[32] i = 1;
+int[32] j = 1;
+uint[32] k = 1u;
+float[64] f = 0.5;
+float[64] g = 0.5;
+bool b = true;
+bool c = true;
+angle[32] t = 0.5;
+
+rz(0.5) q[0];
+rz(0.5) q[1];
+rot(0.25) q[2];
+rot(0.25) q[3];
+rx(1) q[0];
+rx(1) q[1];
+
+if (b == true) {
+  rz(0.5) q[2];
+}
+
+for int n in [0:1:3] {
+  rx(0.5) q[n];
+}
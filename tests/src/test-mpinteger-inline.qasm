@@ -0,0 +1,23 @@
+OPENQASM 3.0;
+
+int[48] i = "-140737488355328";
+
+uint[48] u = "281474976710655";
+
+int[64] ib = "-0b0101010101010101010101010101010101010101010101010101";
+
+uint[64] ub = "0b1111111111111111111111111111111111111111111111111111111111111111";
+
+int[64] ix = "-0x7fffffffffffffff";
+
+uint[64] ux = "0xffffffffffffffff";
+
+int[56] io = "-0o1234567765432101234";
+
+uint[56] uo = "0o1234567765432101234";
+
+float[64] fa = 1.5;
+
+float[64] fb = -0.25;
+
+float[64] fz = 0.0;
@@ -0,0 +1,14 @@
+OPENQASM 3.0;
+
+cal {
+  waveform wf0 = [0.0 + 0.0 im, 0.125 + 0.25 im, 0.5 - 0.5 im, 1.0 + 0.0 im,
+                  0.5 + 0.5 im, 0.125 - 0.25 im, 0.0 + 0.0 im];
+
+  complex[float[64]] a = 0.75 + 0.25 im;
+
+  complex[float[128]] b = 0.75 + 0.25 im;
+
+  waveform wf1 = [a, a, a];
+
+  waveform wf2 = [a, b, 1.0 + 1.0 im];
+}
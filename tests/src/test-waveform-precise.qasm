@@ -0,0 +1,7 @@
+OPENQASM 3.0;
+
+cal {
+  // 0.1 is not exactly representable as double. The samples are not
+  // packed, and keep their multiple precision values.
+  waveform wf0 = [0.5 + 0.0 im, 0.1 + 0.0 im, 0.5 + 0.0 im];
+}
@@ -0,0 +1,21 @@
+OPENQASM 3.0;
+
+defcalgrammar "openpulse";
+
+extern constant(complex[float[128]] a, duration d) -> waveform;
+
+cal {
+  extern port d0;
+  frame d0f = newframe(d0, 5.0e9, 0.0);
+}
+
+defcal x $0 {
+  // Too long to synthesize: a warning, and no samples.
+  waveform c = constant(1.0, 1000000000dt);
+
+  play(c, d0f);
+}
+
+qubit $1;
+
+x $1;
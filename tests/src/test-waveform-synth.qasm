@@ -0,0 +1,24 @@
+OPENQASM 3.0;
+
+defcalgrammar "openpulse";
+
+extern gaussian(complex[float[128]] a, duration d, duration s) -> waveform;
+extern sech(complex[float[128]] a, duration d, duration s) -> waveform;
+
+cal {
+  extern port d0;
+  frame d0f = newframe(d0, 5.0e9, 0.0);
+}
+
+defcal x $0 {
+  // Run with -dt=2ns: 8ns and 2ns are 4dt and 1dt.
+  waveform g = gaussian(1.0, 4dt, 1dt);
+  waveform h = sech(1.0, 8ns, 2ns);
+
+  play(g, d0f);
+  play(h, d0f);
+}
+
+qubit $1;
+
+x $1;